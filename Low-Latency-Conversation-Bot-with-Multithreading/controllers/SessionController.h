@@ -7,11 +7,25 @@
 #include <mutex>
 #include <chrono>
 
+#include "transcript_ring.h"
+
 // Forward declarations for your actual wrapper classes
 class ClassificationCrew;
 class ExtractionCrew;
 class ComposerCrew;
 class CloserCrew;
+class AppointmentManager;
+class LLMInterface;
+struct SessionCrews;
+struct ExtractionResult;
+class MemoryReport;
+
+// How update_session decides which entities a turn carries
+enum class PipelineMode {
+    CLASSIFY_THEN_EXTRACT,  // SVM presence check, then NER on the detected entities
+    JOINT_NER               // Joint NER decides presence and extracts in one pass;
+                            // SVM only breaks ties inside the confidence band
+};
 
 // C++ equivalent of Python's ConfigModel
 struct ConfigModel {
@@ -82,52 +96,89 @@ struct EntitiesModel {
     EntitiesModel() : session_active(false) {}
 };
 
-// Simple EntityStateManager for sessions
-class EntityStateManager {
+// One conversation. entities/active are guarded by the SessionStateManager's
+// mutex; the transcript is only touched by the session's own turns, under
+// turn_mutex.
+struct SessionState {
+    ConfigModel entities;
+    bool active = true;
+    SessionTranscript transcript;
+    uint64_t prompt_key = 0;  // Keys this session's prompt prefix at the LLM backend
+    std::mutex turn_mutex;  // Serializes this session's turns
+};
+
+// Simple per-session state store (distinct from the composer's EntityStateManager)
+class SessionStateManager {
 private:
-    std::unordered_map<std::string, ConfigModel> sessions_;
-    std::unordered_map<std::string, bool> active_sessions_;
+    std::unordered_map<std::string, std::shared_ptr<SessionState>> sessions_;
     mutable std::mutex sessions_mutex_;
     
 public:
-    // Basic session management
-    void create_session(const std::string& session_id);
+    // Basic session management. Only create_session adds entries; the other
+    // calls ignore unknown IDs.
+    std::shared_ptr<SessionState> create_session(const std::string& session_id);  // Replaces an existing one
+    std::shared_ptr<SessionState> find_session(const std::string& session_id) const;  // nullptr if unknown
     ConfigModel get_session(const std::string& session_id) const;
     void update_session(const std::string& session_id, const ConfigModel& entities);
     bool is_session_active(const std::string& session_id) const;
     void set_session_active(const std::string& session_id, bool active);
     void end_session(const std::string& session_id);
-    // Removed get_session_count - not needed
+    size_t get_session_count() const;
+    
+    // Memory accounting: per-session entity records and transcripts
+    void report_memory(MemoryReport& report) const;
 };
 
 // Main SessionController class
 class SessionController {
 private:
-    // Your actual wrapper classes
-    std::unique_ptr<ClassificationCrew> classifier_;
-    std::unique_ptr<ExtractionCrew> extractor_;
-    std::unique_ptr<ComposerCrew> composer_;
-    std::unique_ptr<CloserCrew> closer_;
+    // Your actual wrapper classes, process-wide (see SessionCrews)
+    std::shared_ptr<SessionCrews> crews_;
+    ClassificationCrew* classifier_ = nullptr;
+    ExtractionCrew* extractor_ = nullptr;
+    ComposerCrew* composer_ = nullptr;
+    CloserCrew* closer_ = nullptr;
+    AppointmentManager* appointments_ = nullptr;
     
     // Simple state manager
-    std::unique_ptr<EntityStateManager> state_manager_;
+    std::unique_ptr<SessionStateManager> state_manager_;
     
-    // Threading
+    // Threading: turns of one session are serialized by its SessionState's
+    // turn_mutex, controller_mutex_ only guards the pipeline configuration
     size_t max_threads_;
     mutable std::mutex controller_mutex_;
     
+    // Turn pipeline
+    PipelineMode pipeline_mode_;
+    float joint_reject_below_;  // Joint spans under this are dropped (at least the extractor's NER threshold)
+    float joint_accept_above_;  // Joint spans at or over this are kept without SVM
+    
     // Helper methods
     std::vector<std::string> group_entities(const std::vector<std::string>& empty_entities) const;
     std::string generate_greeting() const;
     std::string generate_question_for_entities(const std::vector<std::string>& entities) const;
+    void record_entity_events(SessionTranscript* transcript, const ConfigModel& before, const ConfigModel& after) const;
+    
+    // The session's state with its turn_mutex held by `lock`; nullptr for IDs
+    // that are unknown, or were ended (or replaced) while waiting for the lock
+    std::shared_ptr<SessionState> lock_session(const std::string& session_id, std::unique_lock<std::mutex>& lock) const;
+    
+    // Turn pipelines over crew entity names; return the extractions to apply
+    std::vector<ExtractionResult> classify_then_extract(const std::string& user_input, const std::vector<std::string>& targets);
+    std::vector<ExtractionResult> joint_classify_extract(const std::string& user_input, const std::vector<std::string>& targets,
+                                                         float reject_below, float accept_above);
     
 public:
     // Constructor/Destructor
     SessionController();
-    ~SessionController() = default;
+    ~SessionController();  // Defined where the crew types are complete
     
-    // Initialize with actual model paths
-    bool initialize(const std::string& svm_models_dir, const std::string& ner_models_dir);
+    // Initialize with actual model paths; composer and closer share `llm`
+    // (templates only when null). Crews are loaded once per model directory
+    // pair and shared by every controller in the process, as is the
+    // appointment book, so `llm` only applies to the first controller.
+    bool initialize(const std::string& svm_models_dir, const std::string& ner_models_dir,
+                    std::shared_ptr<LLMInterface> llm = nullptr);
     
     // Main session methods
     EntitiesModel create_session(const std::string& session_id);
@@ -135,5 +186,15 @@ public:
     EntitiesModel get_session(const std::string& session_id) const;
     EntitiesModel end_session(const std::string& session_id);
     
-    // That's it - no extra utility methods needed
+    // Pipeline selection (JOINT_NER needs the joint NER model to pay off)
+    bool set_pipeline_mode(PipelineMode mode);
+    PipelineMode get_pipeline_mode() const;
+    // False when reject_below is under the extractor's NER confidence
+    // threshold: spans below that are never found, so the band could not act
+    bool set_joint_confidence_band(float reject_below, float accept_above);
+    
+    // Memory accounting hooks: this controller's sessions, and the shared
+    // crews and appointment book (counted once however many controllers use them)
+    void report_memory(MemoryReport& report) const;
+    static void report_shared_memory(MemoryReport& report);
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "extractor.h" 
 #include "composer.h"
 #include "closer.h"
+#include "busy_poll.h"
 #include <thread>
 #include <algorithm>
 #include <future>
@@ -10,62 +11,201 @@
 #include <sstream>
 #include <iostream>
 
-// EntityStateManager Implementation - Simple and clean
-void EntityStateManager::create_session(const std::string& session_id) {
+// SessionStateManager Implementation - Simple and clean
+std::shared_ptr<SessionState> SessionStateManager::create_session(const std::string& session_id) {
+    auto session = std::make_shared<SessionState>();  // Empty entities
+    session->prompt_key = PromptBuilder::newSessionKey(session_id);
     std::lock_guard<std::mutex> lock(sessions_mutex_);
-    sessions_[session_id] = ConfigModel();  // Empty entities
-    active_sessions_[session_id] = true;
+    sessions_[session_id] = session;
+    return session;
 }
 
-ConfigModel EntityStateManager::get_session(const std::string& session_id) const {
+std::shared_ptr<SessionState> SessionStateManager::find_session(const std::string& session_id) const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(session_id);
+    return it != sessions_.end() ? it->second : nullptr;
+}
+
+ConfigModel SessionStateManager::get_session(const std::string& session_id) const {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
     auto it = sessions_.find(session_id);
     if (it != sessions_.end()) {
-        return it->second;
+        return it->second->entities;
     }
     return ConfigModel();  // Return empty if not found
 }
 
-void EntityStateManager::update_session(const std::string& session_id, const ConfigModel& entities) {
+void SessionStateManager::update_session(const std::string& session_id, const ConfigModel& entities) {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
-    sessions_[session_id] = entities;
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second->entities = entities;
+    }
 }
 
-bool EntityStateManager::is_session_active(const std::string& session_id) const {
+bool SessionStateManager::is_session_active(const std::string& session_id) const {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
-    auto it = active_sessions_.find(session_id);
-    return it != active_sessions_.end() && it->second;
+    auto it = sessions_.find(session_id);
+    return it != sessions_.end() && it->second->active;
 }
 
-void EntityStateManager::set_session_active(const std::string& session_id, bool active) {
+void SessionStateManager::set_session_active(const std::string& session_id, bool active) {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
-    active_sessions_[session_id] = active;
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second->active = active;
+    }
 }
 
-void EntityStateManager::end_session(const std::string& session_id) {
+void SessionStateManager::end_session(const std::string& session_id) {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
     sessions_.erase(session_id);
-    active_sessions_.erase(session_id);
 }
 
-size_t EntityStateManager::get_session_count() const {
+size_t SessionStateManager::get_session_count() const {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
     return sessions_.size();
 }
-SessionController::SessionController() {
+
+static size_t heapBytes(const ConfigModel& entities) {
+    return heapBytes(entities.name) + heapBytes(entities.phone) + heapBytes(entities.email) +
+           heapBytes(entities.service) + heapBytes(entities.day) + heapBytes(entities.time) +
+           heapBytes(entities.stylist) + heapBytes(entities.notes);
+}
+
+void SessionStateManager::report_memory(MemoryReport& report) const {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    size_t entity_bytes = sessions_.bucket_count() * sizeof(void*);
+    for (const auto& [session_id, session] : sessions_) {
+        // Map node + make_shared block holding the state
+        entity_bytes += sizeof(std::string) + sizeof(std::shared_ptr<SessionState>) + 2 * sizeof(void*) +
+                        heapBytes(session_id) + 2 * sizeof(long) + heapBytes(session->entities);
+    }
+    report.add("sessions.entities", entity_bytes, sessions_.size());
+    report.add("sessions.transcripts", sessions_.size() * sizeof(SessionTranscript), sessions_.size());
+}
+
+// Session entity names <-> crew entity names ("" when the crews don't model it)
+static std::string to_crew_entity(const std::string& entity) {
+    if (entity == "name") return "caller_name";
+    if (entity == "phone") return "phone_number";
+    if (entity == "day") return "day_preference";
+    if (entity == "time") return "time_preference";
+    if (entity == "service") return "service_type";
+    return "";
+}
+
+static std::string from_crew_entity(const std::string& crew_entity) {
+    if (crew_entity == "caller_name") return "name";
+    if (crew_entity == "phone_number") return "phone";
+    if (crew_entity == "day_preference") return "day";
+    if (crew_entity == "time_preference") return "time";
+    if (crew_entity == "service_type") return "service";
+    return crew_entity;
+}
+
+// Entities an appointment needs before closing (the ones the crews extract)
+static const std::vector<std::string> kAppointmentEntities = {"name", "phone", "day", "time", "service"};
+
+static bool appointment_complete(const ConfigModel& entities) {
+    for (const auto& entity : kAppointmentEntities) {
+        if (entities.get_entity(entity).empty()) return false;
+    }
+    return true;
+}
+
+// Known values keyed by crew entity name, as the composer/closer expect them
+static std::unordered_map<std::string, std::string> known_crew_entities(const ConfigModel& entities) {
+    std::unordered_map<std::string, std::string> known;
+    for (const auto& entity : kAppointmentEntities) {
+        std::string value = entities.get_entity(entity);
+        if (!value.empty()) known[to_crew_entity(entity)] = value;
+    }
+    return known;
+}
+
+static bool contains(const std::vector<std::string>& values, const std::string& value) {
+    return std::find(values.begin(), values.end(), value) != values.end();
+}
+
+// Crews loaded for one pair of model directories. Kept for the life of the
+// process: loading is expensive, and the appointment book must outlive any
+// one session.
+struct SessionCrews {
+    std::unique_ptr<ClassificationCrew> classifier;
+    std::unique_ptr<ExtractionCrew> extractor;
+    std::unique_ptr<ComposerCrew> composer;
+    std::unique_ptr<CloserCrew> closer;
+    std::shared_ptr<AppointmentManager> appointments;  // One per process
+    
+    static std::shared_ptr<SessionCrews> acquire(const std::string& svm_models_dir,
+                                                 const std::string& ner_models_dir,
+                                                 std::shared_ptr<LLMInterface> llm,
+                                                 size_t composition_threads);
+    static std::vector<std::shared_ptr<SessionCrews>> loaded();
+};
+
+static std::mutex crew_registry_mutex;
+static std::unordered_map<std::string, std::shared_ptr<SessionCrews>> crew_registry;
+static std::shared_ptr<AppointmentManager> shared_appointments;  // Guarded by crew_registry_mutex
+
+std::shared_ptr<SessionCrews> SessionCrews::acquire(const std::string& svm_models_dir,
+                                                    const std::string& ner_models_dir,
+                                                    std::shared_ptr<LLMInterface> llm,
+                                                    size_t composition_threads) {
+    std::lock_guard<std::mutex> lock(crew_registry_mutex);
+    std::string key = svm_models_dir + '\n' + ner_models_dir;
+    
+    auto it = crew_registry.find(key);
+    if (it != crew_registry.end()) {
+        return it->second;
+    }
+    
+    // Throws on a bad model directory; nothing is registered then
+    auto crews = std::make_shared<SessionCrews>();
+    crews->classifier = std::make_unique<ClassificationCrew>(svm_models_dir, 0.5f);
+    crews->extractor = std::make_unique<ExtractionCrew>(ner_models_dir, 0.5f);
+    crews->composer = std::make_unique<ComposerCrew>(llm, composition_threads);
+    crews->closer = std::make_unique<CloserCrew>(llm);
+    if (!shared_appointments) {
+        shared_appointments = std::make_shared<AppointmentManager>();
+    }
+    crews->appointments = shared_appointments;
+    
+    crew_registry.emplace(std::move(key), crews);
+    return crews;
+}
+
+std::vector<std::shared_ptr<SessionCrews>> SessionCrews::loaded() {
+    std::lock_guard<std::mutex> lock(crew_registry_mutex);
+    std::vector<std::shared_ptr<SessionCrews>> crews;
+    for (const auto& entry : crew_registry) {
+        crews.push_back(entry.second);
+    }
+    return crews;
+}
+
+SessionController::SessionController() 
+    : pipeline_mode_(PipelineMode::CLASSIFY_THEN_EXTRACT),
+      joint_reject_below_(0.5f), joint_accept_above_(0.85f) {  // Lower bound = the crews' NER threshold
     // Simple thread management
     size_t cores = std::thread::hardware_concurrency();
     max_threads_ = cores > 4 ? cores / 2 : 2;
-    state_manager_ = std::make_unique<EntityStateManager>();
+    state_manager_ = std::make_unique<SessionStateManager>();
 }
 
-bool SessionController::initialize(const std::string& svm_models_dir, const std::string& ner_models_dir) {
+SessionController::~SessionController() = default;
+
+bool SessionController::initialize(const std::string& svm_models_dir, const std::string& ner_models_dir,
+                                   std::shared_ptr<LLMInterface> llm) {
     try {
-        // Initialize using your actual constructors from the header files
-        classifier_ = std::make_unique<ClassificationCrew>(svm_models_dir, 0.5f);
-        extractor_ = std::make_unique<ExtractionCrew>(ner_models_dir, 0.5f);
-        composer_ = std::make_unique<ComposerCrew>(nullptr, max_threads_);  // Null LLM for now
-        closer_ = std::make_unique<CloserCrew>(nullptr);  // Null LLM for now
+        // Loaded by the first controller for these directories, shared after that
+        crews_ = SessionCrews::acquire(svm_models_dir, ner_models_dir, std::move(llm), max_threads_);
+        classifier_ = crews_->classifier.get();
+        extractor_ = crews_->extractor.get();
+        composer_ = crews_->composer.get();
+        closer_ = crews_->closer.get();
+        appointments_ = crews_->appointments.get();
         
         std::cout << "SessionController initialized successfully" << std::endl;
         return true;
@@ -104,12 +244,36 @@ std::string SessionController::generate_greeting() const {
     };
     
     static std::random_device rd;
-    static std::mt19937 gen(rd());
+    thread_local std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(0, greetings.size() - 1);
     
     return greetings[dis(gen)];
 }
 
+std::shared_ptr<SessionState> SessionController::lock_session(const std::string& session_id,
+                                                              std::unique_lock<std::mutex>& lock) const {
+    auto session = state_manager_->find_session(session_id);
+    if (!session) return nullptr;
+    
+    lock = std::unique_lock<std::mutex>(session->turn_mutex);
+    if (state_manager_->find_session(session_id) != session) {
+        lock.unlock();  // Ended while this call waited behind its last turn
+        return nullptr;
+    }
+    return session;
+}
+
+void SessionController::record_entity_events(SessionTranscript* transcript, const ConfigModel& before, 
+                                             const ConfigModel& after) const {
+    if (!transcript) return;
+    for (const auto& entity : kAppointmentEntities) {
+        const std::string value = after.get_entity(entity);
+        if (!value.empty() && value != before.get_entity(entity)) {
+            transcript->appendEntity(entity, value);
+        }
+    }
+}
+
 std::string SessionController::generate_question_for_entities(const std::vector<std::string>& entities) const {
     if (entities.empty()) {
         return "How can I help you today?";
@@ -131,13 +295,11 @@ std::string SessionController::generate_question_for_entities(const std::vector<
 }
 
 EntitiesModel SessionController::create_session(const std::string& session_id) {
-    std::lock_guard<std::mutex> lock(controller_mutex_);
-    
     EntitiesModel result;
     
     try {
-        state_manager_->create_session(session_id);
-        state_manager_->set_session_active(session_id, true);
+        auto session = state_manager_->create_session(session_id);
+        std::lock_guard<std::mutex> lock(session->turn_mutex);
         
         ConfigModel entities; // Empty by default
         auto empty_entities = entities.get_empty_entities();
@@ -148,7 +310,7 @@ EntitiesModel SessionController::create_session(const std::string& session_id) {
         result.session_active = true;
         result.entities = entities;
         
-        state_manager_->update_session(session_id, entities);
+        session->transcript.appendReply(result.question);
         
     } catch (const std::exception& e) {
         result.response = "Error creating session.";
@@ -160,12 +322,11 @@ EntitiesModel SessionController::create_session(const std::string& session_id) {
 }
 
 EntitiesModel SessionController::get_session(const std::string& session_id) const {
-    std::lock_guard<std::mutex> lock(controller_mutex_);
-    
     EntitiesModel result;
     
     try {
-        bool is_active = state_manager_->is_session_active(session_id);
+        std::unique_lock<std::mutex> lock;
+        bool is_active = lock_session(session_id, lock) && state_manager_->is_session_active(session_id);
         
         if (!is_active) {
             result.response = "Session not active";
@@ -196,11 +357,13 @@ EntitiesModel SessionController::get_session(const std::string& session_id) cons
 }
 
 EntitiesModel SessionController::end_session(const std::string& session_id) {
-    std::lock_guard<std::mutex> lock(controller_mutex_);
-    
     EntitiesModel result;
     
     try {
+        // Waits for a running turn; turns queued behind it then find the session gone
+        std::unique_lock<std::mutex> lock;
+        lock_session(session_id, lock);
+        
         ConfigModel final_entities = state_manager_->get_session(session_id);
         bool was_active = state_manager_->is_session_active(session_id);
         
@@ -225,10 +388,20 @@ EntitiesModel SessionController::end_session(const std::string& session_id) {
 }
 
 EntitiesModel SessionController::update_session(const std::string& session_id, const std::string& user_input) {
-    std::lock_guard<std::mutex> lock(controller_mutex_);
-    
     EntitiesModel result;
     
+    // Only turns of the same session are serialized; other sessions run concurrently
+    std::unique_lock<std::mutex> lock;
+    auto session = lock_session(session_id, lock);
+    if (!session) {
+        result.response = "Session not active.";
+        result.session_active = false;
+        return result;
+    }
+    
+    // Carries its own context snapshot, so an unused one is left to finish on the pool
+    std::future<CompositionResult> composition;
+    
     try {
         if (!state_manager_->is_session_active(session_id)) {
             result.response = "Session not active.";
@@ -236,63 +409,174 @@ EntitiesModel SessionController::update_session(const std::string& session_id, c
             return result;
         }
         
+        PipelineMode mode;
+        float reject_below, accept_above;
+        {
+            std::lock_guard<std::mutex> config_lock(controller_mutex_);
+            mode = pipeline_mode_;
+            reject_below = joint_reject_below_;
+            accept_above = joint_accept_above_;
+        }
+        
         ConfigModel current_entities = state_manager_->get_session(session_id);
-        auto missing_entities = current_entities.get_empty_entities();
+        const ConfigModel previous_entities = current_entities;
+        bool was_complete = appointment_complete(current_entities);
         
-        // Use ONLY the methods that exist in your actual classes
+        // Composer and closer context: the session's transcript, copied once
+        // per turn so requests stay valid whatever the ring records next. Lines from before this
+        // turn are the session's prompt prefix; only this turn's are new.
+        SessionTranscript* transcript = &session->transcript;
+        uint64_t turn_start = transcript->linesAppended();
+        transcript->appendTurn(user_input);
+        TranscriptSnapshot context = snapshotOf(transcript->all());
+        size_t history_length = context->size() - transcript->since(turn_start).size();
+        auto composition_request = [&](const std::vector<std::string>& ask) {
+            CompositionRequest request(ask, known_crew_entities(current_entities), context);
+            request.session_key = session->prompt_key;
+            request.history_length = history_length;
+            return request;
+        };
         
-        // Classification using your actual method
-        auto detected_entities = classifier_->getDetectedEntities(user_input);
+        // Only entities the crews can detect/extract
+        std::vector<std::string> targets;
+        for (const auto& entity : current_entities.get_empty_entities()) {
+            std::string crew_entity = to_crew_entity(entity);
+            if (!crew_entity.empty()) {
+                targets.push_back(crew_entity);
+            }
+        }
         
-        // Find entities to extract
-        std::vector<std::string> entities_to_extract;
-        for (const auto& entity : missing_entities) {
-            // Convert to your C++ entity names
-            std::string cpp_entity = entity;
-            if (entity == "name") cpp_entity = "caller_name";
-            else if (entity == "phone") cpp_entity = "phone_number";
-            else if (entity == "day") cpp_entity = "day_preference";
-            else if (entity == "time") cpp_entity = "time_preference";
-            else if (entity == "service") cpp_entity = "service_type";
-            
-            if (std::find(detected_entities.begin(), detected_entities.end(), cpp_entity) != detected_entities.end()) {
-                entities_to_extract.push_back(cpp_entity);
+        // PHASE 1: which missing entities this turn can fill at all. Joint mode
+        // lets the lexical pre-filter answer (the joint pass decides presence),
+        // otherwise the SVM heads do.
+        std::vector<std::string> possible;
+        std::vector<std::string> unfilled;
+        if (!targets.empty()) {
+            auto present = (mode == PipelineMode::JOINT_NER) 
+                ? classifier_->getCandidateEntities(user_input)
+                : classifier_->getDetectedEntities(user_input);
+            for (const auto& entity : targets) {
+                (contains(present, entity) ? possible : unfilled).push_back(entity);
             }
         }
         
-        // Extraction using your actual method
-        if (!entities_to_extract.empty()) {
-            auto extraction_results = extractor_->extractEntities(user_input, entities_to_extract);
+        // PHASE 2: extraction || composition. Entities this turn cannot fill
+        // stay missing whatever extraction returns, so the next question for
+        // them is composed on the composer pool while extraction runs.
+        if (!unfilled.empty()) {
+            std::vector<std::string> unfilled_names;
+            for (const auto& entity : unfilled) unfilled_names.push_back(from_crew_entity(entity));
+            
+            std::vector<std::string> ask;
+            for (const auto& entity : group_entities(unfilled_names)) ask.push_back(to_crew_entity(entity));
+            
+            composition = composer_->composeQuestionAsync(composition_request(ask));
+        }
+        
+        if (!possible.empty()) {
+            auto extraction_results = (mode == PipelineMode::JOINT_NER)
+                ? joint_classify_extract(user_input, possible, reject_below, accept_above)
+                : extractor_->extractEntities(user_input, possible);
             
             // Update entities with results
             for (const auto& ext_result : extraction_results) {
                 if (ext_result.found && !ext_result.extracted_value.empty()) {
-                    // Convert back to simple names
-                    std::string entity_name = ext_result.entity_name;
-                    if (entity_name == "caller_name") entity_name = "name";
-                    else if (entity_name == "phone_number") entity_name = "phone";
-                    else if (entity_name == "day_preference") entity_name = "day";
-                    else if (entity_name == "time_preference") entity_name = "time";
-                    else if (entity_name == "service_type") entity_name = "service";
-                    
-                    current_entities.set_entity(entity_name, ext_result.extracted_value);
+                    current_entities.set_entity(from_crew_entity(ext_result.entity_name), ext_result.extracted_value);
                 }
             }
         }
         
-        // Check if complete
-        auto remaining_missing = current_entities.get_empty_entities();
+        state_manager_->update_session(session_id, current_entities);
         
-        if (remaining_missing.empty()) {
+        // PHASE 3: close as soon as the appointment entities are complete
+        // (a pending composition is simply not used)
+        if (appointment_complete(current_entities)) {
             result.response = "Perfect! I have all your information.";
             result.question = "Your appointment is ready!";
+            
+            if (!was_complete) {
+                auto closing_entities = known_crew_entities(current_entities);
+                if (!current_entities.stylist.empty()) closing_entities["stylist"] = current_entities.stylist;
+
+                // Same snapshot as the turn's compositions: no second copy of the ring
+                ClosingRequest close_request(closing_entities, context, "Hair salon appointment");
+                close_request.session_key = session->prompt_key;
+                close_request.history_length = history_length;
+
+                // Book first: a taken slot is offered alternatives instead of a closing
+                if (appointments_->storeAppointment(closer_->createAppointmentSummary(close_request))) {
+                    ClosingResult closing = closer_->generateClosing(close_request);
+                    if (closing.is_valid && !closing.closing_message.empty()) {
+                        result.response = closing.closing_message;
+                    }
+                    if (!closing.confirmation_details.empty()) {
+                        result.question = closing.confirmation_details;
+                    }
+                } else {
+                    auto alternatives = appointments_->getSuggestedAlternatives(
+                        current_entities.day, current_entities.time, current_entities.service, current_entities.stylist);
+
+                    result.response = "Sorry, " + current_entities.day + " at " + current_entities.time + " is already booked.";
+                    if (alternatives.empty()) {
+                        result.question = "What other day and time would work for you?";
+                    } else {
+                        result.question = "Would ";
+                        for (size_t i = 0; i < alternatives.size(); i++) {
+                            if (i > 0) result.question += (i + 1 == alternatives.size()) ? " or " : ", ";
+                            result.question += alternatives[i];
+                        }
+                        result.question += " work instead?";
+                    }
+
+                    // Ask for the time again; the next complete turn books anew
+                    current_entities.time.clear();
+                    state_manager_->update_session(session_id, current_entities);
+                }
+
+                // Recorded after booking, so a time that was just refused never
+                // reaches the transcript or the prompt prefix as collected
+                record_entity_events(transcript, previous_entities, current_entities);
+            }
         } else {
             result.response = "Thank you for that information.";
-            auto next_entities = group_entities(remaining_missing);
-            result.question = generate_question_for_entities(next_entities);
+            
+            // Use the overlapped question if everything it asks about is still missing
+            std::vector<std::string> still_missing;
+            for (const auto& entity : kAppointmentEntities) {
+                if (current_entities.get_entity(entity).empty()) still_missing.push_back(to_crew_entity(entity));
+            }
+            
+            CompositionResult composed;
+            if (composition.valid()) {
+                composed = BusyPoll::get(composition);
+                for (const auto& entity : composed.targeted_entities) {
+                    if (!contains(still_missing, entity)) {
+                        composed.is_valid = false;
+                        break;
+                    }
+                }
+            }
+            
+            if (!composed.is_valid || composed.generated_question.empty()) {
+                // Detected entities the extractor missed: compose for them now
+                std::vector<std::string> still_missing_names;
+                for (const auto& entity : still_missing) still_missing_names.push_back(from_crew_entity(entity));
+                
+                std::vector<std::string> ask;
+                for (const auto& entity : group_entities(still_missing_names)) ask.push_back(to_crew_entity(entity));
+                composed = composer_->composeQuestion(composition_request(ask));
+            }
+            
+            result.question = composed.generated_question.empty()
+                ? generate_question_for_entities(group_entities(current_entities.get_empty_entities()))
+                : composed.generated_question;
+            
+            record_entity_events(transcript, previous_entities, current_entities);
         }
         
-        state_manager_->update_session(session_id, current_entities);
+        if (transcript) {
+            transcript->appendReply(result.question);
+        }
         
         result.entities = current_entities;
         result.session_active = true;
@@ -305,3 +589,122 @@ EntitiesModel SessionController::update_session(const std::string& session_id, c
     
     return result;
 }
+
+std::vector<ExtractionResult> SessionController::classify_then_extract(const std::string& user_input, 
+                                                                       const std::vector<std::string>& targets) {
+    // Classification first, extraction only for detected entities
+    auto detected_entities = classifier_->getDetectedEntities(user_input);
+    
+    std::vector<std::string> entities_to_extract;
+    for (const auto& entity : targets) {
+        if (std::find(detected_entities.begin(), detected_entities.end(), entity) != detected_entities.end()) {
+            entities_to_extract.push_back(entity);
+        }
+    }
+    
+    if (entities_to_extract.empty()) {
+        return {};
+    }
+    return extractor_->extractEntities(user_input, entities_to_extract);
+}
+
+std::vector<ExtractionResult> SessionController::joint_classify_extract(const std::string& user_input, 
+                                                                        const std::vector<std::string>& targets,
+                                                                        float reject_below, float accept_above) {
+    // Entities outside the joint label set keep the classify-then-extract path
+    std::vector<std::string> joint_targets;
+    std::vector<std::string> classic_targets;
+    for (const auto& entity : targets) {
+        if (extractor_->usesJointModel(entity)) {
+            joint_targets.push_back(entity);
+        } else {
+            classic_targets.push_back(entity);
+        }
+    }
+    
+    auto classic_future = std::async(std::launch::async, [this, &user_input, &classic_targets]() {
+        return classic_targets.empty() ? std::vector<ExtractionResult>() 
+                                       : classify_then_extract(user_input, classic_targets);
+    });
+    
+    // One joint pass decides presence and extracts
+    std::vector<ExtractionResult> results;
+    if (!joint_targets.empty()) {
+        results = extractor_->extractEntities(user_input, joint_targets);
+    }
+    
+    // Spans inside the confidence band go to their SVM head as a tie-breaker
+    std::vector<std::pair<size_t, std::future<ClassificationResult>>> tie_breaks;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].found || results[i].ner_confidence >= accept_above) {
+            continue;
+        }
+        if (results[i].ner_confidence < reject_below) {
+            results[i].found = false;
+            continue;
+        }
+        tie_breaks.emplace_back(i, classifier_->classifyEntityAsync(user_input, results[i].entity_name));
+    }
+    
+    for (auto& tie_break : tie_breaks) {
+        if (!BusyPoll::get(tie_break.second).detected) {
+            results[tie_break.first].found = false;
+        }
+    }
+    
+    if (!tie_breaks.empty()) {
+        std::cout << "⚖️ SVM tie-break for " << tie_breaks.size() << " of " << joint_targets.size() 
+                  << " joint entities" << std::endl;
+    }
+    
+    auto classic_results = BusyPoll::get(classic_future);
+    results.insert(results.end(), classic_results.begin(), classic_results.end());
+    return results;
+}
+
+bool SessionController::set_pipeline_mode(PipelineMode mode) {
+    std::lock_guard<std::mutex> lock(controller_mutex_);
+    
+    if (mode == PipelineMode::JOINT_NER && (!extractor_ || !extractor_->hasJointModel())) {
+        std::cerr << "⚠️ No joint NER model loaded, keeping classify-then-extract pipeline" << std::endl;
+        return false;
+    }
+    
+    pipeline_mode_ = mode;
+    return true;
+}
+
+PipelineMode SessionController::get_pipeline_mode() const {
+    std::lock_guard<std::mutex> lock(controller_mutex_);
+    return pipeline_mode_;
+}
+
+bool SessionController::set_joint_confidence_band(float reject_below, float accept_above) {
+    if (reject_below < 0.0f || accept_above > 1.0f || reject_below > accept_above) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(controller_mutex_);
+    if (extractor_ && reject_below < extractor_->getNERConfidenceThreshold()) {
+        std::cerr << "⚠️ Joint reject bound " << reject_below << " is under the NER confidence threshold "
+                  << extractor_->getNERConfidenceThreshold() << ", keeping the current band" << std::endl;
+        return false;
+    }
+    joint_reject_below_ = reject_below;
+    joint_accept_above_ = accept_above;
+    return true;
+}
+
+void SessionController::report_shared_memory(MemoryReport& report) {
+    auto crews = SessionCrews::loaded();
+    for (const auto& crew : crews) {
+        crew->classifier->reportMemory(report);
+        crew->extractor->reportMemory(report);
+        crew->composer->reportMemory(report);
+    }
+    if (!crews.empty()) crews.front()->appointments->reportMemory(report);
+}
+
+void SessionController::report_memory(MemoryReport& report) const {
+    state_manager_->report_memory(report);
+}
@@ -2,6 +2,10 @@
 #include "extractor.h" 
 #include "composer.h"
 #include "closer.h"
+#include "http_llm_client.h"
+#include "transcript_ring.h"
+#include "turn_coroutines.h"
+#include "session_registry.h"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -14,6 +18,9 @@
 #include <sstream>
 #include <memory>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdlib>
 
 using namespace std;
 
@@ -63,17 +70,78 @@ struct ProcessingResult {
     PerformanceMetrics metrics;
 };
 
-// Advanced Session Controller with intelligent multithreading
-class AdvancedSessionController {
-private:
-    // Core crews
+// Crews, worker pools and models, loaded once per pair of model directories
+// and shared by every controller and every conversation that uses them
+struct SharedCrews {
     std::unique_ptr<ClassificationCrew> classifier;
     std::unique_ptr<ExtractionCrew> extractor;
     std::unique_ptr<ComposerCrew> composer;
     std::unique_ptr<CloserCrew> closer;
-    std::unique_ptr<EntityStateManager> entity_manager;
     std::unique_ptr<AppointmentManager> appointment_manager;
     
+    // Existing crews for these directories, or new ones. Thresholds and the
+    // LLM interface only apply when the crews are first built; composer and
+    // closer share the one LLM interface (and its connection pool).
+    static std::shared_ptr<SharedCrews> acquire(const std::string& svm_models_dir,
+                                                const std::string& ner_models_dir,
+                                                std::shared_ptr<LLMInterface> llm_interface,
+                                                float classification_threshold,
+                                                float extraction_threshold,
+                                                int composition_threads) {
+        static std::mutex registry_mutex;
+        static std::unordered_map<std::string, std::weak_ptr<SharedCrews>> registry;
+        
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        std::string key = svm_models_dir + '\n' + ner_models_dir;
+        
+        if (auto existing = registry[key].lock()) {
+            std::cout << "♻️ Reusing loaded crews for " << svm_models_dir << " + " << ner_models_dir << std::endl;
+            return existing;
+        }
+        
+        auto crews = std::make_shared<SharedCrews>();
+        crews->appointment_manager = std::make_unique<AppointmentManager>();
+        crews->classifier = std::make_unique<ClassificationCrew>(svm_models_dir, classification_threshold);
+        crews->extractor = std::make_unique<ExtractionCrew>(ner_models_dir, extraction_threshold);
+        crews->composer = std::make_unique<ComposerCrew>(llm_interface, composition_threads);
+        crews->closer = std::make_unique<CloserCrew>(llm_interface);
+        
+        registry[key] = crews;
+        return crews;
+    }
+};
+
+// State of one conversation
+struct ConversationState {
+    EntityStateManager entities;
+    SessionTranscript transcript;  // Recent turns + entity events, guarded by turn_lock
+    uint64_t prompt_key;  // Keys this conversation's prompt prefix at the LLM backend
+    bool booked = false;  // Appointment stored; later turns do not close again (guarded by turn_lock)
+    TurnLock turn_lock;  // One turn at a time per conversation
+    std::atomic<int> turns{0};
+    std::atomic<std::chrono::steady_clock::rep> last_active{0};
+    
+    ConversationState(TurnExecutor& executor, const std::string& session_id)
+        : prompt_key(PromptBuilder::newSessionKey(session_id)), turn_lock(executor) {}
+};
+
+// Advanced Session Controller with intelligent multithreading
+class AdvancedSessionController {
+private:
+    // Core crews (shared, see SharedCrews)
+    std::shared_ptr<SharedCrews> crews;
+    ClassificationCrew* classifier;
+    ExtractionCrew* extractor;
+    ComposerCrew* composer;
+    CloserCrew* closer;
+    AppointmentManager* appointment_manager;
+    
+    // Conversations keyed by session id
+    SessionRegistry<ConversationState> sessions;
+    
+    // Shared executor the turn coroutines run on
+    TurnExecutor& executor;
+    
     // Threading configuration
     int total_cpu_cores;
     int classification_threads;
@@ -88,9 +156,10 @@ private:
 public:
     AdvancedSessionController(const std::string& svm_models_dir, 
                              const std::string& ner_models_dir,
-                             std::unique_ptr<LLMInterface> llm_interface,
+                             std::shared_ptr<LLMInterface> llm_interface,
                              float classification_threshold = 0.7f,
-                             float extraction_threshold = 0.5f) {
+                             float extraction_threshold = 0.5f)
+        : executor(TurnExecutor::shared()) {
         
         std::cout << "🚀 Initializing Advanced Session Controller..." << std::endl;
         
@@ -98,43 +167,121 @@ public:
         total_cpu_cores = std::thread::hardware_concurrency();
         optimizeThreadAllocation();
         
-        // Initialize entity and appointment managers
-        entity_manager = std::make_unique<EntityStateManager>();
-        appointment_manager = std::make_unique<AppointmentManager>();
-        
-        // Initialize crews with optimized thread counts
-        classifier = std::make_unique<ClassificationCrew>(svm_models_dir, classification_threshold);
-        extractor = std::make_unique<ExtractionCrew>(ner_models_dir, extraction_threshold);
-        
-        // Create a copy of the LLM interface for composer (you may need to implement cloning)
-        composer = std::make_unique<ComposerCrew>(std::move(llm_interface), composition_threads);
-        
-        // For closer, you'll need to create another LLM interface instance
-        // closer = std::make_unique<CloserCrew>(std::make_unique<ConcreteLLMInterface>());
+        // Initialize crews with optimized thread counts (or reuse loaded ones)
+        crews = SharedCrews::acquire(svm_models_dir, ner_models_dir, std::move(llm_interface),
+                                     classification_threshold, extraction_threshold, composition_threads);
+        classifier = crews->classifier.get();
+        extractor = crews->extractor.get();
+        composer = crews->composer.get();
+        closer = crews->closer.get();
+        appointment_manager = crews->appointment_manager.get();
         
         std::cout << "✅ Advanced Session Controller ready!" << std::endl;
         printSystemConfiguration();
     }
     
-    // Main processing pipeline with intelligent multithreading
-    std::future<ProcessingResult> processInputAsync(const std::string& input_sentence) {
-        return std::async(std::launch::async, [this, input_sentence]() {
-            return processInput(input_sentence);
+    // Main processing pipeline: one coroutine per turn on the shared executor.
+    // Safe to call concurrently for any number of sessions; turns of the same
+    // session run in call order. Must not be called from an executor thread
+    // (processInput blocks on the result).
+    std::future<ProcessingResult> processInputAsync(const std::string& session_id, const std::string& input_sentence) {
+        auto session = sessions.getOrCreate(session_id, [this, &session_id]() {
+            return std::make_shared<ConversationState>(executor, session_id);
         });
+        return runTurn(session_id, std::move(session), input_sentence).result;
+    }
+    
+    ProcessingResult processInput(const std::string& session_id, const std::string& input_sentence) {
+        auto result = processInputAsync(session_id, input_sentence);
+        return BusyPoll::get(result);
+    }
+    
+    // Session lifecycle
+    bool endSession(const std::string& session_id) {
+        return sessions.erase(session_id);
+    }
+    
+    size_t evictIdleSessions(std::chrono::seconds max_idle) {
+        auto cutoff = (std::chrono::steady_clock::now() - max_idle).time_since_epoch().count();
+        return sessions.eraseIf([cutoff](const std::string&, const ConversationState& state) {
+            return state.last_active.load() < cutoff;
+        });
+    }
+    
+    size_t getActiveSessionCount() const { return sessions.size(); }
+    
+    std::unordered_map<std::string, std::string> getSessionEntities(const std::string& session_id) const {
+        auto session = sessions.find(session_id);
+        return session ? session->entities.getKnownEntities() : std::unordered_map<std::string, std::string>();
     }
     
-    ProcessingResult processInput(const std::string& input_sentence) {
+    float getSessionCompletion(const std::string& session_id) const {
+        auto session = sessions.find(session_id);
+        return session ? session->entities.getCompletionPercentage() : 0.0f;
+    }
+    
+private:
+    // classify -> (extract || compose) -> close
+    // Every stage is co_awaited, so no thread is parked while a turn waits, and
+    // per-stage timings are written only by this coroutine (no shared writes).
+    TurnTask<ProcessingResult> runTurn(std::string session_id, std::shared_ptr<ConversationState> session, 
+                                       std::string input_sentence) {
+        // Later turns of this conversation wait here without holding a thread
+        auto turn_guard = co_await session->turn_lock.lock();
+        co_await executor.schedule();
+        
+        EntityStateManager* entity_manager = &session->entities;
+        SessionTranscript& transcript = session->transcript;
+        session->turns++;
+        session->last_active = std::chrono::steady_clock::now().time_since_epoch().count();
+        bool was_complete = entity_manager->isComplete();
+        
         auto start_time = std::chrono::high_resolution_clock::now();
         active_processing_tasks++;
         
-        std::cout << "\n🎯 Processing: \"" << input_sentence << "\"" << std::endl;
-        std::cout << "🔧 Using " << total_cpu_cores << " CPU cores with optimized threading" << std::endl;
+        std::cout << "\n🎯 Processing [" << session_id << "]: \"" << input_sentence << "\"" << std::endl;
+        std::cout << "🔧 Using " << executor.getThreadCount() << " executor threads on " << total_cpu_cores << " CPU cores" << std::endl;
         
         ProcessingResult result;
         
-        // PHASE 1: CLASSIFICATION (Always first)
+        // Composer and closer context is copied out of the ring once per turn,
+        // so those stages own it whatever the ring records next. Lines from before this turn
+        // are the conversation's prompt prefix; only this turn's are new.
+        uint64_t turn_start = transcript.linesAppended();
+        transcript.appendTurn(input_sentence);
+        TranscriptSnapshot context = snapshotOf(transcript.all());
+        size_t history_length = context->size() - transcript.since(turn_start).size();
+        
+        // PHASE 1: CLASSIFICATION (Always first, one stage per SVM head)
         auto class_start = std::chrono::high_resolution_clock::now();
-        auto classification_results = classifier->classifyAllEntities(input_sentence);
+        std::vector<ClassificationResult> classification_results;
+        
+        if (!classifier->getCachedResults(input_sentence, classification_results)) {
+            // Only heads that survive the lexical pre-filter get a stage
+            std::vector<std::string> candidates = classifier->getCandidateEntities(input_sentence);
+            std::vector<StageFuture<ClassificationResult>> class_stages;
+            for (const auto& entity : candidates) {
+                class_stages.push_back(spawnStage(executor, [this, input_sentence, entity]() {
+                    return classifier->classifyEntity(input_sentence, entity);
+                }));
+            }
+            
+            size_t next_stage = 0;
+            for (const auto& entity : classifier->getEntityTypes()) {
+                if (next_stage < candidates.size() && candidates[next_stage] == entity) {
+                    classification_results.push_back(co_await class_stages[next_stage]);
+                    next_stage++;
+                } else {
+                    ClassificationResult skipped(entity);
+                    skipped.prefiltered = true;
+                    classification_results.push_back(skipped);
+                }
+            }
+            std::cout << "🔎 Pre-filter: " << candidates.size() << "/" << classifier->getEntityTypes().size()
+                      << " SVM heads invoked" << std::endl;
+            classifier->cacheResults(input_sentence, classification_results);
+        }
+        
         auto class_end = std::chrono::high_resolution_clock::now();
         result.metrics.classification_time = std::chrono::duration_cast<std::chrono::milliseconds>(class_end - class_start);
         
@@ -154,109 +301,194 @@ public:
         for (const auto& entity : detected_entities) std::cout << entity << " ";
         std::cout << std::endl;
         
-        // PHASE 2: PARALLEL EXTRACTION + COMPOSITION
-        std::vector<std::future<void>> parallel_tasks;
-        
-        // Task 1: Extract detected entities (if any)
+        // PHASE 2: PARALLEL EXTRACTION + COMPOSITION (all stages started before any is awaited)
+        auto extract_start = std::chrono::high_resolution_clock::now();
         std::vector<ExtractionResult> extraction_results;
-        std::future<std::vector<ExtractionResult>> extraction_future;
-        
-        if (!detected_entities.empty()) {
-            auto extract_start = std::chrono::high_resolution_clock::now();
-            extraction_future = std::async(std::launch::async, [this, input_sentence, detected_entities, &result, extract_start]() {
-                auto results = extractor->extractWithFallback(input_sentence, detected_entities);
-                auto extract_end = std::chrono::high_resolution_clock::now();
-                result.metrics.extraction_time = std::chrono::duration_cast<std::chrono::milliseconds>(extract_end - extract_start);
-                return results;
+        std::vector<std::pair<size_t, StageFuture<ExtractionResult>>> extract_stages;
+        
+        std::vector<std::string> joint_entities;
+        
+        for (const auto& entity : detected_entities) {
+            extraction_results.emplace_back(entity);
+            if (extractor->getCachedResult(input_sentence, entity, extraction_results.back())) {
+                continue;
+            }
+            
+            // The joint model fills all of these in a single stage below
+            if (extractor->getExtractionMode() == ExtractionMode::JOINT) {
+                joint_entities.push_back(entity);
+                continue;
+            }
+            
+            extract_stages.emplace_back(extraction_results.size() - 1, spawnStage(executor, [this, input_sentence, entity]() {
+                auto extracted = extractor->extractEntity(input_sentence, entity);
+                extractor->cacheResult(input_sentence, extracted);
+                
+                // LLM fallback for entities the NER model missed
+                if (!extracted.found) {
+                    auto llm_result = extractor->llmFallback(input_sentence, entity);
+                    if (llm_result.found) return llm_result;
+                }
+                return extracted;
+            }));
+        }
+        
+        std::optional<StageFuture<std::vector<ExtractionResult>>> joint_stage;
+        if (!joint_entities.empty()) {
+            joint_stage = spawnStage(executor, [this, input_sentence, joint_entities]() {
+                // One forward pass for every entity the joint model covers
+                auto extracted = extractor->extractEntities(input_sentence, joint_entities);
+                for (auto& entity_result : extracted) {
+                    if (!entity_result.found) {
+                        auto llm_result = extractor->llmFallback(input_sentence, entity_result.entity_name);
+                        if (llm_result.found) entity_result = llm_result;
+                    }
+                }
+                return extracted;
             });
         }
         
-        // Task 2: Compose questions for missing entities (if any and if needed)
-        std::future<CompositionResult> composition_future;
+        // Composition runs on the composer's own worker pool and resumes us when done
+        std::optional<StageFuture<Timed<CompositionResult>>> compose_stage;
         bool should_compose = !missing_entities.empty() && !entity_manager->isComplete();
         
         if (should_compose) {
-            auto compose_start = std::chrono::high_resolution_clock::now();
-            composition_future = std::async(std::launch::async, [this, input_sentence, missing_entities, &result, compose_start]() {
-                // Group missing entities into pairs (max 2 at a time)
-                auto entity_groups = groupEntitiesForComposition(missing_entities);
+            // Group missing entities into pairs (max 2 at a time)
+            auto entity_groups = groupEntitiesForComposition(missing_entities);
+            
+            if (!entity_groups.empty()) {
+                CompositionRequest comp_request(
+                    entity_groups[0],  // First group (up to 2 entities)
+                    entity_manager->getKnownEntities(),
+                    context  // This conversation so far
+                );
+                comp_request.session_key = session->prompt_key;
+                comp_request.history_length = history_length;
                 
-                if (!entity_groups.empty()) {
-                    CompositionRequest comp_request(
-                        entity_groups[0],  // First group (up to 2 entities)
-                        entity_manager->getKnownEntities(),
-                        input_sentence  // Conversation context
-                    );
-                    
-                    auto comp_result = composer->composeQuestion(comp_request);
+                auto stage = StageFuture<Timed<CompositionResult>>::pending();
+                auto compose_start = std::chrono::high_resolution_clock::now();
+                composer->composeQuestionThen(comp_request, [stage, compose_start](CompositionResult comp_result) mutable {
                     auto compose_end = std::chrono::high_resolution_clock::now();
-                    result.metrics.composition_time = std::chrono::duration_cast<std::chrono::milliseconds>(compose_end - compose_start);
-                    result.composition_triggered = true;
-                    return comp_result;
-                }
-                
-                return CompositionResult{};
-            });
+                    stage.complete(Timed<CompositionResult>{std::move(comp_result),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(compose_end - compose_start)});
+                });
+                compose_stage = stage;
+            }
         }
         
+        result.metrics.concurrent_tasks = static_cast<int>(extract_stages.size()) + (joint_stage ? 1 : 0) + (compose_stage ? 1 : 0);
+        
         // PHASE 3: COLLECT EXTRACTION RESULTS AND UPDATE STATE
-        if (!detected_entities.empty()) {
-            auto extract_start = chrono::high_resolution_clock::now();
-            extraction_results = extraction_future.get();
-            auto extract_end = chrono::high_resolution_clock::now();
-            result.metrics.extraction_time = chrono::duration_cast<chrono::milliseconds>(extract_end - extract_start);
-            
-            // Update entity state with extracted values
-            for (const auto& ext_result : extraction_results) {
-                if (ext_result.found) {
-                    entity_manager->updateEntity(ext_result.entity_name, ext_result.extracted_value);
+        for (auto& stage : extract_stages) {
+            extraction_results[stage.first] = co_await stage.second;
+        }
+        if (joint_stage) {
+            for (auto& joint_result : co_await *joint_stage) {
+                for (auto& ext_result : extraction_results) {
+                    if (ext_result.entity_name == joint_result.entity_name) ext_result = joint_result;
                 }
             }
         }
+        auto extract_end = std::chrono::high_resolution_clock::now();
+        result.metrics.extraction_time = std::chrono::duration_cast<std::chrono::milliseconds>(extract_end - extract_start);
+        
+        // Update entity state with extracted values
+        for (const auto& ext_result : extraction_results) {
+            if (ext_result.found) {
+                entity_manager->updateEntity(ext_result.entity_name, ext_result.extracted_value);
+            }
+        }
         
         // PHASE 4: COLLECT COMPOSITION RESULTS
-        if (should_compose) {
-            auto compose_start = chrono::high_resolution_clock::now();
-            result.composition_result = composition_future.get();
-            auto compose_end = chrono::high_resolution_clock::now();
-            result.metrics.composition_time = chrono::duration_cast<chrono::milliseconds>(compose_end - compose_start);
+        if (compose_stage) {
+            auto timed = co_await *compose_stage;
+            result.composition_result = std::move(timed.value);
+            result.metrics.composition_time = timed.elapsed;
             result.composition_triggered = true;
         }
         
-        // PHASE 5: CHECK FOR CLOSING CONDITION
-        if (entity_manager->isComplete()) {
+        // PHASE 5: CHECK FOR CLOSING CONDITION (only on the turn that completes
+        // the appointment, and never once it is booked)
+        bool booking_refused = false;
+        if (!session->booked && !was_complete && entity_manager->isComplete()) {
             auto close_start = std::chrono::high_resolution_clock::now();
             
-            // Trigger closer asynchronously
             ClosingRequest close_request(
                 entity_manager->getKnownEntities(),
-                input_sentence,  // Conversation summary
+                context,  // The turn's snapshot; entity values travel in known entities
                 "Hair salon appointment"  // Business context
             );
+            close_request.session_key = session->prompt_key;
+            close_request.history_length = history_length;
             
-            // Note: Closer is commented out in constructor, uncomment when you implement LLM cloning
-            /*
+            // Closer is only built once an LLM interface can be shared with it
             if (closer) {
-                result.closing_result = closer->generateClosing(close_request);
-                result.closing_triggered = true;
+                // Book first: a taken slot is offered alternatives instead of a closing
+                auto closing = co_await spawnStage(executor, [this, close_request]() -> std::optional<ClosingResult> {
+                    if (!appointment_manager->storeAppointment(closer->createAppointmentSummary(close_request))) {
+                        return std::nullopt;
+                    }
+                    return closer->generateClosing(close_request);
+                });
                 
-                // Store appointment
-                auto appointment = closer->createAppointmentSummary(close_request);
-                appointment_manager->storeAppointment(appointment);
+                if (closing) {
+                    session->booked = true;
+                    result.closing_result = std::move(*closing);
+                    result.closing_triggered = true;
+                } else {
+                    std::string day = entity_manager->getEntity("day_preference");
+                    std::string time = entity_manager->getEntity("time_preference");
+                    auto alternatives = appointment_manager->getSuggestedAlternatives(
+                        day, time, entity_manager->getEntity("service_type"), entity_manager->getEntity("stylist"));
+                    
+                    std::string question;
+                    if (alternatives.empty()) {
+                        question = "What other day and time would work for you?";
+                    } else {
+                        question = "Would ";
+                        for (size_t i = 0; i < alternatives.size(); i++) {
+                            if (i > 0) question += (i + 1 == alternatives.size()) ? " or " : ", ";
+                            question += alternatives[i];
+                        }
+                        question += " work instead?";
+                    }
+                    
+                    // Ask for the time again; the next complete turn books anew
+                    result.composition_result = CompositionResult();
+                    result.composition_result.generated_question = "Sorry, " + day + " at " + time + " is already booked. " + question;
+                    result.composition_result.targeted_entities = {"time_preference"};
+                    result.composition_result.generation_method = "booking_conflict";
+                    result.composition_result.is_valid = true;
+                    result.composition_triggered = true;
+                    entity_manager->updateEntity("time_preference", "");
+                    booking_refused = true;
+                }
             }
-            */
             
             auto close_end = std::chrono::high_resolution_clock::now();
             result.metrics.closing_time = std::chrono::duration_cast<std::chrono::milliseconds>(close_end - close_start);
         }
         
+        // Recorded after booking, so a time that was just refused never
+        // reaches the transcript or the prompt prefix as collected
+        for (const auto& ext_result : extraction_results) {
+            if (ext_result.found && !(booking_refused && ext_result.entity_name == "time_preference")) {
+                transcript.appendEntity(ext_result.entity_name, ext_result.extracted_value);
+            }
+        }
+        
+        if (result.closing_triggered) {
+            transcript.appendReply(result.closing_result.closing_message);
+        } else if (result.composition_triggered) {
+            transcript.appendReply(result.composition_result.generated_question);
+        }
+        
         // PHASE 6: COMBINE RESULTS
         result.entity_results = combineResults(classification_results, extraction_results);
         
         // Calculate final metrics
         auto end_time = std::chrono::high_resolution_clock::now();
         result.metrics.total_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        result.metrics.concurrent_tasks = 2;  // Extraction + Composition
         result.metrics.cpu_cores_used = total_cpu_cores;
         
         active_processing_tasks--;
@@ -267,11 +499,12 @@ public:
             last_metrics = result.metrics;
         }
         
-        return result;
+        co_return result;
     }
     
+public:
     // Print comprehensive results
-    void printProcessingResults(const ProcessingResult& result) {
+    void printProcessingResults(const std::string& session_id, const ProcessingResult& result) {
         std::cout << "\n📋 Complete Processing Results:" << std::endl;
         std::cout << "===============================" << std::endl;
         
@@ -306,11 +539,11 @@ public:
         }
         
         // Entity state
-        std::cout << "\n📊 Entity State:" << std::endl;
+        std::cout << "\n📊 Entity State [" << session_id << "]:" << std::endl;
         std::cout << "  Completion: " << std::fixed << std::setprecision(1) 
-                  << entity_manager->getCompletionPercentage() << "%" << std::endl;
+                  << getSessionCompletion(session_id) << "%" << std::endl;
         
-        auto known = entity_manager->getKnownEntities();
+        auto known = getSessionEntities(session_id);
         for (const auto& pair : known) {
             std::cout << "  " << pair.first << ": \"" << pair.second << "\"" << std::endl;
         }
@@ -446,8 +679,7 @@ public:
         std::stringstream ss;
         ss << "System Status:\n";
         ss << "  Active tasks: " << active_processing_tasks.load() << "\n";
-        ss << "  Entity completion: " << std::fixed << std::setprecision(1) 
-           << entity_manager->getCompletionPercentage() << "%\n";
+        ss << "  Active sessions: " << sessions.size() << "\n";
         ss << "  Total appointments: " << appointment_manager->getTotalAppointments() << "\n";
         
         {
@@ -455,35 +687,73 @@ public:
             ss << "  Last processing time: " << last_metrics.total_time.count() << "ms\n";
         }
         
+        OrtMemoryReport memory = OrtRuntime::instance().getMemoryReport();
+        ss << "  Process RSS: " << memory.rss_bytes / (1024 * 1024) << "MB (peak " 
+           << memory.peak_rss_bytes / (1024 * 1024) << "MB)\n";
+        ss << "  ORT arena shrinks: " << memory.shrinks << "\n";
+        
         return ss.str();
     }
     
+    // Memory accounting: shared crews (counted once per controller sharing
+    // them) plus this controller's conversations
+    void reportMemory(MemoryReport& report) const {
+        classifier->reportMemory(report);
+        extractor->reportMemory(report);
+        composer->reportMemory(report);
+        appointment_manager->reportMemory(report);
+        
+        size_t session_bytes = 0;
+        sessions.forEach([&](const std::string& session_id, const ConversationState& session) {
+            session_bytes += sizeof(ConversationState) + heapBytes(session_id) + session.entities.getMemoryBytes();
+        });
+        report.add("sessions.conversations", session_bytes, sessions.size());
+    }
+    
     PerformanceMetrics getLastMetrics() const {
         std::lock_guard<std::mutex> lock(metrics_mutex);
         return last_metrics;
     }
     
     // Reset and cleanup
-    void resetSession() {
-        entity_manager->reset();
-        std::cout << "🔄 Session reset - ready for new conversation" << std::endl;
+    void resetSession(const std::string& session_id) {
+        endSession(session_id);
+        std::cout << "🔄 Session " << session_id << " reset - ready for new conversation" << std::endl;
     }
     
+    // Drops every conversation; appointments are shared with other controllers
+    // on the same models
     void resetAllData() {
-        entity_manager->reset();
+        sessions.eraseIf([](const std::string&, const ConversationState&) { return true; });
         appointment_manager->reset();
         std::cout << "🔄 All data reset - system ready" << std::endl;
     }
     
     // Getters for individual components
-    EntityStateManager* getEntityManager() const { return entity_manager.get(); }
-    AppointmentManager* getAppointmentManager() const { return appointment_manager.get(); }
+    AppointmentManager* getAppointmentManager() const { return appointment_manager; }
+    ComposerCrew* getComposer() const { return composer; }
     int getActiveTasks() const { return active_processing_tasks.load(); }
     int getTotalCores() const { return total_cpu_cores; }
 };
 
 // Concrete LLM implementation (you'll need to implement the actual API calls)
 class ConcreteLLMInterface : public LLMInterface {
+private:
+    // Prefix ids whose KV cache a local backend would still hold
+    std::unordered_map<uint64_t, std::string> warm_prefixes;  // prefix_id -> last prefix
+    std::mutex prefix_mutex;
+    
+    static std::string placeholderQuestion(const CompositionRequest& request) {
+        if (request.missing_entities.size() == 2) {
+            return "Could you please provide your " + request.missing_entities[0] + 
+                   " and " + request.missing_entities[1] + "?";
+        } else if (request.missing_entities.size() == 1) {
+            return "What is your " + request.missing_entities[0] + "?";
+        }
+        
+        return "Could you provide some additional information?";
+    }
+    
 public:
     std::string generateQuestion(const CompositionRequest& request) override {
         // TODO: Implement your actual LLM API call here
@@ -498,15 +768,31 @@ public:
         // Simulate LLM call delay
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         
-        // Return placeholder response
-        if (request.missing_entities.size() == 2) {
-            return "Could you please provide your " + request.missing_entities[0] + 
-                   " and " + request.missing_entities[1] + "?";
-        } else if (request.missing_entities.size() == 1) {
-            return "What is your " + request.missing_entities[0] + "?";
+        return placeholderQuestion(request);
+    }
+    
+    std::string complete(const LLMPrompt& prompt) override {
+        // Simulated local backend: keeps each prefix_id's prefix and only
+        // prefills what this prompt adds past the part it already has
+        std::string prefix = prompt.text().substr(0, prompt.prefixLength());
+        size_t cached = 0;
+        {
+            std::lock_guard<std::mutex> lock(prefix_mutex);
+            std::string& kept = warm_prefixes[prompt.prefix_id];
+            while (cached < kept.size() && cached < prefix.size() && kept[cached] == prefix[cached]) cached++;
+            kept = std::move(prefix);
         }
+        size_t prefill_bytes = prompt.prefixLength() - cached + prompt.delta.size();
         
-        return "Could you provide some additional information?";
+        std::cout << "🤖 [LLM] Prefix " << std::hex << prompt.prefix_id << std::dec 
+                  << (cached > 0 ? " cached " : " cold ") << cached << " bytes, prefilling "
+                  << prefill_bytes << " bytes" << std::endl;
+        std::this_thread::sleep_for(std::chrono::microseconds(50 * prefill_bytes));
+        
+        if (prompt.kind == PromptKind::CLOSING) {
+            return "Thank you! Your appointment is all set and we look forward to seeing you.";
+        }
+        return placeholderQuestion(*prompt.request);
     }
     
     float assessQuestionQuality(const std::string& question, const CompositionRequest& request) override {
@@ -534,8 +820,16 @@ int main() {
         std::cout << "🎯 Advanced Multithreaded Entity Processing System" << std::endl;
         std::cout << "=================================================" << std::endl;
         
-        // Create LLM interface
-        auto llm_interface = std::make_unique<ConcreteLLMInterface>();
+        // Create LLM interface: a pooled HTTP client when LLM_ENDPOINT is set
+        // (e.g. http://127.0.0.1:8080/v1/completions), otherwise the in-process one
+        std::shared_ptr<LLMInterface> llm_interface;
+        std::shared_ptr<HttpLLMClient> http_llm;
+        if (const char* endpoint = std::getenv("LLM_ENDPOINT")) {
+            http_llm = std::make_shared<HttpLLMClient>(LLMEndpointConfig::fromUrl(endpoint));
+            llm_interface = http_llm;
+        } else {
+            llm_interface = std::make_shared<ConcreteLLMInterface>();
+        }
         
         // Initialize advanced session controller
         AdvancedSessionController controller(
@@ -546,41 +840,80 @@ int main() {
             0.1f   // Extraction threshold (lowered for testing)
         );
         
-        // Test sentences that demonstrate different scenarios
-        std::vector<std::string> test_sentences = {
-            "Hi I'm John",                                    // Single entity
-            "My number is 555-123-4567",                     // Single entity
-            "This is Sarah and my phone is 555-987-6543",   // Multiple entities
-            "Can I book for Friday at 2 PM?",               // Multiple entities
-            "I need a haircut",                              // Single entity
-            "What are your hours today?"                     // No entities (composition trigger)
+        // Two conversations interleaved turn by turn; their turns run concurrently
+        std::vector<std::pair<std::string, std::vector<std::string>>> conversations = {
+            {"caller-1", {
+                "Hi I'm John",                                    // Single entity
+                "My number is 555-123-4567",                     // Single entity
+                "Can I book for Friday at 2 PM?",               // Multiple entities
+                "I need a haircut"                               // Single entity
+            }},
+            {"caller-2", {
+                "This is Sarah and my phone is 555-987-6543",   // Multiple entities
+                "What are your hours today?",                    // No entities (composition trigger)
+                "Tomorrow morning works",                        // Multiple entities
+                "A trim please"                                  // Single entity
+            }}
         };
         
-        for (const auto& sentence : test_sentences) {
+        for (size_t turn = 0; turn < 4; ++turn) {
             std::cout << "\n" << std::string(60, '=') << std::endl;
             
-            // Process input with full multithreading
-            auto result = controller.processInput(sentence);
+            // Submit this turn of every conversation, then collect
+            std::vector<std::future<ProcessingResult>> pending;
+            for (const auto& conversation : conversations) {
+                pending.push_back(controller.processInputAsync(conversation.first, conversation.second[turn]));
+            }
             
-            // Print comprehensive results
-            controller.printProcessingResults(result);
+            for (size_t i = 0; i < conversations.size(); ++i) {
+                auto result = pending[i].get();
+                
+                // Print comprehensive results
+                controller.printProcessingResults(conversations[i].first, result);
+            }
             
             // Show system status
             std::cout << "\n" << controller.getSystemStatus() << std::endl;
-            
-            // Small delay to see threading in action
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
         
         std::cout << "\n🎉 Multithreaded processing demonstration complete!" << std::endl;
         std::cout << "\n📊 Final System Statistics:" << std::endl;
         std::cout << "  Total appointments: " << controller.getAppointmentManager()->getTotalAppointments() << std::endl;
-        std::cout << "  Entity completion: " << std::fixed << std::setprecision(1) 
-                  << controller.getEntityManager()->getCompletionPercentage() << "%" << std::endl;
+        std::cout << "  Active sessions: " << controller.getActiveSessionCount() << std::endl;
+        for (const auto& conversation : conversations) {
+            std::cout << "  " << conversation.first << " completion: " << std::fixed << std::setprecision(1) 
+                      << controller.getSessionCompletion(conversation.first) << "%" << std::endl;
+        }
         
         // Print final metrics
         controller.getLastMetrics().print();
         
+        PromptBuilderStats prompt_stats = controller.getComposer()->getPromptStats();
+        std::cout << "  Prompts built: " << prompt_stats.prompts_built 
+                  << " (avg " << std::fixed << std::setprecision(2) << prompt_stats.avgBuildMicros() << "µs, "
+                  << prompt_stats.prefix_bytes_reused << " prefix bytes reused, "
+                  << prompt_stats.delta_bytes << " delta bytes)" << std::endl;
+        OrtRuntime::instance().printMemoryReport();
+        
+        if (http_llm) {
+            http_llm->getStats().print();
+        }
+        if (BusyPoll::instance().enabled()) {
+            BusyPoll::instance().printStats();
+        }
+        
+        QualityScorerStats quality_stats = controller.getComposer()->getQualityScorer().getStats();
+        std::cout << "  Local quality scores: " << quality_stats.scored << " (avg " << std::fixed
+                  << std::setprecision(2) << quality_stats.avg_micros << "µs)" << std::endl;
+        
+        if (LLMCircuitBreaker* llm_health = controller.getComposer()->getLLMHealth()) {
+            llm_health->getStats().print();
+        }
+        
+        MemoryReport memory_report;
+        controller.reportMemory(memory_report);
+        memory_report.print();
+        
     } catch (const std::exception& e) {
         std::cerr << "❌ Error: " << e.what() << std::endl;
         return 1;
@@ -592,7 +925,7 @@ int main() {
 /*
 COMPILATION:
 ============
-g++ -std=c++17 advanced_session_controller.cpp classifier.cpp extractor.cpp composer.cpp closer.cpp \
+g++ -std=c++20 advanced_session_controller_og.cpp classifier.cpp lexical_prefilter.cpp text_normalizer.cpp ort_runtime.cpp busy_poll.cpp extractor.cpp composer.cpp prompt_builder.cpp question_scorer.cpp http_llm_client.cpp llm_health.cpp closer.cpp time_slots.cpp availability_index.cpp appointment_store.cpp appointment_export.cpp \
     -I/opt/homebrew/Cellar/onnxruntime/1.22.1/include \
     -L/opt/homebrew/Cellar/onnxruntime/1.22.1/lib \
     -lonnxruntime \
@@ -601,20 +934,30 @@ g++ -std=c++17 advanced_session_controller.cpp classifier.cpp extractor.cpp comp
 
 MULTITHREADING ARCHITECTURE:
 ============================
+Each turn is a C++20 coroutine on a shared TurnExecutor (turn_coroutines.h).
+Stages are co_awaited: a waiting turn holds no thread, and the thread count
+is fixed by the executor no matter how many turns are in flight.
+
+Crews and models are loaded once per model directory pair (SharedCrews) and
+conversation state lives in a sharded SessionRegistry keyed by session id.
+A per-session TurnLock keeps each conversation's turns in order while turns
+of different conversations run in parallel.
+
 1. CLASSIFICATION PHASE:
-   - Runs all 5 SVM models in parallel using ClassificationCrew
-   - Each SVM model runs in its own thread
-   - Results collected synchronously
+   - Lexical pre-filter drops heads that cannot fire (no digits, no day word, ...)
+   - Runs the remaining SVM heads in parallel as executor stages
+   - Repeat utterances are answered from the classification cache
 
 2. PARALLEL EXTRACTION + COMPOSITION PHASE:
-   - Extraction: Runs NER models for detected entities in parallel
-   - Composition: Simultaneously generates questions for missing entities
-   - Both phases run concurrently using std::async
+   - Extraction: One executor stage per detected entity, or a single stage
+     for all of them when the joint NER model is loaded
+   - Composition: Runs on the ComposerCrew pool and resumes the turn when done
+   - All stages are started before any of them is awaited
 
 3. CLOSING PHASE:
    - Triggered when all entities are complete
    - Runs LLM closing generation
-   - Stores appointment asynchronously
+   - Stores appointment in the same stage
 
 PERFORMANCE OPTIMIZATIONS:
 ==========================
@@ -635,9 +978,10 @@ PERFORMANCE OPTIMIZATIONS:
 THREAD SAFETY:
 ==============
 - All data structures use std::mutex for thread safety
-- Entity state manager is fully thread-safe
+- Entity state manager is fully thread-safe (one per conversation)
+- Session map is sharded; a turn holds a shared_ptr to its conversation state
 - Atomic counters for performance monitoring
-- No race conditions in parallel processing
+- Per-stage timings are returned by the stages and written only by the turn coroutine
 
 USAGE:
 ======
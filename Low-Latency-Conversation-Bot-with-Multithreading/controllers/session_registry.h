@@ -0,0 +1,101 @@
+#ifndef SESSION_REGISTRY_H
+#define SESSION_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+// Concurrent session map: per-conversation state keyed by session id, split
+// into independently locked shards so lookups from different sessions do not
+// contend. Entries are shared_ptrs, so a turn keeps its state alive even if
+// the session is ended while the turn is still running.
+template <typename State>
+class SessionRegistry {
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<State>> sessions;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    Shard& shardFor(const std::string& session_id) const {
+        return *shards[std::hash<std::string>{}(session_id) % shards.size()];
+    }
+
+public:
+    explicit SessionRegistry(size_t num_shards = 64) {
+        if (num_shards == 0) num_shards = 1;
+        for (size_t i = 0; i < num_shards; ++i) {
+            shards.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    // Existing state, or a new one built by make_state (under the shard lock)
+    std::shared_ptr<State> getOrCreate(const std::string& session_id,
+                                       const std::function<std::shared_ptr<State>()>& make_state) {
+        Shard& shard = shardFor(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto& state = shard.sessions[session_id];
+        if (!state) {
+            state = make_state();
+        }
+        return state;
+    }
+
+    std::shared_ptr<State> find(const std::string& session_id) const {
+        Shard& shard = shardFor(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.sessions.find(session_id);
+        return it != shard.sessions.end() ? it->second : nullptr;
+    }
+
+    bool erase(const std::string& session_id) {
+        Shard& shard = shardFor(session_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.sessions.erase(session_id) > 0;
+    }
+
+    // Remove every session the predicate selects; returns how many went
+    size_t eraseIf(const std::function<bool(const std::string&, const State&)>& predicate) {
+        size_t erased = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (auto it = shard->sessions.begin(); it != shard->sessions.end();) {
+                if (predicate(it->first, *it->second)) {
+                    it = shard->sessions.erase(it);
+                    erased++;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        return erased;
+    }
+
+    // Visits every state under its shard lock (reporting only, keep fn cheap)
+    void forEach(const std::function<void(const std::string&, const State&)>& fn) const {
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            for (const auto& [session_id, state] : shard->sessions) {
+                fn(session_id, *state);
+            }
+        }
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->sessions.size();
+        }
+        return total;
+    }
+};
+
+#endif // SESSION_REGISTRY_H
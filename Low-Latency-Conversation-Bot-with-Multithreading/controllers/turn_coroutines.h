@@ -0,0 +1,321 @@
+#ifndef TURN_COROUTINES_H
+#define TURN_COROUTINES_H
+
+// C++20 coroutine support for the turn pipeline.
+//
+// A turn is a coroutine (TurnTask) that hops onto a shared TurnExecutor and
+// co_awaits its stages. Each stage either runs on the executor (spawnStage)
+// or is completed by someone else's thread (StageFuture::pending + complete,
+// e.g. a ComposerCrew worker). Awaiting a stage suspends the turn instead of
+// blocking a thread; the thread that finishes the stage resumes it. The
+// number of threads is fixed by the executor, not by in-flight turns.
+
+#include <coroutine>
+#include <functional>
+#include <future>
+#include <optional>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <type_traits>
+
+#include "busy_poll.h"
+
+// Fixed-size worker pool shared by every in-flight turn. In busy-poll mode
+// (BusyPoll, decided at construction) workers that get a spinner seat are
+// pinned and spin instead of parking, so a resumed turn starts without a
+// futex wake-up; the rest park on the same queue.
+class TurnExecutor {
+private:
+    std::vector<std::thread> worker_threads;
+    std::queue<std::function<void()>> task_queue;
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    bool stop_workers = false;
+
+    bool busy_poll = false;
+    SpinTaskQueue spin_queue;
+
+    void workerLoop() {
+        if (busy_poll) {
+            SpinnerSeat seat("turn executor");
+            std::function<void()> task;
+            while (spin_queue.pop(task, seat.spinning())) {
+                task();
+            }
+            return;
+        }
+
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_condition.wait(lock, [this] {
+                    return !task_queue.empty() || stop_workers;
+                });
+
+                if (stop_workers && task_queue.empty()) {
+                    break;
+                }
+
+                task = std::move(task_queue.front());
+                task_queue.pop();
+            }
+
+            task();
+        }
+    }
+
+public:
+    explicit TurnExecutor(int num_threads = 0) : busy_poll(BusyPoll::instance().enabled()) {
+        if (num_threads <= 0) {
+            num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        for (int i = 0; i < num_threads; ++i) {
+            worker_threads.emplace_back(&TurnExecutor::workerLoop, this);
+        }
+    }
+
+    ~TurnExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stop_workers = true;
+        }
+        spin_queue.stop();
+        queue_condition.notify_all();
+        for (auto& thread : worker_threads) {
+            if (thread.joinable()) thread.join();
+        }
+    }
+
+    TurnExecutor(const TurnExecutor&) = delete;
+    TurnExecutor& operator=(const TurnExecutor&) = delete;
+
+    // Process-wide executor sized to the hardware
+    static TurnExecutor& shared() {
+        static TurnExecutor executor;
+        return executor;
+    }
+
+    void post(std::function<void()> task) {
+        if (busy_poll) {
+            spin_queue.push(std::move(task));
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            task_queue.push(std::move(task));
+        }
+        queue_condition.notify_one();
+    }
+
+    int getThreadCount() const { return static_cast<int>(worker_threads.size()); }
+
+    // co_await executor.schedule() continues the coroutine on a pool thread
+    auto schedule() {
+        struct ScheduleAwaitable {
+            TurnExecutor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) {
+                executor.post([handle]() { handle.resume(); });
+            }
+            void await_resume() const noexcept {}
+        };
+        return ScheduleAwaitable{*this};
+    }
+};
+
+// Result of a stage that completes on some other thread.
+// co_await suspends until complete()/fail() is called; the completing
+// thread resumes the awaiting coroutine directly.
+template <typename T>
+class StageFuture {
+private:
+    struct State {
+        std::mutex mutex;
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::coroutine_handle<> continuation;
+        bool ready = false;
+    };
+
+    std::shared_ptr<State> state;
+
+    explicit StageFuture(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    void finish() {
+        std::coroutine_handle<> continuation;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->ready = true;
+            continuation = state->continuation;
+        }
+        if (continuation) continuation.resume();
+    }
+
+public:
+    static StageFuture pending() {
+        return StageFuture(std::make_shared<State>());
+    }
+
+    void complete(T value) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->value.emplace(std::move(value));
+        }
+        finish();
+    }
+
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->error = error;
+        }
+        finish();
+    }
+
+    bool await_ready() const {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->ready;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->ready) return false;  // Completed in the meantime, keep running
+        state->continuation = handle;
+        return true;
+    }
+
+    T await_resume() {
+        if (state->error) std::rethrow_exception(state->error);
+        return std::move(*state->value);
+    }
+};
+
+// Stage value paired with how long the stage itself took
+template <typename T>
+struct Timed {
+    T value;
+    std::chrono::milliseconds elapsed{0};
+};
+
+// Run fn on the executor as an awaitable stage
+template <typename F>
+auto spawnStage(TurnExecutor& executor, F fn) -> StageFuture<std::invoke_result_t<F>> {
+    using T = std::invoke_result_t<F>;
+    auto stage = StageFuture<T>::pending();
+    executor.post([stage, fn = std::move(fn)]() mutable {
+        try {
+            stage.complete(fn());
+        } catch (...) {
+            stage.fail(std::current_exception());
+        }
+    });
+    return stage;
+}
+
+// Same, also measuring the stage's own run time
+template <typename F>
+auto spawnTimedStage(TurnExecutor& executor, F fn) -> StageFuture<Timed<std::invoke_result_t<F>>> {
+    return spawnStage(executor, [fn = std::move(fn)]() mutable {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto value = fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        return Timed<decltype(value)>{std::move(value),
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start)};
+    });
+}
+
+// Async mutex for coroutines: serializes turns of one conversation without
+// parking a thread. co_await lock() yields a Guard; when the guard is
+// destroyed the lock is handed to the next waiter, resumed on the executor.
+class TurnLock {
+private:
+    TurnExecutor& executor;
+    std::mutex mutex;
+    bool locked = false;
+    std::deque<std::coroutine_handle<>> waiters;
+
+    void unlock() {
+        std::coroutine_handle<> next;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (waiters.empty()) {
+                locked = false;
+                return;
+            }
+            next = waiters.front();  // Ownership passes straight to the waiter
+            waiters.pop_front();
+        }
+        executor.post([next]() { next.resume(); });
+    }
+
+public:
+    explicit TurnLock(TurnExecutor& executor) : executor(executor) {}
+
+    TurnLock(const TurnLock&) = delete;
+    TurnLock& operator=(const TurnLock&) = delete;
+
+    class Guard {
+    private:
+        TurnLock* owner;
+
+    public:
+        explicit Guard(TurnLock* owner) : owner(owner) {}
+        Guard(Guard&& other) noexcept : owner(other.owner) { other.owner = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+        ~Guard() { if (owner) owner->unlock(); }
+    };
+
+    auto lock() {
+        struct LockAwaitable {
+            TurnLock& turn_lock;
+
+            bool await_ready() {
+                std::lock_guard<std::mutex> lock(turn_lock.mutex);
+                if (turn_lock.locked) return false;
+                turn_lock.locked = true;
+                return true;
+            }
+            bool await_suspend(std::coroutine_handle<> handle) {
+                std::lock_guard<std::mutex> lock(turn_lock.mutex);
+                if (!turn_lock.locked) {  // Released in the meantime
+                    turn_lock.locked = true;
+                    return false;
+                }
+                turn_lock.waiters.push_back(handle);
+                return true;
+            }
+            Guard await_resume() { return Guard(&turn_lock); }
+        };
+        return LockAwaitable{*this};
+    }
+};
+
+// Eagerly started top-level coroutine; its result is delivered through a
+// std::future so synchronous callers block only at the API boundary
+template <typename T>
+struct TurnTask {
+    std::future<T> result;
+
+    struct promise_type {
+        std::promise<T> promise;
+
+        TurnTask get_return_object() { return TurnTask{promise.get_future()}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_value(T value) { promise.set_value(std::move(value)); }
+        void unhandled_exception() { promise.set_exception(std::current_exception()); }
+    };
+};
+
+#endif // TURN_COROUTINES_H
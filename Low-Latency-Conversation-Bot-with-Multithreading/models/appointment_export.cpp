@@ -0,0 +1,207 @@
+#include "appointment_export.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+static const char kCsvHeader[] =
+    "customer_name,customer_phone,service_requested,stylist,preferred_day,preferred_time,"
+    "slot_begin,slot_end,exact,status,booking_timestamp\n";
+
+// Output file (or gzip stream) behind a fixed buffer. Rows are formatted
+// in place; the buffer goes out in one write whenever it fills.
+class CsvSink {
+private:
+    std::FILE* file = nullptr;
+    bool owns_file = false;
+#ifdef HAVE_ZLIB
+    gzFile gz = nullptr;
+#endif
+    std::vector<char> buffer;
+    size_t used = 0;
+    size_t total = 0;
+    std::string error;
+
+    void flush() {
+        if (used == 0 || !error.empty()) {
+            used = 0;
+            return;
+        }
+#ifdef HAVE_ZLIB
+        if (gz) {
+            if (gzwrite(gz, buffer.data(), static_cast<unsigned>(used)) != static_cast<int>(used)) {
+                int code = 0;
+                error = gzerror(gz, &code);
+            }
+            used = 0;
+            return;
+        }
+#endif
+        if (std::fwrite(buffer.data(), 1, used, file) != used) {
+            error = std::strerror(errno);
+        }
+        used = 0;
+    }
+
+    char* reserve(size_t bytes) {
+        if (used + bytes > buffer.size()) {
+            flush();
+            if (bytes > buffer.size()) buffer.resize(bytes);
+        }
+        return buffer.data() + used;
+    }
+
+public:
+    CsvSink(const std::string& path, const ExportOptions& options)
+        : buffer(std::max<size_t>(options.buffer_bytes, 4096)) {
+        if (options.gzip) {
+#ifdef HAVE_ZLIB
+            std::string mode = "wb" + std::to_string(std::clamp(options.gzip_level, 1, 9));
+            // gzclose closes the descriptor, so stdout is written through a duplicate
+            gz = path == "-" ? gzdopen(dup(fileno(stdout)), mode.c_str()) : gzopen(path.c_str(), mode.c_str());
+            if (!gz) error = "cannot open " + path;
+            else gzbuffer(gz, 1u << 17);
+#else
+            error = "gzip export needs a build with -DHAVE_ZLIB -lz";
+#endif
+            return;
+        }
+        if (path == "-") {
+            file = stdout;
+        } else {
+            file = std::fopen(path.c_str(), "wb");
+            owns_file = file != nullptr;
+            if (!file) error = "cannot open " + path + ": " + std::strerror(errno);
+        }
+    }
+
+    ~CsvSink() { close(); }
+
+    const std::string& getError() const { return error; }
+    size_t bytesWritten() const { return total; }
+
+    void put(const char* data, size_t size) {
+        std::memcpy(reserve(size), data, size);
+        used += size;
+        total += size;
+    }
+
+    void put(char c) {
+        *reserve(1) = c;
+        used++;
+        total++;
+    }
+
+    // Quoted only when it contains a delimiter, quote or line break
+    void putField(const std::string& value) {
+        if (value.find_first_of(",\"\r\n") == std::string::npos) {
+            put(value.data(), value.size());
+            return;
+        }
+        char* out = reserve(2 * value.size() + 2);
+        char* begin = out;
+        *out++ = '"';
+        for (char c : value) {
+            if (c == '"') *out++ = '"';
+            *out++ = c;
+        }
+        *out++ = '"';
+        used += out - begin;
+        total += out - begin;
+    }
+
+    void putInt(long long value) {
+        char* out = reserve(24);
+        char* end = std::to_chars(out, out + 24, value).ptr;
+        used += end - out;
+        total += end - out;
+    }
+
+    bool close() {
+        flush();
+#ifdef HAVE_ZLIB
+        if (gz) {
+            if (gzclose(gz) != Z_OK && error.empty()) error = "gzip close failed";
+            gz = nullptr;
+        }
+#endif
+        if (file) {
+            if ((owns_file ? std::fclose(file) : std::fflush(file)) != 0 && error.empty()) {
+                error = std::strerror(errno);
+            }
+            file = nullptr;
+        }
+        return error.empty();
+    }
+};
+
+bool AppointmentExporter::gzipAvailable() {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+ExportResult AppointmentExporter::writeCsv(const AppointmentSnapshot& snapshot, const std::string& path,
+                                           const ExportOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    ExportResult result;
+
+    CsvSink sink(path, options);
+    if (!sink.getError().empty()) {
+        result.error = sink.getError();
+        std::cerr << "❌ Appointment export failed: " << result.error << std::endl;
+        return result;
+    }
+
+    if (options.header) sink.put(kCsvHeader, sizeof(kCsvHeader) - 1);
+    snapshot.forEach([&](const AppointmentSummary& apt) {
+        sink.putField(apt.customer_name);
+        sink.put(',');
+        sink.putField(apt.customer_phone);
+        sink.put(',');
+        sink.putField(apt.service_requested);
+        sink.put(',');
+        sink.putField(apt.stylist);
+        sink.put(',');
+        sink.putField(apt.preferred_day);
+        sink.put(',');
+        sink.putField(apt.preferred_time);
+        sink.put(',');
+        sink.putInt(apt.slot.begin);
+        sink.put(',');
+        sink.putInt(apt.slot.end);
+        sink.put(',');
+        sink.put(apt.slot.exact ? '1' : '0');
+        sink.put(',');
+        sink.putField(apt.status);
+        sink.put(',');
+        sink.putField(apt.booking_timestamp);
+        sink.put('\n');
+    });
+
+    result.ok = sink.close();
+    result.rows = snapshot.size();
+    result.bytes = sink.bytesWritten();
+    result.error = sink.getError();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (result.ok) {
+        std::ostream& log = path == "-" ? std::cerr : std::cout;  // Keep stdout exports clean
+        log << "📦 Exported " << result.rows << " appointments (" << result.bytes / 1024 << " KB CSV"
+            << (options.gzip ? ", gzip" : "") << ") in " << result.seconds << "s" << std::endl;
+    } else {
+        std::cerr << "❌ Appointment export failed: " << result.error << std::endl;
+    }
+    return result;
+}
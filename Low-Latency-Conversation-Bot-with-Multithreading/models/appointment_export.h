@@ -0,0 +1,38 @@
+#ifndef APPOINTMENT_EXPORT_H
+#define APPOINTMENT_EXPORT_H
+
+#include <string>
+#include <cstddef>
+
+#include "appointment_store.h"
+
+// How an export is written
+struct ExportOptions {
+    bool header = true;               // Column names as the first line
+    bool gzip = false;                // Needs a build with -DHAVE_ZLIB -lz
+    size_t buffer_bytes = 1u << 20;   // Rows are formatted into this buffer, then written in one call
+    int gzip_level = 1;               // Fast: exports are bulk transfers, not archives
+};
+
+struct ExportResult {
+    bool ok = false;
+    size_t rows = 0;
+    size_t bytes = 0;  // CSV bytes before compression
+    double seconds = 0.0;
+    std::string error;
+};
+
+// Streams a snapshot as RFC 4180 CSV. Only the snapshot is read, so bookings
+// keep appending to the live store (and clear() may start a new generation)
+// while a multi-million-row export runs. Fields are escaped straight into the
+// output buffer; nothing goes through toJSON() or a stringstream.
+class AppointmentExporter {
+public:
+    static bool gzipAvailable();
+
+    // path "-" writes to stdout
+    static ExportResult writeCsv(const AppointmentSnapshot& snapshot, const std::string& path,
+                                 const ExportOptions& options = ExportOptions());
+};
+
+#endif // APPOINTMENT_EXPORT_H
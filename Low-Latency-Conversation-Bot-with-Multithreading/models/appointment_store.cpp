@@ -0,0 +1,156 @@
+#include "appointment_store.h"
+#include <sstream>
+#include <new>
+
+// AppointmentSummary Implementation
+std::string AppointmentSummary::toString() const {
+    std::stringstream ss;
+    ss << "Appointment Summary:\n"
+       << "  Customer: " << customer_name << "\n"
+       << "  Phone: " << customer_phone << "\n"
+       << "  Service: " << service_requested << "\n"
+       << "  Stylist: " << (stylist.empty() ? "Any" : stylist) << "\n"
+       << "  Preferred Day: " << preferred_day << "\n"
+       << "  Preferred Time: " << preferred_time << "\n"
+       << "  Status: " << status << "\n"
+       << "  Booked: " << booking_timestamp;
+    return ss.str();
+}
+
+std::string AppointmentSummary::toJSON() const {
+    std::stringstream ss;
+    ss << "{\n"
+       << "  \"customer_name\": \"" << customer_name << "\",\n"
+       << "  \"customer_phone\": \"" << customer_phone << "\",\n"
+       << "  \"service_requested\": \"" << service_requested << "\",\n"
+       << "  \"stylist\": \"" << stylist << "\",\n"
+       << "  \"preferred_day\": \"" << preferred_day << "\",\n"
+       << "  \"preferred_time\": \"" << preferred_time << "\",\n"
+       << "  \"status\": \"" << status << "\",\n"
+       << "  \"booking_timestamp\": \"" << booking_timestamp << "\"\n"
+       << "}";
+    return ss.str();
+}
+
+std::unordered_map<std::string, int> AppointmentStats::serviceCounts() const {
+    std::unordered_map<std::string, int> counts;
+    for (size_t i = 0; i < service_counts.size(); i++) {
+        counts[(*services)[i]] = service_counts[i];
+    }
+    return counts;
+}
+
+// AppointmentLog Implementation
+AppointmentLog::~AppointmentLog() {
+    for (size_t row = 0; row < rows; row++) {
+        chunks[row / kChunkRows][row % kChunkRows].~AppointmentSummary();
+    }
+    for (AppointmentSummary* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+}
+
+bool AppointmentLog::append(const AppointmentSummary& appointment) {
+    size_t chunk = rows / kChunkRows;
+    if (chunk >= kMaxChunks) return false;
+    if (!chunks[chunk]) {
+        chunks[chunk] = static_cast<AppointmentSummary*>(::operator new(kChunkRows * sizeof(AppointmentSummary)));
+    }
+    new (chunks[chunk] + rows % kChunkRows) AppointmentSummary(appointment);
+    rows++;
+    return true;
+}
+
+size_t AppointmentLog::memoryBytes(size_t prefix_rows) const {
+    size_t chunk_count = (prefix_rows + kChunkRows - 1) / kChunkRows;
+    size_t bytes = sizeof(AppointmentLog) + chunk_count * kChunkRows * sizeof(AppointmentSummary);
+    for (size_t row = 0; row < prefix_rows; row++) {
+        bytes += heapBytes((*this)[row]);
+    }
+    return bytes;
+}
+
+// AppointmentSnapshot Implementation
+static const std::shared_ptr<const AppointmentLog>& emptyLog() {
+    static const std::shared_ptr<const AppointmentLog> log = std::make_shared<AppointmentLog>();
+    return log;
+}
+
+static const std::shared_ptr<const AppointmentStats>& emptyStats() {
+    static const std::shared_ptr<const AppointmentStats> stats = std::make_shared<AppointmentStats>();
+    return stats;
+}
+
+AppointmentSnapshot::AppointmentSnapshot() : log(emptyLog()), stats(emptyStats()) {}
+
+std::vector<AppointmentSummary> AppointmentSnapshot::toVector() const {
+    std::vector<AppointmentSummary> appointments;
+    appointments.reserve(rows);
+    forEach([&](const AppointmentSummary& appointment) { appointments.push_back(appointment); });
+    return appointments;
+}
+
+size_t AppointmentSnapshot::memoryBytes() const {
+    size_t bytes = log->memoryBytes(rows) + sizeof(AppointmentStats) +
+                   stats->service_counts.capacity() * sizeof(int);
+    if (stats->services) bytes += heapBytes(*stats->services);
+    return bytes;
+}
+
+// AppointmentStore Implementation
+AppointmentStore::AppointmentStore() : log(std::make_shared<AppointmentLog>()) {
+    current.log = log;
+}
+
+bool AppointmentStore::append(const AppointmentSummary& appointment) {
+    if (!log->append(appointment)) return false;
+
+    // Next counters from the published ones; the writer is the only one
+    // replacing current, so reading it here needs no lock
+    auto stats = std::make_shared<AppointmentStats>(*current.stats);
+    stats->total++;
+    if (appointment.slot.valid()) {
+        stats->per_day[appointment.slot.day()]++;
+        if (appointment.slot.exact) {
+            stats->per_hour[(appointment.slot.begin % kMinutesPerDay) / 60]++;
+        }
+    }
+
+    auto service = service_ids.find(appointment.service_requested);
+    if (service == service_ids.end()) {
+        // New service: the name list is copied, published lists stay untouched
+        auto services = stats->services ? std::make_shared<std::vector<std::string>>(*stats->services)
+                                        : std::make_shared<std::vector<std::string>>();
+        services->push_back(appointment.service_requested);
+        stats->services = services;
+        stats->service_counts.push_back(0);
+        service = service_ids.emplace(appointment.service_requested, services->size() - 1).first;
+    }
+    stats->service_counts[service->second]++;
+
+    AppointmentSnapshot next;
+    next.log = log;
+    next.rows = log->size();
+    next.stats = std::move(stats);
+
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    std::swap(current, next);
+    return true;  // The previous snapshot is released outside the lock
+}
+
+AppointmentSnapshot AppointmentStore::snapshot() const {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    return current;
+}
+
+void AppointmentStore::clear() {
+    // A fresh generation: readers still holding the old log keep it alive
+    log = std::make_shared<AppointmentLog>();
+    service_ids.clear();
+
+    AppointmentSnapshot next;
+    next.log = log;
+
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    std::swap(current, next);
+}
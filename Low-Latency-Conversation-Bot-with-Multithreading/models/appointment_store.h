@@ -0,0 +1,134 @@
+#ifndef APPOINTMENT_STORE_H
+#define APPOINTMENT_STORE_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+
+#include "memory_accounting.h"
+#include "time_slots.h"
+
+// Appointment summary structure for internal processing
+struct AppointmentSummary {
+    std::string customer_name;
+    std::string customer_phone;
+    std::string preferred_day;
+    std::string preferred_time;
+    std::string service_requested;
+    std::string stylist;  // As requested, or the one assigned at booking ("" = anyone)
+    std::string booking_timestamp;
+    std::string status;  // "confirmed", "pending", "needs_followup"
+    SlotRange slot;      // preferred_day + preferred_time as minute-of-week ids
+
+    // Convert to formatted string
+    std::string toString() const;
+
+    // Convert to JSON-like format
+    std::string toJSON() const;
+};
+
+inline size_t heapBytes(const AppointmentSummary& appointment) {
+    return heapBytes(appointment.customer_name) + heapBytes(appointment.customer_phone) +
+           heapBytes(appointment.preferred_day) + heapBytes(appointment.preferred_time) +
+           heapBytes(appointment.service_requested) + heapBytes(appointment.stylist) +
+           heapBytes(appointment.booking_timestamp) +
+           heapBytes(appointment.status);
+}
+
+// Counters over the stored appointments, updated as each one is appended.
+// A published AppointmentStats is never modified again.
+struct AppointmentStats {
+    size_t total = 0;
+    std::array<int, 7> per_day{};    // Slot weekday (Monday = 0); unparsed days are not counted
+    std::array<int, 24> per_hour{};  // Start hour of exact slots
+    std::shared_ptr<const std::vector<std::string>> services;  // Distinct services, first-seen order
+    std::vector<int> service_counts;                            // Parallel to *services
+
+    std::unordered_map<std::string, int> serviceCounts() const;
+};
+
+// Append-only rows in fixed-size chunks. A row never moves once written, so
+// readers can use any prefix that was published to them while the single
+// writer keeps appending past it. Chunks are raw storage and rows are
+// constructed as they arrive, so opening a chunk costs one allocation rather
+// than 4096 constructors on the booking path.
+class AppointmentLog {
+public:
+    static constexpr size_t kChunkRows = 4096;
+    static constexpr size_t kMaxChunks = 4096;  // ~16.7M rows
+
+private:
+    std::array<AppointmentSummary*, kMaxChunks> chunks{};
+    size_t rows = 0;  // Writer only
+
+public:
+    AppointmentLog() = default;
+    AppointmentLog(const AppointmentLog&) = delete;
+    AppointmentLog& operator=(const AppointmentLog&) = delete;
+    ~AppointmentLog();
+
+    bool append(const AppointmentSummary& appointment);  // False when full
+    size_t size() const { return rows; }
+    const AppointmentSummary& operator[](size_t row) const { return chunks[row / kChunkRows][row % kChunkRows]; }
+    const AppointmentSummary* chunk(size_t index) const { return chunks[index]; }
+    size_t memoryBytes(size_t prefix_rows) const;
+};
+
+// A consistent, immutable view of the store: the first size() rows of one
+// log generation and the counters for exactly those rows. Cheap to copy;
+// holding one keeps its rows alive across clear().
+class AppointmentSnapshot {
+private:
+    std::shared_ptr<const AppointmentLog> log;
+    size_t rows = 0;
+    std::shared_ptr<const AppointmentStats> stats;
+
+    friend class AppointmentStore;
+
+public:
+    AppointmentSnapshot();
+
+    size_t size() const { return rows; }
+    bool empty() const { return rows == 0; }
+    const AppointmentSummary& operator[](size_t row) const { return (*log)[row]; }
+    const AppointmentStats& getStats() const { return *stats; }
+
+    // Calls fn(row) for each row, a chunk at a time
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t begin = 0; begin < rows; begin += AppointmentLog::kChunkRows) {
+            const AppointmentSummary* chunk = log->chunk(begin / AppointmentLog::kChunkRows);
+            size_t count = std::min(rows - begin, AppointmentLog::kChunkRows);
+            for (size_t i = 0; i < count; i++) fn(chunk[i]);
+        }
+    }
+
+    std::vector<AppointmentSummary> toVector() const;
+    size_t memoryBytes() const;
+};
+
+// Appointment rows plus incrementally maintained counters. append() and
+// clear() must be serialized by the caller (AppointmentManager holds
+// appointments_mutex); snapshot() may be called from any thread and only
+// waits for the pointer swap that publishes the previous append.
+class AppointmentStore {
+private:
+    std::shared_ptr<AppointmentLog> log;
+    std::unordered_map<std::string, size_t> service_ids;  // Writer only
+
+    mutable std::mutex publish_mutex;  // Guards current (held for a pointer copy)
+    AppointmentSnapshot current;
+
+public:
+    AppointmentStore();
+
+    bool append(const AppointmentSummary& appointment);  // False when the log is full
+    AppointmentSnapshot snapshot() const;
+    void clear();
+};
+
+#endif // APPOINTMENT_STORE_H
@@ -0,0 +1,296 @@
+#include "availability_index.h"
+#include "memory_accounting.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+using DayBits = AvailabilityIndex::DayBits;
+
+static std::string lowercase(std::string_view text) {
+    std::string lower(text);
+    for (char& c : lower) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c + ('a' - 'A'));
+    }
+    return lower;
+}
+
+// "Sam, Alex" -> {"Sam", "Alex"}
+static std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t first = item.find_first_not_of(" \t");
+        size_t last = item.find_last_not_of(" \t");
+        if (first != std::string::npos) items.push_back(item.substr(first, last - first + 1));
+    }
+    return items;
+}
+
+AvailabilityConfig::AvailabilityConfig() {
+    service_minutes = {
+        {"haircut", 45}, {"cut", 45}, {"trim", 30}, {"fade", 30}, {"shave", 30}, {"beard", 20},
+        {"color", 90}, {"colour", 90}, {"coloring", 90}, {"dye", 90}, {"highlights", 120},
+        {"lowlights", 120}, {"balayage", 180}, {"blowout", 45}, {"blowdry", 45}, {"style", 45},
+        {"styling", 45}, {"updo", 60}, {"perm", 120}, {"keratin", 150}, {"straightening", 150},
+        {"extensions", 180}, {"braids", 120}, {"braiding", 120}, {"treatment", 30}, {"wash", 15},
+        {"manicure", 45}, {"pedicure", 60}, {"nails", 60}, {"wax", 30}, {"waxing", 30},
+        {"facial", 60}, {"massage", 60}
+    };
+}
+
+AvailabilityConfig AvailabilityConfig::fromEnvironment() {
+    AvailabilityConfig config;
+
+    if (const char* stylists = std::getenv("SALON_STYLISTS")) {
+        config.stylists = splitList(stylists);
+    }
+    if (const char* hours = std::getenv("SALON_HOURS")) {
+        TimeOfDay open = TimeSlotParser::parseTime(hours);
+        if (open.valid() && !open.exact) {
+            config.open_minute = open.begin;
+            config.close_minute = open.end;
+        } else {
+            std::cerr << "⚠️ Ignoring SALON_HOURS (expected a range like 9am-7pm): " << hours << std::endl;
+        }
+    }
+    if (const char* closed = std::getenv("SALON_CLOSED_DAYS")) {
+        config.closed_days = 0;
+        for (const auto& day : splitList(closed)) {
+            int index = TimeSlotParser::parseDay(day);
+            if (index >= 0) {
+                config.closed_days |= static_cast<uint8_t>(1u << index);
+            } else if (day != "none") {
+                std::cerr << "⚠️ Ignoring unknown closed day: " << day << std::endl;
+            }
+        }
+    }
+    if (const char* services = std::getenv("SALON_SERVICE_MINUTES")) {
+        for (const auto& entry : splitList(services)) {
+            size_t equals = entry.find('=');
+            int minutes = equals == std::string::npos ? 0 : std::atoi(entry.c_str() + equals + 1);
+            if (minutes > 0) {
+                config.service_minutes[lowercase(entry.substr(0, equals))] = minutes;
+            } else {
+                std::cerr << "⚠️ Ignoring service length: " << entry << std::endl;
+            }
+        }
+    }
+    if (const char* step = std::getenv("SALON_SUGGESTION_STEP")) {
+        int minutes = std::atoi(step);
+        if (minutes > 0 && minutes % kAvailabilityMinutes == 0) {
+            config.suggestion_step = minutes;
+        }
+    }
+    return config;
+}
+
+// Bits [begin, end) of one day
+static void setBits(DayBits& bits, int begin, int end, bool value) {
+    for (int bit = begin; bit < end; ) {
+        int word = bit / 64;
+        int offset = bit % 64;
+        int count = std::min(64 - offset, end - bit);
+        uint64_t mask = (count == 64 ? ~0ull : ((1ull << count) - 1)) << offset;
+        bits[word] = value ? (bits[word] | mask) : (bits[word] & ~mask);
+        bit += count;
+    }
+}
+
+static bool anySet(const DayBits& a, const DayBits& b, int begin, int end) {
+    for (int bit = begin; bit < end; ) {
+        int word = bit / 64;
+        int offset = bit % 64;
+        int count = std::min(64 - offset, end - bit);
+        uint64_t mask = (count == 64 ? ~0ull : ((1ull << count) - 1)) << offset;
+        if ((a[word] | b[word]) & mask) return true;
+        bit += count;
+    }
+    return false;
+}
+
+// Bit i of the result is bit i + shift of the input (zeros shifted in at the top)
+static DayBits shiftDown(const DayBits& bits, int shift) {
+    DayBits shifted{};
+    int words = shift / 64;
+    int offset = shift % 64;
+    for (size_t w = 0; w + words < bits.size(); w++) {
+        uint64_t low = bits[w + words] >> offset;
+        uint64_t high = (offset != 0 && w + words + 1 < bits.size()) ? bits[w + words + 1] << (64 - offset) : 0;
+        shifted[w] = low | high;
+    }
+    return shifted;
+}
+
+// Weekday and [begin, end) bits of a range inside one day; false otherwise
+static bool rangeBits(const SlotRange& range, int& day, int& begin, int& end) {
+    if (!range.valid() || range.end > kMinutesPerWeek) return false;
+    day = range.day();
+    int first_minute = range.begin - day * kMinutesPerDay;
+    int last_minute = range.end - day * kMinutesPerDay;
+    if (last_minute > kMinutesPerDay) return false;
+    begin = first_minute / kAvailabilityMinutes;
+    end = (last_minute + kAvailabilityMinutes - 1) / kAvailabilityMinutes;
+    return true;
+}
+
+AvailabilityIndex::AvailabilityIndex(const AvailabilityConfig& index_config) : config(index_config) {
+    int open_bit = std::clamp(config.open_minute / kAvailabilityMinutes, 0, kAvailabilityBitsPerDay);
+    int close_bit = std::clamp(config.close_minute / kAvailabilityMinutes, open_bit, kAvailabilityBitsPerDay);
+    for (int day = 0; day < 7; day++) {
+        closed[day].fill(0);
+        if (config.closed_days & (1u << day)) {
+            setBits(closed[day], 0, kAvailabilityBitsPerDay, true);
+        } else {
+            setBits(closed[day], 0, open_bit, true);
+            setBits(closed[day], close_bit, kAvailabilityBitsPerDay, true);
+        }
+        setBits(closed[day], kAvailabilityBitsPerDay, static_cast<int>(kAvailabilityWordsPerDay * 64), true);
+    }
+
+    step_starts.fill(0);
+    int step_bits = std::max(1, config.suggestion_step / kAvailabilityMinutes);
+    for (int bit = 0; bit < kAvailabilityBitsPerDay; bit += step_bits) {
+        setBits(step_starts, bit, bit + 1, true);
+    }
+
+    for (const auto& name : config.stylists) addStylist(name);
+    if (names.empty()) addStylist("");  // One unnamed chair
+}
+
+int AvailabilityIndex::addStylist(const std::string& name) {
+    std::string key = lowercase(name);
+    auto it = ids.find(key);
+    if (it != ids.end()) return it->second;
+
+    int id = static_cast<int>(names.size());
+    names.push_back(name);
+    ids.emplace(std::move(key), id);
+    std::array<DayBits, 7> empty{};
+    busy.push_back(empty);
+    return id;
+}
+
+int AvailabilityIndex::stylistId(std::string_view name) const {
+    auto it = ids.find(lowercase(name));
+    return it == ids.end() ? -1 : it->second;
+}
+
+int AvailabilityIndex::serviceMinutes(std::string_view service) const {
+    int minutes = 0;
+    std::string word;
+    for (size_t i = 0; i <= service.size(); i++) {
+        char c = i < service.size() ? service[i] : ' ';
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            word.push_back(static_cast<char>(c | 0x20));
+            continue;
+        }
+        if (!word.empty()) {
+            auto it = config.service_minutes.find(word);
+            if (it != config.service_minutes.end()) minutes += it->second;
+            word.clear();
+        }
+    }
+    return minutes > 0 ? minutes : config.default_service_minutes;
+}
+
+bool AvailabilityIndex::isFree(int stylist, const SlotRange& range) const {
+    int day, begin, end;
+    if (stylist < 0 || stylist >= static_cast<int>(busy.size()) || !rangeBits(range, day, begin, end)) {
+        return false;
+    }
+    return !anySet(busy[stylist][day], closed[day], begin, end);
+}
+
+int AvailabilityIndex::anyFree(const SlotRange& range) const {
+    for (int stylist = 0; stylist < static_cast<int>(busy.size()); stylist++) {
+        if (isFree(stylist, range)) return stylist;
+    }
+    return -1;
+}
+
+bool AvailabilityIndex::book(int stylist, const SlotRange& range) {
+    int day = 0, begin = 0, end = 0;
+    if (!isFree(stylist, range) || !rangeBits(range, day, begin, end)) return false;
+    setBits(busy[stylist][day], begin, end, true);
+    return true;
+}
+
+void AvailabilityIndex::release(int stylist, const SlotRange& range) {
+    int day, begin, end;
+    if (stylist < 0 || stylist >= static_cast<int>(busy.size()) || !rangeBits(range, day, begin, end)) return;
+    setBits(busy[stylist][day], begin, end, false);
+}
+
+DayBits AvailabilityIndex::freeRuns(int stylist, int day, int length) const {
+    DayBits runs;
+    for (size_t w = 0; w < runs.size(); w++) {
+        runs[w] = ~(busy[stylist][day][w] | closed[day][w]);
+    }
+    // runs has bit i set when bits [i, i + covered) are all free
+    for (int covered = 1; covered < length; ) {
+        int shift = std::min(covered, length - covered);
+        DayBits shifted = shiftDown(runs, shift);
+        for (size_t w = 0; w < runs.size(); w++) runs[w] &= shifted[w];
+        covered += shift;
+    }
+    for (size_t w = 0; w < runs.size(); w++) runs[w] &= step_starts[w];
+    return runs;
+}
+
+std::vector<FreeSlot> AvailabilityIndex::nextFree(int stylist, int32_t from, int minutes, size_t count) const {
+    std::vector<FreeSlot> slots;
+    if (count == 0 || stylist >= static_cast<int>(busy.size())) return slots;
+
+    from = std::clamp<int32_t>(from, 0, kMinutesPerWeek - 1);
+    int length = std::max(1, (minutes + kAvailabilityMinutes - 1) / kAvailabilityMinutes);
+    int from_day = from / kMinutesPerDay;
+    int from_bit = (from % kMinutesPerDay + kAvailabilityMinutes - 1) / kAvailabilityMinutes;
+
+    int first = stylist < 0 ? 0 : stylist;
+    int last = stylist < 0 ? static_cast<int>(busy.size()) : stylist + 1;
+    std::vector<DayBits> runs(last - first);
+
+    // Seven days ahead, then the start of today before `from` (the week wraps)
+    for (int ahead = 0; ahead <= 7 && slots.size() < count; ahead++) {
+        int day = (from_day + ahead) % 7;
+        if (config.closed_days & (1u << day)) continue;
+
+        DayBits window{};
+        if (ahead == 0) setBits(window, from_bit, kAvailabilityBitsPerDay, true);
+        else if (ahead == 7) setBits(window, 0, from_bit, true);
+        else setBits(window, 0, kAvailabilityBitsPerDay, true);
+
+        DayBits any{};
+        for (int s = first; s < last; s++) {
+            DayBits& stylist_runs = runs[s - first];
+            stylist_runs = freeRuns(s, day, length);
+            for (size_t w = 0; w < any.size(); w++) {
+                stylist_runs[w] &= window[w];
+                any[w] |= stylist_runs[w];
+            }
+        }
+
+        // Earliest starts first; the lowest stylist id free at each start
+        for (size_t w = 0; w < any.size() && slots.size() < count; w++) {
+            for (uint64_t bits = any[w]; bits != 0 && slots.size() < count; bits &= bits - 1) {
+                int bit = static_cast<int>(w * 64) + __builtin_ctzll(bits);
+                int free_stylist = first;
+                while (!(runs[free_stylist - first][w] & (1ull << (bit % 64)))) free_stylist++;
+                slots.push_back(FreeSlot{TimeSlotParser::slotId(day, bit * kAvailabilityMinutes), free_stylist});
+            }
+        }
+    }
+    return slots;
+}
+
+size_t AvailabilityIndex::memoryBytes() const {
+    return heapBytes(names) + heapBytes(ids) + busy.capacity() * sizeof(busy[0]);
+}
+
+void AvailabilityIndex::clear() {
+    for (auto& week : busy) {
+        for (auto& day : week) day.fill(0);
+    }
+}
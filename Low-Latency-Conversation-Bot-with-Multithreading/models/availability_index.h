@@ -0,0 +1,88 @@
+#ifndef AVAILABILITY_INDEX_H
+#define AVAILABILITY_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
+
+#include "time_slots.h"
+
+constexpr int32_t kAvailabilityMinutes = 5;  // One bit per 5 minutes
+constexpr int32_t kAvailabilityBitsPerDay = kMinutesPerDay / kAvailabilityMinutes;
+constexpr size_t kAvailabilityWordsPerDay = (kAvailabilityBitsPerDay + 63) / 64;
+
+// Roster, opening hours and service lengths for the availability index
+struct AvailabilityConfig {
+    std::vector<std::string> stylists;  // Empty: a single unnamed chair
+    int open_minute = 9 * 60;
+    int close_minute = 19 * 60;
+    uint8_t closed_days = 1u << 6;      // One bit per weekday (Monday = bit 0); Sunday
+    int suggestion_step = 15;           // Suggested starts fall on these minute boundaries
+    int default_service_minutes = 60;
+    std::unordered_map<std::string, int> service_minutes;  // Lowercase service word -> minutes
+
+    AvailabilityConfig();
+
+    // SALON_STYLISTS=Sam,Alex  SALON_HOURS=9am-7pm  SALON_CLOSED_DAYS=sunday,monday
+    // SALON_SERVICE_MINUTES=balayage=180,trim=30  SALON_SUGGESTION_STEP=15
+    static AvailabilityConfig fromEnvironment();
+};
+
+// One bookable start time
+struct FreeSlot {
+    int32_t begin;  // Minute-of-week slot id
+    int stylist;    // AvailabilityIndex stylist id
+};
+
+// Busy bitmaps per stylist and weekday, one bit per 5 minutes. Free-run
+// searches AND each day's free bits with shifted copies of itself, so "next
+// free 90 minutes" is a handful of word operations per stylist and day.
+// The week is cyclic (bookings carry weekdays, not dates).
+//
+// Not synchronized: AppointmentManager calls it under its own mutex.
+class AvailabilityIndex {
+public:
+    using DayBits = std::array<uint64_t, kAvailabilityWordsPerDay>;
+
+private:
+    AvailabilityConfig config;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> ids;  // Lowercase name -> stylist id
+    std::vector<std::array<DayBits, 7>> busy;  // [stylist][weekday]
+    std::array<DayBits, 7> closed;             // Outside opening hours, plus the padding bits
+    DayBits step_starts;                       // Bits on suggestion_step boundaries
+
+    // Bits whose free run of `length` bits starts there, for one stylist and day
+    DayBits freeRuns(int stylist, int day, int length) const;
+
+public:
+    explicit AvailabilityIndex(const AvailabilityConfig& config = AvailabilityConfig::fromEnvironment());
+
+    // Roster; ids are dense and stable. Names match case-insensitively.
+    int addStylist(const std::string& name);
+    int stylistId(std::string_view name) const;
+    const std::string& stylistName(int stylist) const { return names[stylist]; }
+    size_t stylistCount() const { return names.size(); }
+
+    // Minutes a service takes: the sum of its known words ("cut and colour"),
+    // or the default length
+    int serviceMinutes(std::string_view service) const;
+
+    // Whole 5-minute bits covering a range; a range outside opening hours is never free
+    bool isFree(int stylist, const SlotRange& range) const;
+    int anyFree(const SlotRange& range) const;  // First free stylist, or -1
+    bool book(int stylist, const SlotRange& range);  // False (and nothing marked) if not free
+    void release(int stylist, const SlotRange& range);
+
+    // Up to `count` earliest starts at or after `from` where `minutes` are free,
+    // within the next 7 days; stylist -1 looks across the whole roster
+    std::vector<FreeSlot> nextFree(int stylist, int32_t from, int minutes, size_t count) const;
+
+    size_t memoryBytes() const;
+    void clear();
+};
+
+#endif // AVAILABILITY_INDEX_H
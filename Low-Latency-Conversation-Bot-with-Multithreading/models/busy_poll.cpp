@@ -0,0 +1,195 @@
+#include "busy_poll.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <sys/socket.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Fallbacks for older libc headers
+#if defined(__linux__) && !defined(SO_BUSY_POLL)
+#define SO_BUSY_POLL 46
+#endif
+#if defined(__linux__) && !defined(SO_PREFER_BUSY_POLL)
+#define SO_PREFER_BUSY_POLL 69
+#endif
+
+std::vector<int> BusyPollConfig::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ',')) {
+        if (range.empty()) continue;
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "⚠️ Ignoring bad CPU range: " << range << std::endl;
+        }
+    }
+    return cpus;
+}
+
+BusyPollConfig BusyPollConfig::fromEnvironment() {
+    BusyPollConfig config;
+
+    const char* enabled = std::getenv("BUSY_POLL");
+    config.enabled = enabled && *enabled && std::string(enabled) != "0";
+
+    if (const char* cpus = std::getenv("BUSY_POLL_CPUS")) {
+        config.cpus = parseCpuList(cpus);
+    }
+    if (const char* usec = std::getenv("BUSY_POLL_USEC")) {
+        config.socket_busy_poll_usec = std::atoi(usec);
+    }
+    return config;
+}
+
+// Seat held by the calling thread (-1: none)
+static thread_local int spinner_seat = -1;
+
+BusyPoll::BusyPoll() {
+    configure(BusyPollConfig::fromEnvironment());
+}
+
+BusyPoll& BusyPoll::instance() {
+    static BusyPoll busy_poll;
+    return busy_poll;
+}
+
+void BusyPoll::configure(const BusyPollConfig& new_config) {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    config = new_config;
+    enabled_flag = config.enabled;
+
+    // Seats already held keep spinning; only new claims see the new count
+    size_t seats = config.cpus.empty() ? std::max(1u, std::thread::hardware_concurrency()) : config.cpus.size();
+    seats_taken.assign(seats, false);
+
+    if (config.enabled) {
+        std::cout << "🏎️ Busy-poll serving mode: " << config.cpus.size() << " dedicated cores, SO_BUSY_POLL "
+                  << config.socket_busy_poll_usec << "µs" << std::endl;
+        if (config.cpus.empty()) {
+            std::cerr << "⚠️ BUSY_POLL without BUSY_POLL_CPUS: up to " << seats
+                      << " spinning threads, not pinned" << std::endl;
+        }
+    }
+}
+
+BusyPollConfig BusyPoll::getConfig() const {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    return config;
+}
+
+bool BusyPoll::claimSpinner(const char* role) {
+    if (spinner_seat >= 0) return true;
+
+    int cpu = -1;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        if (!config.enabled) return false;
+        auto free_seat = std::find(seats_taken.begin(), seats_taken.end(), false);
+        if (free_seat == seats_taken.end()) {
+            parked_threads++;
+            return false;
+        }
+        *free_seat = true;
+        spinner_seat = static_cast<int>(free_seat - seats_taken.begin());
+        if (!config.cpus.empty()) cpu = config.cpus[spinner_seat];
+    }
+    spinning_threads++;
+    if (cpu < 0) return true;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        pin_failures++;
+        std::cerr << "⚠️ Cannot pin " << role << " thread to CPU " << cpu << ": " << std::strerror(rc) << std::endl;
+        return true;  // Still holds the seat, so the spinner count stays bounded
+    }
+    pinned_threads++;
+#else
+    // No thread affinity API here (macOS only has affinity hints)
+    (void)role;
+    pin_failures++;
+#endif
+    return true;
+}
+
+void BusyPoll::releaseSpinner() {
+    if (spinner_seat < 0) return;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        if (static_cast<size_t>(spinner_seat) < seats_taken.size()) {
+            seats_taken[spinner_seat] = false;
+        }
+    }
+    spinner_seat = -1;
+    spinning_threads--;
+}
+
+bool BusyPoll::isSpinner() {
+    return spinner_seat >= 0;
+}
+
+bool BusyPoll::applySocketOptions(int fd) {
+    int usec = 0;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        if (!config.enabled) return false;
+        usec = config.socket_busy_poll_usec;
+    }
+    if (usec <= 0) return false;
+
+#ifdef __linux__
+    // Needs CAP_NET_ADMIN to raise above net.core.busy_read
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)) != 0) {
+        std::cerr << "⚠️ SO_BUSY_POLL failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int prefer = 1;
+    setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));  // Linux 5.11+, best effort
+    busy_poll_sockets++;
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+BusyPollStats BusyPoll::getStats() const {
+    BusyPollStats stats;
+    stats.enabled = enabled();
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        stats.seats = static_cast<int>(seats_taken.size());
+    }
+    stats.spinning_threads = spinning_threads.load();
+    stats.parked_threads = parked_threads.load();
+    stats.pinned_threads = pinned_threads.load();
+    stats.pin_failures = pin_failures.load();
+    stats.busy_poll_sockets = busy_poll_sockets.load();
+    return stats;
+}
+
+void BusyPoll::printStats() const {
+    BusyPollStats stats = getStats();
+    std::cout << "\n🏎️ Busy-poll: " << (stats.enabled ? "on" : "off") << ", " << stats.spinning_threads << "/"
+              << stats.seats << " threads spinning (" << stats.parked_threads << " parked), "
+              << stats.pinned_threads << " pinned (" << stats.pin_failures << " failed), "
+              << stats.busy_poll_sockets << " busy-poll sockets" << std::endl;
+}
@@ -0,0 +1,194 @@
+#ifndef BUSY_POLL_H
+#define BUSY_POLL_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Opt-in serving mode for latency-critical lines: worker threads are pinned
+// to dedicated (ideally isolcpus/nohz_full) cores and spin on their queues
+// instead of parking on condition variables, result waits spin instead of
+// sleeping in future.get(), and server sockets get SO_BUSY_POLL. Trades
+// whole cores for the wake-up latency in the tail. Off by default.
+//
+// Every core is one spinner seat. A thread spins only while it holds a seat
+// (SpinnerSeat); once all seats are taken, further pool threads park as
+// usual, so spinners never outnumber the cores they were given.
+struct BusyPollConfig {
+    bool enabled = false;
+    std::vector<int> cpus;           // One spinning thread each (empty: hardware_concurrency() unpinned spinners)
+    int socket_busy_poll_usec = 50;  // SO_BUSY_POLL on server sockets (0: leave the socket alone)
+
+    // BUSY_POLL=1, BUSY_POLL_CPUS=2-7,10, BUSY_POLL_USEC=50
+    static BusyPollConfig fromEnvironment();
+
+    // "2-5,8" -> {2, 3, 4, 5, 8}
+    static std::vector<int> parseCpuList(const std::string& list);
+};
+
+struct BusyPollStats {
+    bool enabled = false;
+    int seats = 0;             // Spinning threads allowed at once
+    int spinning_threads = 0;  // Seats currently held
+    int parked_threads = 0;    // Pool threads that found no free seat
+    int pinned_threads = 0;
+    int pin_failures = 0;
+    int busy_poll_sockets = 0;
+};
+
+class BusyPoll {
+private:
+    BusyPollConfig config;
+    std::vector<bool> seats_taken;  // One per configured core; guarded by config_mutex
+    std::atomic<bool> enabled_flag{false};
+    std::atomic<int> spinning_threads{0};
+    std::atomic<int> parked_threads{0};
+    std::atomic<int> pinned_threads{0};
+    std::atomic<int> pin_failures{0};
+    std::atomic<int> busy_poll_sockets{0};
+    mutable std::mutex config_mutex;
+
+    BusyPoll();
+
+public:
+    static BusyPoll& instance();
+
+    // Pools pick their mode when their threads start, so configure first
+    void configure(const BusyPollConfig& new_config);
+    BusyPollConfig getConfig() const;
+
+    bool enabled() const { return enabled_flag.load(std::memory_order_relaxed); }
+
+    // Take a free seat for the calling thread and pin it to the seat's core.
+    // False when busy-poll is off or every seat is held: the thread parks.
+    bool claimSpinner(const char* role);
+    void releaseSpinner();     // Gives back the calling thread's seat, if any
+    static bool isSpinner();   // The calling thread holds a seat
+
+    // SO_BUSY_POLL (and SO_PREFER_BUSY_POLL where available) on `fd`
+    bool applySocketOptions(int fd);
+
+    BusyPollStats getStats() const;
+    void printStats() const;
+
+    static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // Wait for a future: spinning on a seat holder, parked otherwise
+    template <typename T>
+    static void wait(const std::future<T>& future) {
+        if (isSpinner()) {
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) cpuRelax();
+        } else {
+            future.wait();
+        }
+    }
+
+    template <typename T>
+    static T get(std::future<T>& future) {
+        wait(future);
+        return future.get();
+    }
+};
+
+// Seat for the lifetime of a pool thread: claimed on construction, released
+// on destruction
+class SpinnerSeat {
+private:
+    bool claimed;
+
+public:
+    explicit SpinnerSeat(const char* role) : claimed(BusyPoll::instance().claimSpinner(role)) {}
+    ~SpinnerSeat() {
+        if (claimed) BusyPoll::instance().releaseSpinner();
+    }
+    SpinnerSeat(const SpinnerSeat&) = delete;
+    SpinnerSeat& operator=(const SpinnerSeat&) = delete;
+
+    bool spinning() const { return claimed; }
+};
+
+// Task queue of a pool in busy-poll mode (pools pick their mode when they
+// are built). Spinning workers poll `queued` without taking the lock, so an idle
+// spinning pool never touches the mutex or the futex. Workers without a seat
+// park on a condition variable, which push() only signals while one waits.
+class SpinTaskQueue {
+private:
+    std::deque<std::function<void()>> tasks;
+    std::mutex tasks_mutex;
+    std::condition_variable task_ready;
+    int parked = 0;  // Guarded by tasks_mutex
+    std::atomic<size_t> queued{0};
+    std::atomic<bool> stopping{false};
+
+public:
+    void push(std::function<void()> task) {
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            tasks.push_back(std::move(task));
+            queued.fetch_add(1, std::memory_order_release);
+            wake = parked > 0;
+        }
+        if (wake) task_ready.notify_one();
+    }
+
+    // Wait until a task is available, spinning or parked; false once
+    // stopped and drained
+    bool pop(std::function<void()>& task, bool spin = true) {
+        if (!spin) {
+            std::unique_lock<std::mutex> lock(tasks_mutex);
+            parked++;
+            task_ready.wait(lock, [this] { return !tasks.empty() || stopping.load(std::memory_order_acquire); });
+            parked--;
+            if (tasks.empty()) return false;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        while (true) {
+            while (queued.load(std::memory_order_acquire) == 0) {
+                if (stopping.load(std::memory_order_acquire)) return false;
+                BusyPoll::cpuRelax();
+            }
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            if (tasks.empty()) continue;  // Another worker took it
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            stopping.store(true, std::memory_order_release);
+        }
+        task_ready.notify_all();
+    }
+    void resume() { stopping.store(false, std::memory_order_release); }
+    size_t size() const { return queued.load(std::memory_order_relaxed); }
+};
+
+#endif // BUSY_POLL_H
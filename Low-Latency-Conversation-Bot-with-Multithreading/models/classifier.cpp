@@ -1,14 +1,12 @@
 #include "classifier.h"
+#include "busy_poll.h"
 #include <algorithm>
 #include <iomanip>
 
 // SVM Model Implementation
-SVMModel::SVMModel(const std::string& model_path) : env{ORT_LOGGING_LEVEL_WARNING, "SVMModel"} {
-    Ort::SessionOptions session_options;
-    session_options.SetIntraOpNumThreads(1);
-    
+SVMModel::SVMModel(const std::string& model_path) {
     try {
-        session = std::make_unique<Ort::Session>(env, model_path.c_str(), session_options);
+        session = OrtRuntime::instance().createSession(model_path, "svm:" + model_path, runtime_model_id);
         
         // Debug: Print input/output names
         std::cout << "  Input names: ";
@@ -28,21 +26,44 @@ SVMModel::SVMModel(const std::string& model_path) : env{ORT_LOGGING_LEVEL_WARNIN
     }
 }
 
-float SVMModel::predict(const std::string& text) {
+SVMModel::~SVMModel() {
+    session.reset();
+    OrtRuntime::instance().releaseModel(runtime_model_id);
+}
+
+size_t SVMModel::getSessionBytes() const {
+    return OrtRuntime::instance().getModelStats(runtime_model_id).load_rss_bytes;
+}
+
+float SVMModel::predict(const std::string& text, bool* failed) {
+    std::vector<bool> row_failed;
+    float probability = predictBatch({text}, &row_failed)[0];
+    if (failed) *failed = row_failed[0];
+    return probability;
+}
+
+std::vector<float> SVMModel::predictBatch(const std::vector<std::string>& texts, std::vector<bool>* failed) {
+    std::vector<float> probabilities(texts.size(), 0.0f);
+    if (failed) failed->assign(texts.size(), false);
+    if (texts.empty()) {
+        return probabilities;
+    }
+    
     try {
-        // Create string tensor for input
-        std::vector<std::string> input_strings = {text};
-        
         auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
         
-        // Convert to char pointers
+        // Same text the vectorizer saw in training (lower() + whitespace split)
+        NormalizerOptions options;
+        std::vector<std::string> normalized(texts.size());
         std::vector<const char*> raw_strings;
-        for (const auto& str : input_strings) {
-            raw_strings.push_back(str.c_str());
+        raw_strings.reserve(texts.size());
+        for (size_t i = 0; i < texts.size(); i++) {
+            TextNormalizer::normalizeText(texts[i], options, normalized[i]);
+            raw_strings.push_back(normalized[i].c_str());
         }
         
         // Shape for string tensor
-        std::vector<int64_t> input_shape = {static_cast<int64_t>(input_strings.size())};
+        std::vector<int64_t> input_shape = {static_cast<int64_t>(texts.size())};
         
         // Create string tensor
         auto input_tensor = Ort::Value::CreateTensor(
@@ -58,8 +79,9 @@ float SVMModel::predict(const std::string& text) {
         const char* input_names[] = {"text_input"};
         const char* output_names[] = {"output_probability"};
         
+        OrtRuntime::RunScope run_scope(OrtRuntime::instance(), runtime_model_id);
         auto output_tensors = session->Run(
-            Ort::RunOptions{nullptr}, 
+            run_scope.options(), 
             input_names, &input_tensor, 1,
             output_names, 1
         );
@@ -69,17 +91,33 @@ float SVMModel::predict(const std::string& text) {
         
         auto shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
         
-        // Return probability of class 1 (entity present)
-        if (shape.size() > 0 && shape[shape.size()-1] > 1) {
-            return output_data[1]; // Return probability of class 1
-        } else {
-            return output_data[0]; // Fallback to first value
+        // Return probability of class 1 (entity present) for each row
+        size_t num_classes = shape.size() > 1 ? static_cast<size_t>(shape[shape.size()-1]) : 1;
+        for (size_t i = 0; i < texts.size(); i++) {
+            if (num_classes > 1) {
+                probabilities[i] = output_data[i * num_classes + 1]; // Probability of class 1
+            } else {
+                probabilities[i] = output_data[i]; // Fallback to first value
+            }
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "SVM prediction error: " << e.what() << std::endl;
-        return 0.0f;
+        if (texts.size() == 1) {
+            std::cerr << "SVM prediction error: " << e.what() << std::endl;
+            if (failed) (*failed)[0] = true;
+            return probabilities;
+        }
+        
+        // Retry row by row so one bad row does not take the batch with it
+        std::cerr << "SVM batch prediction error, retrying " << texts.size() << " rows singly: " << e.what() << std::endl;
+        for (size_t i = 0; i < texts.size(); i++) {
+            std::vector<bool> row_failed;
+            probabilities[i] = predictBatch({texts[i]}, &row_failed)[0];
+            if (failed) (*failed)[i] = row_failed[0];
+        }
     }
+    
+    return probabilities;
 }
 
 // Classification Crew Implementation
@@ -98,47 +136,195 @@ void ClassificationCrew::loadSVMModels(const std::string& models_dir) {
     std::cout << "🔄 Loading SVM Classification Models..." << std::endl;
     
     for (const auto& entity : entity_types) {
-        std::string model_path = models_dir + "/" + entity + "_svm.onnx";
+        std::string model_path = modelVariantPath(models_dir, entity, "svm", ModelPrecision::FP32);
         
         try {
-            svm_models[entity] = std::make_unique<SVMModel>(model_path);
+            svm_models[entity].fp32 = std::make_unique<SVMModel>(model_path);
             std::cout << "✅ Loaded SVM classifier for " << entity << std::endl;
         } catch (const std::exception& e) {
             std::cerr << "❌ Failed to load SVM classifier for " << entity << ": " << e.what() << std::endl;
         }
+        
+        // Optional INT8 variants, each in its own slot
+        for (ModelPrecision precision : {ModelPrecision::INT8_DYNAMIC, ModelPrecision::INT8_STATIC}) {
+            std::string int8_path = modelVariantPath(models_dir, entity, "svm", precision);
+            if (!modelFileExists(int8_path)) continue;
+            
+            try {
+                auto model = std::make_unique<SVMModel>(int8_path);
+                SVMModelSet& model_set = svm_models[entity];
+                (precision == ModelPrecision::INT8_DYNAMIC ? model_set.int8_dynamic : model_set.int8_static) = std::move(model);
+                std::cout << "✅ Loaded " << modelPrecisionName(precision) << " SVM classifier for " << entity << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Failed to load " << modelPrecisionName(precision) << " SVM classifier for " 
+                          << entity << ": " << e.what() << std::endl;
+            }
+        }
     }
+    
+    invalidateCache();
+}
+
+bool ClassificationCrew::setModelPrecision(const std::string& entity_type, ModelPrecision precision) {
+    auto it = svm_models.find(entity_type);
+    if (it == svm_models.end()) {
+        return false;
+    }
+    
+    if (isQuantized(precision) && !it->second.variant(precision)) {
+        std::cerr << "⚠️ No " << modelPrecisionName(precision) << " SVM model for " << entity_type 
+                  << ", keeping " << modelPrecisionName(getModelPrecision(entity_type)) << std::endl;
+        return false;
+    }
+    
+    if (it->second.selected.exchange(precision) != precision) invalidateCache();
+    return true;
+}
+
+ModelPrecision ClassificationCrew::getModelPrecision(const std::string& entity_type) const {
+    auto it = svm_models.find(entity_type);
+    if (it == svm_models.end()) {
+        return ModelPrecision::FP32;
+    }
+    return it->second.selected;
+}
+
+SVMModel* ClassificationCrew::getModel(const std::string& entity_type, ModelPrecision precision) const {
+    auto it = svm_models.find(entity_type);
+    if (it == svm_models.end()) {
+        return nullptr;
+    }
+    return it->second.variant(precision);
+}
+
+ClassificationResult ClassificationCrew::classifyEntity(const std::string& sentence, const std::string& entity_type) {
+    ClassificationResult result(entity_type);
+    
+    try {
+        auto it = svm_models.find(entity_type);
+        SVMModel* model = (it != svm_models.end()) ? it->second.active() : nullptr;
+        if (model) {
+            bool failed = false;
+            float confidence = model->predict(sentence, &failed);
+            result.failed = failed;
+            result.confidence = confidence;
+            result.detected = !failed && (confidence >= confidence_threshold);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error classifying " << entity_type << ": " << e.what() << std::endl;
+        result.failed = true;
+    }
+    
+    return result;
 }
 
 std::future<ClassificationResult> ClassificationCrew::classifyEntityAsync(const std::string& sentence, const std::string& entity_type) {
     return std::async(std::launch::async, [this, sentence, entity_type]() {
-        ClassificationResult result(entity_type);
-        
-        try {
-            if (svm_models.find(entity_type) != svm_models.end()) {
-                float confidence = svm_models[entity_type]->predict(sentence);
-                result.confidence = confidence;
-                result.detected = (confidence >= confidence_threshold);
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "Error classifying " << entity_type << ": " << e.what() << std::endl;
-        }
-        
-        return result;
+        return classifyEntity(sentence, entity_type);
     });
 }
 
+bool ClassificationCrew::getCachedResults(const std::string& input_sentence, std::vector<ClassificationResult>& results) {
+    std::string cache_key;
+    if (!cache_enabled || !normalizeUtteranceKey(input_sentence, true, cache_key)) {
+        return false;
+    }
+    
+    if (!classification_cache.get(hashUtteranceKey(cache_key, model_version), cache_key, results)) {
+        return false;
+    }
+    
+    for (auto& result : results) {
+        result.detected = (result.confidence >= confidence_threshold);
+    }
+    return true;
+}
+
+void ClassificationCrew::cacheResults(const std::string& input_sentence, const std::vector<ClassificationResult>& results) {
+    // A failed run is not a negative; the next repeat should run the model again
+    for (const auto& result : results) {
+        if (result.failed) return;
+    }
+    
+    std::string cache_key;
+    if (cache_enabled && normalizeUtteranceKey(input_sentence, true, cache_key)) {
+        classification_cache.put(hashUtteranceKey(cache_key, model_version), cache_key, results);
+    }
+}
+
 std::vector<ClassificationResult> ClassificationCrew::classifyAllEntities(const std::string& input_sentence) {
+    // Repeat utterances are answered from the cache
+    std::vector<ClassificationResult> results;
+    if (getCachedResults(input_sentence, results)) {
+        return results;
+    }
+    
+    std::vector<std::string> candidates = getCandidateEntities(input_sentence);
     std::vector<std::future<ClassificationResult>> futures;
     
-    // Launch async classification for all entities
-    for (const auto& entity : entity_types) {
+    // Launch async classification for the entities that survived the pre-filter
+    for (const auto& entity : candidates) {
         futures.push_back(classifyEntityAsync(input_sentence, entity));
     }
     
-    // Collect results
-    std::vector<ClassificationResult> results;
-    for (auto& future : futures) {
-        results.push_back(future.get());
+    // Collect results in entity order; skipped heads report not detected
+    size_t next_future = 0;
+    for (const auto& entity : entity_types) {
+        if (next_future < candidates.size() && candidates[next_future] == entity) {
+            results.push_back(BusyPoll::get(futures[next_future++]));
+        } else {
+            ClassificationResult skipped(entity);
+            skipped.prefiltered = true;
+            results.push_back(skipped);
+        }
+    }
+    
+    cacheResults(input_sentence, results);
+    
+    return results;
+}
+
+std::vector<std::vector<ClassificationResult>> ClassificationCrew::classifyBatch(const std::vector<std::string>& sentences) {
+    std::vector<std::vector<ClassificationResult>> results(sentences.size());
+    
+    std::vector<LexicalFeatures> features;
+    if (prefilter_enabled) {
+        features.reserve(sentences.size());
+        for (const auto& sentence : sentences) {
+            features.push_back(LexicalPrefilter::scan(sentence));
+        }
+    }
+    
+    for (const auto& entity : entity_types) {
+        auto it = svm_models.find(entity);
+        SVMModel* model = (it != svm_models.end()) ? it->second.active() : nullptr;
+        
+        // Only the sentences this head can fire on go into the forward pass
+        std::vector<size_t> admitted;
+        std::vector<std::string> admitted_sentences;
+        for (size_t i = 0; i < sentences.size(); i++) {
+            if (features.empty() || prefilter.admit(features[i], entity)) {
+                admitted.push_back(i);
+                admitted_sentences.push_back(sentences[i]);
+            }
+        }
+        
+        std::vector<bool> failed(admitted_sentences.size(), false);
+        std::vector<float> confidences = model ? model->predictBatch(admitted_sentences, &failed) 
+                                               : std::vector<float>(admitted_sentences.size(), 0.0f);
+        
+        size_t next_admitted = 0;
+        for (size_t i = 0; i < sentences.size(); i++) {
+            ClassificationResult result(entity);
+            if (next_admitted < admitted.size() && admitted[next_admitted] == i) {
+                result.failed = failed[next_admitted];
+                result.confidence = confidences[next_admitted++];
+                result.detected = (result.confidence >= confidence_threshold);
+            } else {
+                result.prefiltered = true;
+            }
+            results[i].push_back(result);
+        }
     }
     
     return results;
@@ -157,6 +343,84 @@ std::vector<std::string> ClassificationCrew::getDetectedEntities(const std::stri
     return detected_entities;
 }
 
+void ClassificationCrew::invalidateCache() {
+    model_version++;
+    classification_cache.clear();
+}
+
+void ClassificationCrew::setCacheEnabled(bool enabled) {
+    cache_enabled = enabled;
+}
+
+void ClassificationCrew::clearCache() {
+    classification_cache.clear();
+}
+
+CacheStats ClassificationCrew::getCacheStats() const {
+    return classification_cache.stats();
+}
+
+void ClassificationCrew::reportMemory(MemoryReport& report) const {
+    size_t session_bytes = 0;
+    size_t sessions = 0;
+    for (const auto& [entity, model_set] : svm_models) {
+        for (const SVMModel* model : {model_set.fp32.get(), model_set.int8_dynamic.get(), model_set.int8_static.get()}) {
+            if (!model) continue;
+            session_bytes += model->getSessionBytes();
+            sessions++;
+        }
+    }
+    report.add("classifier.svm_sessions", session_bytes, sessions);
+    report.add("classifier.result_cache", classification_cache.memoryBytes(), classification_cache.size());
+}
+
+uint64_t ClassificationCrew::getModelVersion() const {
+    return model_version.load();
+}
+
+const std::vector<std::string>& ClassificationCrew::getEntityTypes() const {
+    return entity_types;
+}
+
+std::vector<std::string> ClassificationCrew::getCandidateEntities(const std::string& input_sentence) {
+    if (!prefilter_enabled) {
+        return entity_types;
+    }
+    
+    LexicalFeatures features = LexicalPrefilter::scan(input_sentence);
+    std::vector<std::string> candidates;
+    for (const auto& entity : entity_types) {
+        if (prefilter.admit(features, entity)) {
+            candidates.push_back(entity);
+        }
+    }
+    return candidates;
+}
+
+// Gate changes alter results, so cached entries are dropped like on a model change
+void ClassificationCrew::setPrefilterEnabled(bool enabled) {
+    if (prefilter_enabled.exchange(enabled) != enabled) {
+        invalidateCache();
+    }
+}
+
+bool ClassificationCrew::setPrefilterGate(const std::string& entity_type, const EntityGate& gate) {
+    if (!prefilter.setGate(entity_type, gate)) {
+        std::cerr << "⚠️ No pre-filter gate for " << entity_type << std::endl;
+        return false;
+    }
+    invalidateCache();
+    return true;
+}
+
+EntityGate ClassificationCrew::getPrefilterGate(const std::string& entity_type) const {
+    return prefilter.getGate(entity_type);
+}
+
+std::unordered_map<std::string, PrefilterEntityStats> ClassificationCrew::getPrefilterStats() const {
+    return prefilter.getStats();
+}
+
 void ClassificationCrew::setConfidenceThreshold(float threshold) {
     confidence_threshold = threshold;
 }
@@ -170,6 +434,8 @@ void ClassificationCrew::printClassificationResults(const std::vector<Classifica
         
         if (result.detected) {
             std::cout << "✅ DETECTED ";
+        } else if (result.prefiltered) {
+            std::cout << "⏭️ SKIPPED ";
         } else {
             std::cout << "❌ NOT DETECTED ";
         }
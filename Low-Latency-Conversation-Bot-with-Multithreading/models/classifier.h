@@ -8,6 +8,12 @@
 #include <memory>
 #include <future>
 #include <fstream>
+#include <atomic>
+
+#include "model_precision.h"
+#include "ort_runtime.h"
+#include "result_cache.h"
+#include "lexical_prefilter.h"
 
 // ONNX Runtime
 #include <onnxruntime/onnxruntime_cxx_api.h>
@@ -17,44 +23,125 @@ struct ClassificationResult {
     std::string entity_name;
     float confidence;
     bool detected;
+    bool prefiltered;  // Head skipped by the lexical pre-filter (never ran)
+    bool failed;       // The model run failed; confidence is not a verdict
     
     ClassificationResult(const std::string& name) 
-        : entity_name(name), confidence(0.0f), detected(false) {}
+        : entity_name(name), confidence(0.0f), detected(false), prefiltered(false), failed(false) {}
 };
 
+inline size_t heapBytes(const ClassificationResult& result) {
+    return heapBytes(result.entity_name);
+}
+
 // SVM Model wrapper (handles TF-IDF pipelines)
 class SVMModel {
 private:
-    std::unique_ptr<Ort::Session> session;
-    Ort::Env env;
+    std::unique_ptr<Ort::Session> session;  // Shares OrtRuntime's env and arena
+    size_t runtime_model_id = 0;
     
 public:
     SVMModel(const std::string& model_path);
-    float predict(const std::string& text);
+    ~SVMModel();
+    float predict(const std::string& text, bool* failed = nullptr);  // *failed: the run failed, 0 is not a score
+    
+    // One forward pass over a batch of sentences (probability of class 1 per sentence).
+    // A failed pass is retried row by row; rows that still fail score 0 and
+    // are flagged in `failed` when given.
+    std::vector<float> predictBatch(const std::vector<std::string>& texts, std::vector<bool>* failed = nullptr);
+    
+    // RSS growth measured while the ORT session was created
+    size_t getSessionBytes() const;
+};
+
+// FP32 model plus the optional INT8 variants, loaded side by side
+struct SVMModelSet {
+    std::unique_ptr<SVMModel> fp32;
+    std::unique_ptr<SVMModel> int8_dynamic;
+    std::unique_ptr<SVMModel> int8_static;
+    std::atomic<ModelPrecision> selected{ModelPrecision::FP32};  // Per entity, switchable at runtime
+    
+    SVMModel* variant(ModelPrecision precision) const {
+        switch (precision) {
+            case ModelPrecision::INT8_DYNAMIC: return int8_dynamic.get();
+            case ModelPrecision::INT8_STATIC: return int8_static.get();
+            default: return fp32.get();
+        }
+    }
+    SVMModel* active() const { return variant(selected); }
 };
 
 // Classification Crew - handles entity detection
 class ClassificationCrew {
 private:
-    std::unordered_map<std::string, std::unique_ptr<SVMModel>> svm_models;
+    std::unordered_map<std::string, SVMModelSet> svm_models;
     float confidence_threshold;
     std::vector<std::string> entity_types;
     
+    // Repeat-utterance cache keyed by normalized sentence + model version.
+    // Stores confidences; detection re-applies the current threshold on a hit.
+    ShardedResultCache<std::vector<ClassificationResult>> classification_cache;
+    std::atomic<uint64_t> model_version{0};
+    std::atomic<bool> cache_enabled{true};
+    
+    // Lexical cascade stage: heads that cannot fire are not run
+    LexicalPrefilter prefilter;
+    std::atomic<bool> prefilter_enabled{true};
+    
+    void invalidateCache();
+    
 public:
     ClassificationCrew(const std::string& svm_models_dir, float threshold = 0.7f);
     
     // Load all SVM models
     void loadSVMModels(const std::string& models_dir);
     
+    // Classify single entity on the calling thread
+    ClassificationResult classifyEntity(const std::string& sentence, const std::string& entity_type);
+    
     // Classify single entity async
     std::future<ClassificationResult> classifyEntityAsync(const std::string& sentence, const std::string& entity_type);
     
     // Classify all entities in parallel
     std::vector<ClassificationResult> classifyAllEntities(const std::string& input_sentence);
     
+    // Cache access for callers that schedule classifyEntity() themselves; a
+    // result set with a failed row is not cached
+    bool getCachedResults(const std::string& input_sentence, std::vector<ClassificationResult>& results);
+    void cacheResults(const std::string& input_sentence, const std::vector<ClassificationResult>& results);
+    const std::vector<std::string>& getEntityTypes() const;
+    
+    // Entity heads the pre-filter lets through for this sentence (all of
+    // them when the pre-filter is disabled); records skip statistics
+    std::vector<std::string> getCandidateEntities(const std::string& input_sentence);
+    
+    // Classify a batch of sentences with one forward pass per entity model
+    // (offline/bulk use; results[i] belongs to sentences[i])
+    std::vector<std::vector<ClassificationResult>> classifyBatch(const std::vector<std::string>& sentences);
+    
     // Get detected entities (above threshold)
     std::vector<std::string> getDetectedEntities(const std::string& input_sentence);
     
+    // Precision selection (falls back to FP32 if the INT8 variant is not on disk)
+    bool setModelPrecision(const std::string& entity_type, ModelPrecision precision);
+    ModelPrecision getModelPrecision(const std::string& entity_type) const;
+    SVMModel* getModel(const std::string& entity_type, ModelPrecision precision) const;
+    
+    // Result cache
+    void setCacheEnabled(bool enabled);
+    void clearCache();
+    CacheStats getCacheStats() const;
+    uint64_t getModelVersion() const;
+    
+    // Lexical pre-filter
+    void setPrefilterEnabled(bool enabled);
+    bool setPrefilterGate(const std::string& entity_type, const EntityGate& gate);
+    EntityGate getPrefilterGate(const std::string& entity_type) const;
+    std::unordered_map<std::string, PrefilterEntityStats> getPrefilterStats() const;
+    
+    // Memory accounting: loaded sessions and the result cache
+    void reportMemory(MemoryReport& report) const;
+    
     void setConfidenceThreshold(float threshold);
     void printClassificationResults(const std::vector<ClassificationResult>& results);
 };
@@ -5,39 +5,22 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <ctime>
 #include <regex>
 
-// AppointmentSummary Implementation
-std::string AppointmentSummary::toString() const {
-    std::stringstream ss;
-    ss << "Appointment Summary:\n"
-       << "  Customer: " << customer_name << "\n"
-       << "  Phone: " << customer_phone << "\n"
-       << "  Service: " << service_requested << "\n"
-       << "  Preferred Day: " << preferred_day << "\n"
-       << "  Preferred Time: " << preferred_time << "\n"
-       << "  Status: " << status << "\n"
-       << "  Booked: " << booking_timestamp;
-    return ss.str();
-}
-
-std::string AppointmentSummary::toJSON() const {
-    std::stringstream ss;
-    ss << "{\n"
-       << "  \"customer_name\": \"" << customer_name << "\",\n"
-       << "  \"customer_phone\": \"" << customer_phone << "\",\n"
-       << "  \"service_requested\": \"" << service_requested << "\",\n"
-       << "  \"preferred_day\": \"" << preferred_day << "\",\n"
-       << "  \"preferred_time\": \"" << preferred_time << "\",\n"
-       << "  \"status\": \"" << status << "\",\n"
-       << "  \"booking_timestamp\": \"" << booking_timestamp << "\"\n"
-       << "}";
-    return ss.str();
+// 0 = Monday .. 6 = Sunday, for "today" / "tomorrow"
+static int currentWeekday() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    return (local.tm_wday + 6) % 7;
 }
 
 // CloserCrew Implementation
-CloserCrew::CloserCrew(std::unique_ptr<LLMInterface> llm) 
-    : llm_interface(std::move(llm)), confidence_threshold(0.8f), max_retries(2) {
+CloserCrew::CloserCrew(std::shared_ptr<LLMInterface> llm) 
+    : llm_interface(std::move(llm)), llm_health(LLMCircuitBreaker::attach(llm_interface)),
+      confidence_threshold(0.8f), max_retries(2),
+      quality_scorer(QualityAssessment::shared().scorer), quality_assessor(QualityAssessment::shared().assessor) {
     
     std::cout << "🎯 Closer Crew initialized" << std::endl;
     initializeTemplates();
@@ -106,16 +89,22 @@ ClosingResult CloserCrew::generateClosing(const ClosingRequest& request) {
     
     ClosingResult result;
     
-    // Try LLM first
-    if (llm_interface && llm_interface->isAvailable()) {
-        result = generateWithLLM(request);
+    // Try LLM first; the prompt (and its CompositionRequest view) is built
+    // once and reused by every attempt. Skipped while the breaker is open.
+    CircuitAdmission admission;
+    if (llm_health && (admission = llm_health->allowRequest())) {
+        CompositionRequest as_composition({}, request.complete_entities, request.conversation_summary);
+        as_composition.session_key = request.session_key;
+        as_composition.history_length = request.history_length;
+        LLMPrompt prompt = prompt_builder.buildClosing(request, as_composition);
+        result = generateWithLLM(prompt, admission);
         
         // Quality check and potential retry
         if (result.is_valid && result.confidence_score < confidence_threshold) {
             std::cout << "  📊 Confidence too low (" << result.confidence_score << "), retrying..." << std::endl;
             
-            for (int retry = 0; retry < max_retries; ++retry) {
-                auto retry_result = generateWithLLM(request);
+            for (int retry = 0; retry < max_retries && (admission = llm_health->allowRequest()); ++retry) {
+                auto retry_result = generateWithLLM(prompt, admission);
                 if (retry_result.confidence_score > result.confidence_score) {
                     result = retry_result;
                     break;
@@ -143,20 +132,24 @@ ClosingResult CloserCrew::generateClosing(const ClosingRequest& request) {
     return result;
 }
 
-ClosingResult CloserCrew::generateWithLLM(const ClosingRequest& request) {
+ClosingResult CloserCrew::generateWithLLM(const LLMPrompt& prompt, const CircuitAdmission& admission) {
     ClosingResult result;
+    auto start = std::chrono::steady_clock::now();
     
     try {
         // Generate closing using LLM
-        std::string closing = llm_interface->generateQuestion(CompositionRequest({}, request.complete_entities));  // Convert to CompositionRequest
+        std::string closing = llm_interface->complete(prompt);
         
         if (!closing.empty()) {
             result.closing_message = closing;
             result.generation_method = "llm_primary";
             
-            // Assess quality (reusing quality assessment)
-            result.confidence_score = llm_interface->assessQuestionQuality(closing, 
-                CompositionRequest({}, request.complete_entities));  // Convert to composition request
+            // Assess quality: locally unless configured to ask the LLM
+            if (quality_assessor == QualityAssessor::LOCAL) {
+                result.confidence_score = quality_scorer->scoreClosing(closing, *prompt.request);
+            } else {
+                result.confidence_score = llm_interface->assessQuestionQuality(closing, *prompt.request);
+            }
             result.is_valid = true;
         }
         
@@ -165,6 +158,9 @@ ClosingResult CloserCrew::generateWithLLM(const ClosingRequest& request) {
         result.is_valid = false;
     }
     
+    llm_health->recordResult(admission, result.is_valid,
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    
     return result;
 }
 
@@ -209,6 +205,7 @@ AppointmentSummary CloserCrew::createAppointmentSummary(const ClosingRequest& re
     summary.preferred_day = entities.count("day_preference") ? entities["day_preference"] : "Unknown";
     summary.preferred_time = entities.count("time_preference") ? entities["time_preference"] : "Unknown";
     summary.service_requested = entities.count("service_type") ? entities["service_type"] : "Unknown";
+    summary.stylist = entities.count("stylist") ? entities["stylist"] : "";
     
     // Add metadata
     auto now = std::chrono::system_clock::now();
@@ -217,7 +214,9 @@ AppointmentSummary CloserCrew::createAppointmentSummary(const ClosingRequest& re
     ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
     summary.booking_timestamp = ss.str();
     
-    summary.status = needsFollowup(request) ? "pending" : "confirmed";
+    // Parsed once here; the manager's conflict checks compare these ranges
+    summary.slot = TimeSlotParser::parse(summary.preferred_day, summary.preferred_time, currentWeekday());
+    summary.status = summary.slot.exact ? "confirmed" : "pending";
     
     return summary;
 }
@@ -333,20 +332,15 @@ std::vector<std::string> CloserCrew::generateNextSteps(const ClosingRequest& req
 }
 
 bool CloserCrew::needsFollowup(const ClosingRequest& request) {
-    // Simple logic: if time is too vague or conflicts might exist
-    auto entities = request.complete_entities;
+    // Only a day and time that resolve to one exact slot ("Friday", "2 PM")
+    // skip the callback; periods, ranges and unreadable text need one
+    const auto& entities = request.complete_entities;
+    auto time = entities.find("time_preference");
+    if (time == entities.end()) return true;
     
-    if (entities.count("time_preference") == 0) return true;
-    
-    std::string time = entities["time_preference"];
-    // If time is vague (morning, afternoon, etc.) rather than specific
-    if (time.find("morning") != std::string::npos || 
-        time.find("afternoon") != std::string::npos ||
-        time.find("evening") != std::string::npos) {
-        return true;
-    }
-    
-    return false;
+    auto day = entities.find("day_preference");
+    std::string_view day_text = day != entities.end() ? std::string_view(day->second) : std::string_view();
+    return !TimeSlotParser::parse(day_text, time->second, currentWeekday()).exact;
 }
 
 bool CloserCrew::isValidPhoneNumber(const std::string& phone) {
@@ -360,11 +354,8 @@ bool CloserCrew::isValidName(const std::string& name) {
 }
 
 bool CloserCrew::isValidTimeSlot(const std::string& day, const std::string& time) {
-    // Basic validation
-    std::vector<std::string> valid_days = {"Monday", "Tuesday", "Wednesday", "Thursday", 
-                                          "Friday", "Saturday", "Sunday"};
-    
-    bool valid_day = std::find(valid_days.begin(), valid_days.end(), day) != valid_days.end();
+    // Any spelling of a weekday ("friday", "Fri", "tomorrow"); vague times are allowed
+    bool valid_day = TimeSlotParser::parseDay(day, currentWeekday()) >= 0;
     bool valid_time = !time.empty();
     
     return valid_day && valid_time;
@@ -386,85 +377,206 @@ bool CloserCrew::isBusy() const {
     return active_tasks.load() > 0;
 }
 
+PromptBuilderStats CloserCrew::getPromptStats() const {
+    return prompt_builder.getStats();
+}
+
 // AppointmentManager Implementation
+AppointmentManager::AppointmentManager(const AvailabilityConfig& config) : availability(config) {}
+
+static bool wantsAnyStylist(const std::string& stylist) {
+    return stylist.empty() || stylist == "Unknown" || stylist == "any" || stylist == "Any" || stylist == "anyone";
+}
+
+int AppointmentManager::requestedStylist(const std::string& stylist) const {
+    return wantsAnyStylist(stylist) ? -1 : availability.stylistId(stylist);
+}
+
 bool AppointmentManager::storeAppointment(const AppointmentSummary& appointment) {
+    // Summaries not built by CloserCrew have no parsed slot yet
+    SlotRange slot = appointment.slot.valid()
+        ? appointment.slot
+        : TimeSlotParser::parse(appointment.preferred_day, appointment.preferred_time, currentWeekday());
+    if (slot.exact) {
+        slot.end = std::min(slot.begin + availability.serviceMinutes(appointment.service_requested),
+                            (slot.day() + 1) * kMinutesPerDay);
+    }
+    
     std::lock_guard<std::mutex> lock(appointments_mutex);
     
-    // Check for conflicts
-    if (hasTimeConflict(appointment.preferred_day, appointment.preferred_time)) {
+    // Exact slots are booked for a stylist: the one asked for, or the first
+    // one free. A name not on the roster is booked as "anyone" and flagged
+    // for follow-up rather than given a chair nobody sits in.
+    int stylist = requestedStylist(appointment.stylist);
+    bool unknown_stylist = stylist < 0 && !wantsAnyStylist(appointment.stylist);
+    bool conflict;
+    if (slot.exact) {
+        if (stylist < 0) stylist = availability.anyFree(slot);
+        conflict = stylist < 0 || !availability.book(stylist, slot);
+    } else {
+        stylist = -1;
+        conflict = hasTimeConflictLocked(slot, appointment.preferred_day, appointment.preferred_time);
+    }
+    
+    if (conflict) {
         std::cout << "  ⚠️ Time conflict detected for " << appointment.preferred_day 
                   << " at " << appointment.preferred_time << std::endl;
         return false;
     }
     
-    confirmed_appointments.push_back(appointment);
+    AppointmentSummary stored = appointment;
+    stored.slot = slot;
+    if (stylist >= 0) stored.stylist = availability.stylistName(stylist);
+    if (unknown_stylist) {
+        stored.status = "needs_followup";
+        std::cout << "  ⚠️ Stylist \"" << appointment.stylist << "\" is not on the roster, booked with "
+                  << (stylist >= 0 ? "\"" + stored.stylist + "\"" : std::string("anyone")) << " for follow-up" << std::endl;
+    }
+    if (!store.append(stored)) {
+        if (stylist >= 0) availability.release(stylist, slot);
+        std::cerr << "  ❌ Appointment store is full" << std::endl;
+        return false;
+    }
     std::cout << "  ✅ Stored appointment for " << appointment.customer_name << std::endl;
     return true;
 }
 
+AppointmentSnapshot AppointmentManager::getSnapshot() const {
+    return store.snapshot();
+}
+
 std::vector<AppointmentSummary> AppointmentManager::getAppointments() const {
-    std::lock_guard<std::mutex> lock(appointments_mutex);
-    return confirmed_appointments;
+    return store.snapshot().toVector();
 }
 
 std::vector<AppointmentSummary> AppointmentManager::getAppointmentsByDay(const std::string& day) const {
-    std::lock_guard<std::mutex> lock(appointments_mutex);
+    int day_index = TimeSlotParser::parseDay(day, currentWeekday());
+    
     std::vector<AppointmentSummary> day_appointments;
     
-    for (const auto& apt : confirmed_appointments) {
-        if (apt.preferred_day == day) {
+    store.snapshot().forEach([&](const AppointmentSummary& apt) {
+        bool same_day = (day_index >= 0 && apt.slot.valid()) ? apt.slot.day() == day_index
+                                                             : apt.preferred_day == day;
+        if (same_day) {
             day_appointments.push_back(apt);
         }
-    }
+    });
     
     return day_appointments;
 }
 
 bool AppointmentManager::hasTimeConflict(const std::string& day, const std::string& time) const {
+    SlotRange slot = TimeSlotParser::parse(day, time, currentWeekday());
     std::lock_guard<std::mutex> lock(appointments_mutex);
-    
-    for (const auto& apt : confirmed_appointments) {
-        if (apt.preferred_day == day && apt.preferred_time == time) {
-            return true;
-        }
+    return hasTimeConflictLocked(slot, day, time);
+}
+
+bool AppointmentManager::hasTimeConflict(const SlotRange& slot) const {
+    std::lock_guard<std::mutex> lock(appointments_mutex);
+    return slot.exact && availability.anyFree(slot) < 0;
+}
+
+bool AppointmentManager::hasTimeConflictLocked(const SlotRange& slot, const std::string& day,
+                                               const std::string& time) const {
+    if (slot.valid()) {
+        return slot.exact && availability.anyFree(slot) < 0;
     }
     
-    return false;
+    bool conflict = false;
+    store.snapshot().forEach([&](const AppointmentSummary& apt) {
+        conflict = conflict || (apt.preferred_day == day && apt.preferred_time == time);
+    });
+    
+    return conflict;
 }
 
-std::vector<std::string> AppointmentManager::getSuggestedAlternatives(const std::string& day, const std::string& time) const {
-    // Simple alternative suggestions
+std::vector<std::string> AppointmentManager::getSuggestedAlternatives(const std::string& day, const std::string& time,
+                                                                      const std::string& service,
+                                                                      const std::string& stylist, size_t count) const {
+    // From the requested slot (its day for vague times), otherwise from now
+    SlotRange slot = TimeSlotParser::parse(day, time, currentWeekday());
+    int32_t from = slot.begin;
+    if (!slot.valid()) {
+        std::time_t now = std::time(nullptr);
+        std::tm local{};
+        localtime_r(&now, &local);
+        from = TimeSlotParser::slotId(currentWeekday(), local.tm_hour * 60 + local.tm_min);
+    }
+    
     std::vector<std::string> alternatives;
-    alternatives.push_back("Earlier time on " + day);
-    alternatives.push_back("Later time on " + day);
-    alternatives.push_back("Same time on different day");
+    for (const FreeSlot& free : getNextFreeSlots(from, service, stylist, count)) {
+        std::string text = TimeSlotParser::formatSlot(free.begin);
+        std::lock_guard<std::mutex> lock(appointments_mutex);
+        const std::string& name = availability.stylistName(free.stylist);
+        if (!name.empty()) text += " with " + name;
+        alternatives.push_back(std::move(text));
+    }
     
     return alternatives;
 }
 
-int AppointmentManager::getTotalAppointments() const {
+bool AppointmentManager::isSlotFree(const SlotRange& slot, const std::string& service, const std::string& stylist) const {
+    if (!slot.exact) return false;
     std::lock_guard<std::mutex> lock(appointments_mutex);
-    return confirmed_appointments.size();
+    SlotRange booking{slot.begin, slot.begin + availability.serviceMinutes(service), true};
+    int id = requestedStylist(stylist);
+    return id >= 0 ? availability.isFree(id, booking) : availability.anyFree(booking) >= 0;
 }
 
-std::unordered_map<std::string, int> AppointmentManager::getServiceCounts() const {
+std::vector<FreeSlot> AppointmentManager::getNextFreeSlots(int32_t from, const std::string& service,
+                                                           const std::string& stylist, size_t count) const {
     std::lock_guard<std::mutex> lock(appointments_mutex);
-    std::unordered_map<std::string, int> counts;
+    return availability.nextFree(requestedStylist(stylist), from, availability.serviceMinutes(service), count);
+}
+
+std::vector<std::string> AppointmentManager::getStylistsFreeAt(const SlotRange& slot, const std::string& service) const {
+    std::vector<std::string> stylists;
+    if (!slot.exact) return stylists;
     
-    for (const auto& apt : confirmed_appointments) {
-        counts[apt.service_requested]++;
+    std::lock_guard<std::mutex> lock(appointments_mutex);
+    SlotRange booking{slot.begin, slot.begin + availability.serviceMinutes(service), true};
+    for (int id = 0; id < static_cast<int>(availability.stylistCount()); id++) {
+        if (availability.isFree(id, booking)) stylists.push_back(availability.stylistName(id));
     }
-    
-    return counts;
+    return stylists;
+}
+
+int AppointmentManager::getTotalAppointments() const {
+    return static_cast<int>(store.snapshot().getStats().total);
+}
+
+std::unordered_map<std::string, int> AppointmentManager::getServiceCounts() const {
+    return store.snapshot().getStats().serviceCounts();
+}
+
+std::array<int, 7> AppointmentManager::getDayCounts() const {
+    return store.snapshot().getStats().per_day;
+}
+
+std::array<int, 24> AppointmentManager::getHourCounts() const {
+    return store.snapshot().getStats().per_hour;
+}
+
+ExportResult AppointmentManager::exportAppointments(const std::string& path, const ExportOptions& options) const {
+    return AppointmentExporter::writeCsv(store.snapshot(), path, options);
+}
+
+void AppointmentManager::reportMemory(MemoryReport& report) const {
+    AppointmentSnapshot snapshot = store.snapshot();
+    report.add("appointments.store", snapshot.memoryBytes(), snapshot.size());
+    std::lock_guard<std::mutex> lock(appointments_mutex);
+    report.add("appointments.availability", availability.memoryBytes(), availability.stylistCount());
 }
 
 void AppointmentManager::clearOldAppointments() {
     std::lock_guard<std::mutex> lock(appointments_mutex);
     // For now, just clear all - in real implementation, check dates
-    confirmed_appointments.clear();
+    store.clear();
+    availability.clear();
 }
 
 void AppointmentManager::reset() {
     std::lock_guard<std::mutex> lock(appointments_mutex);
-    confirmed_appointments.clear();
+    store.clear();
+    availability.clear();
 }
\ No newline at end of file
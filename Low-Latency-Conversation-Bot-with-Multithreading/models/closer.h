@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -10,20 +11,36 @@
 #include <thread>
 #include <atomic>
 
+#include "memory_accounting.h"
+#include "prompt_builder.h"
+#include "llm_health.h"
+#include "question_scorer.h"
+#include "time_slots.h"
+#include "availability_index.h"
+#include "appointment_store.h"
+#include "appointment_export.h"
+#include "transcript_ring.h"
+
 // Forward declaration
 class LLMInterface;
 
 // Closing request structure
 struct ClosingRequest {
     std::unordered_map<std::string, std::string> complete_entities;  // All filled entities
-    std::string conversation_summary;  // Summary of the conversation
+    TranscriptSnapshot conversation_summary;  // Conversation so far, copied out of the session's TranscriptRing
+    uint64_t session_key = 0;   // As in CompositionRequest
+    size_t history_length = 0;  // Leading summary bytes already sent in earlier prompts
     std::string business_context;  // Business/appointment context
     
     ClosingRequest() = default;
     ClosingRequest(const std::unordered_map<std::string, std::string>& entities,
-                  const std::string& summary = "",
+                  TranscriptSnapshot summary = nullptr,
                   const std::string& context = "")
-        : complete_entities(entities), conversation_summary(summary), business_context(context) {}
+        : complete_entities(entities), conversation_summary(std::move(summary)), business_context(context) {}
+    
+    std::string_view summary() const {
+        return conversation_summary ? std::string_view(*conversation_summary) : std::string_view();
+    }
 };
 
 // Closing result structure
@@ -41,27 +58,11 @@ struct ClosingResult {
         : needs_followup(false), confidence_score(0.0f), is_valid(false), generation_method("none") {}
 };
 
-// Appointment summary structure for internal processing
-struct AppointmentSummary {
-    std::string customer_name;
-    std::string customer_phone;
-    std::string preferred_day;
-    std::string preferred_time;
-    std::string service_requested;
-    std::string booking_timestamp;
-    std::string status;  // "confirmed", "pending", "needs_followup"
-    
-    // Convert to formatted string
-    std::string toString() const;
-    
-    // Convert to JSON-like format
-    std::string toJSON() const;
-};
-
 // Thread-safe closer with LLM integration
 class CloserCrew {
 private:
-    std::unique_ptr<LLMInterface> llm_interface;
+    std::shared_ptr<LLMInterface> llm_interface;  // May be shared with other crews
+    std::shared_ptr<LLMCircuitBreaker> llm_health;  // Shared by every crew on the same LLM
     
     // Configuration
     float confidence_threshold;
@@ -72,8 +73,15 @@ private:
     std::unordered_map<std::string, std::vector<std::string>> closing_templates;
     std::unordered_map<std::string, std::vector<std::string>> confirmation_templates;
     
+    // Pre-rendered LLM instructions
+    PromptBuilder prompt_builder;
+    
+    // Closing quality (scorer shared process-wide, see QualityAssessment)
+    std::shared_ptr<QuestionQualityScorer> quality_scorer;
+    QualityAssessor quality_assessor;
+    
 public:
-    CloserCrew(std::unique_ptr<LLMInterface> llm);
+    CloserCrew(std::shared_ptr<LLMInterface> llm);
     ~CloserCrew() = default;
     
     // Main closing functions
@@ -95,10 +103,12 @@ public:
     // Status monitoring
     int getActiveTaskCount() const;
     bool isBusy() const;
+    PromptBuilderStats getPromptStats() const;
+    LLMCircuitBreaker* getLLMHealth() const { return llm_health.get(); }
     
 private:
     // Core closing logic
-    ClosingResult generateWithLLM(const ClosingRequest& request);
+    ClosingResult generateWithLLM(const LLMPrompt& prompt, const CircuitAdmission& admission);
     ClosingResult generateWithTemplate(const ClosingRequest& request);
     ClosingResult validateAndImprove(const ClosingResult& initial_result, 
                                     const ClosingRequest& request);
@@ -122,22 +132,55 @@ private:
 // Business logic for appointment management
 class AppointmentManager {
 private:
-    std::vector<AppointmentSummary> confirmed_appointments;
-    mutable std::mutex appointments_mutex;
+    AppointmentStore store;          // Rows and counters, published as snapshots
+    AvailabilityIndex availability;  // Exact bookings per stylist and weekday
+    mutable std::mutex appointments_mutex;  // Serializes bookings (store writes and availability)
+    
+    // Caller holds appointments_mutex. An exact slot conflicts when no
+    // stylist is free for it; vague requests ("afternoon") hold no slot, and
+    // text the parser cannot read falls back to matching the raw strings.
+    bool hasTimeConflictLocked(const SlotRange& slot, const std::string& day, const std::string& time) const;
+    
+    // Stylist id for a requested name; -1 for anyone ("", "any", "Unknown")
+    int requestedStylist(const std::string& stylist) const;
     
 public:
-    // Appointment storage
+    explicit AppointmentManager(const AvailabilityConfig& config = AvailabilityConfig::fromEnvironment());
+    
+    // Appointment storage. Listings and statistics read the latest published
+    // snapshot and never wait for appointments_mutex.
     bool storeAppointment(const AppointmentSummary& appointment);
+    AppointmentSnapshot getSnapshot() const;
     std::vector<AppointmentSummary> getAppointments() const;
     std::vector<AppointmentSummary> getAppointmentsByDay(const std::string& day) const;
     
     // Conflict checking
     bool hasTimeConflict(const std::string& day, const std::string& time) const;
-    std::vector<std::string> getSuggestedAlternatives(const std::string& day, const std::string& time) const;
+    bool hasTimeConflict(const SlotRange& slot) const;
+    
+    // The next free starts for the service (from the requested slot, or from
+    // now), e.g. "Friday 3:15 PM with Sam"
+    std::vector<std::string> getSuggestedAlternatives(const std::string& day, const std::string& time,
+                                                      const std::string& service = "",
+                                                      const std::string& stylist = "", size_t count = 3) const;
     
-    // Statistics
+    // Availability queries ("" = any stylist)
+    bool isSlotFree(const SlotRange& slot, const std::string& service = "", const std::string& stylist = "") const;
+    std::vector<FreeSlot> getNextFreeSlots(int32_t from, const std::string& service = "",
+                                           const std::string& stylist = "", size_t count = 3) const;
+    std::vector<std::string> getStylistsFreeAt(const SlotRange& slot, const std::string& service = "") const;
+    
+    // Statistics, maintained as appointments are stored
     int getTotalAppointments() const;
     std::unordered_map<std::string, int> getServiceCounts() const;
+    std::array<int, 7> getDayCounts() const;
+    std::array<int, 24> getHourCounts() const;
+    
+    // Streams the current snapshot as CSV; bookings carry on while it runs
+    ExportResult exportAppointments(const std::string& path, const ExportOptions& options = ExportOptions()) const;
+    
+    // Memory accounting: stored appointments and the availability bitmaps
+    void reportMemory(MemoryReport& report) const;
     
     // Cleanup
     void clearOldAppointments();
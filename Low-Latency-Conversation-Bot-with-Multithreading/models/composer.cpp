@@ -3,10 +3,13 @@
 #include <random>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <cstdlib>
 
 // ComposerCrew Implementation
-ComposerCrew::ComposerCrew(std::unique_ptr<LLMInterface> llm, int num_threads) 
-    : llm_interface(std::move(llm)), quality_threshold(0.7f), max_retries(2) {
+ComposerCrew::ComposerCrew(std::shared_ptr<LLMInterface> llm, int num_threads) 
+    : llm_interface(std::move(llm)), llm_health(LLMCircuitBreaker::attach(llm_interface)),
+      quality_threshold(0.7f), max_retries(2) {
     
     // Determine optimal thread count
     if (num_threads <= 0) {
@@ -15,7 +18,14 @@ ComposerCrew::ComposerCrew(std::unique_ptr<LLMInterface> llm, int num_threads)
         num_worker_threads = num_threads;
     }
     
-    std::cout << "🎵 Composer Crew initialized with " << num_worker_threads << " worker threads" << std::endl;
+    busy_poll = BusyPoll::instance().enabled();
+    std::cout << "🎵 Composer Crew initialized with " << num_worker_threads << " worker threads"
+              << (busy_poll ? " (busy-poll)" : "") << std::endl;
+    
+    // Quality assessor and scorer: configured once per process
+    const QualityAssessment& quality = QualityAssessment::shared();
+    quality_scorer = quality.scorer;
+    quality_assessor = quality.assessor;
     
     initializeTemplates();
     startWorkers();
@@ -78,6 +88,8 @@ void ComposerCrew::initializeTemplates() {
 }
 
 void ComposerCrew::startWorkers() {
+    stop_workers = false;
+    spin_queue.resume();
     for (int i = 0; i < num_worker_threads; ++i) {
         worker_threads.emplace_back(&ComposerCrew::workerLoop, this);
     }
@@ -88,6 +100,7 @@ void ComposerCrew::stopWorkers() {
         std::lock_guard<std::mutex> lock(queue_mutex);
         stop_workers = true;
     }
+    spin_queue.stop();
     queue_condition.notify_all();
     
     for (auto& thread : worker_threads) {
@@ -99,6 +112,16 @@ void ComposerCrew::stopWorkers() {
 }
 
 void ComposerCrew::workerLoop() {
+    if (busy_poll) {
+        // With a seat: pinned, never parks. Without one: parks on the same queue.
+        SpinnerSeat seat("composer");
+        std::function<void()> task;
+        while (spin_queue.pop(task, seat.spinning())) {
+            task();
+        }
+        return;
+    }
+    
     while (true) {
         std::function<void()> task;
         
@@ -124,24 +147,41 @@ std::future<CompositionResult> ComposerCrew::composeQuestionAsync(const Composit
     auto promise = std::make_shared<std::promise<CompositionResult>>();
     auto future = promise->get_future();
     
+    composeQuestionThen(request, [promise](CompositionResult result) {
+        promise->set_value(std::move(result));
+    });
+    
+    return future;
+}
+
+void ComposerCrew::composeQuestionThen(const CompositionRequest& request, 
+                                       std::function<void(CompositionResult)> on_done) {
+    size_t request_bytes = sizeof(CompositionRequest) + heapBytes(request);
+    queued_request_bytes += request_bytes;
+    
+    std::function<void()> task = [this, request, request_bytes, on_done = std::move(on_done)]() {
+        queued_request_bytes -= request_bytes;
+        CompositionResult result;
+        try {
+            result = composeQuestion(request);
+        } catch (const std::exception& e) {
+            std::cerr << "Composition task failed: " << e.what() << std::endl;
+            result.generated_question = "I apologize, but I'm having trouble generating a question right now.";
+            result.is_valid = false;
+        }
+        on_done(std::move(result));
+    };
+    
+    if (busy_poll) {
+        spin_queue.push(std::move(task));  // Spinning workers see it without a wake-up
+        return;
+    }
+    
     {
         std::lock_guard<std::mutex> lock(queue_mutex);
-        task_queue.push([this, request, promise]() {
-            try {
-                auto result = composeQuestion(request);
-                promise->set_value(result);
-            } catch (const std::exception& e) {
-                std::cerr << "Composition task failed: " << e.what() << std::endl;
-                CompositionResult error_result;
-                error_result.generated_question = "I apologize, but I'm having trouble generating a question right now.";
-                error_result.is_valid = false;
-                promise->set_value(error_result);
-            }
-        });
+        task_queue.push(std::move(task));
     }
     queue_condition.notify_one();
-    
-    return future;
 }
 
 CompositionResult ComposerCrew::composeQuestion(const CompositionRequest& request) {
@@ -155,16 +195,19 @@ CompositionResult ComposerCrew::composeQuestion(const CompositionRequest& reques
     
     CompositionResult result;
     
-    // Try LLM first
-    if (llm_interface && llm_interface->isAvailable()) {
-        result = generateWithLLM(limited_request);
+    // Try LLM first (one prompt for every attempt) unless the breaker says it
+    // is degraded
+    CircuitAdmission admission;
+    if (llm_health && (admission = llm_health->allowRequest())) {
+        LLMPrompt prompt = prompt_builder.buildQuestion(limited_request);
+        result = generateWithLLM(limited_request, prompt, admission);
         
         // Quality check and potential retry
         if (result.is_valid && result.quality_score < quality_threshold) {
             std::cout << "  📊 Quality score too low (" << result.quality_score << "), retrying..." << std::endl;
             
-            for (int retry = 0; retry < max_retries; ++retry) {
-                auto retry_result = generateWithLLM(limited_request);
+            for (int retry = 0; retry < max_retries && (admission = llm_health->allowRequest()); ++retry) {
+                auto retry_result = generateWithLLM(limited_request, prompt, admission);
                 if (retry_result.quality_score > result.quality_score) {
                     result = retry_result;
                     break;
@@ -188,19 +231,29 @@ CompositionResult ComposerCrew::composeQuestion(const CompositionRequest& reques
     return result;
 }
 
-CompositionResult ComposerCrew::generateWithLLM(const CompositionRequest& request) {
+CompositionResult ComposerCrew::generateWithLLM(const CompositionRequest& request, const LLMPrompt& prompt,
+                                                const CircuitAdmission& admission) {
     CompositionResult result;
+    auto start = std::chrono::steady_clock::now();
     
     try {
         // Generate question using LLM
-        std::string question = llm_interface->generateQuestion(request);
+        std::string question = llm_interface->complete(prompt);
         
         if (!question.empty()) {
             result.generated_question = question;
             result.generation_method = "llm_primary";
             
-            // Quality assessment
-            result.quality_score = llm_interface->assessQuestionQuality(question, request);
+            // Quality assessment: locally unless configured to ask the LLM
+            QualityAssessor assessor = quality_assessor.load(std::memory_order_relaxed);
+            if (assessor == QualityAssessor::LOCAL) {
+                result.quality_score = quality_scorer->score(question, request);
+            } else {
+                result.quality_score = llm_interface->assessQuestionQuality(question, request);
+                if (assessor == QualityAssessor::SHADOW) {
+                    quality_scorer->record(question, request, result.quality_score);
+                }
+            }
             result.is_valid = true;
         }
         
@@ -209,6 +262,9 @@ CompositionResult ComposerCrew::generateWithLLM(const CompositionRequest& reques
         result.is_valid = false;
     }
     
+    llm_health->recordResult(admission, result.is_valid,
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    
     return result;
 }
 
@@ -312,6 +368,21 @@ void ComposerCrew::adjustThreadCount(int new_count) {
     }
 }
 
+PromptBuilderStats ComposerCrew::getPromptStats() const {
+    return prompt_builder.getStats();
+}
+
+void ComposerCrew::reportMemory(MemoryReport& report) const {
+    size_t queued_tasks = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queued_tasks = task_queue.size() + spin_queue.size();
+    }
+    report.add("composer.task_queue", queued_tasks * sizeof(std::function<void()>) + queued_request_bytes.load(), 
+               queued_tasks);
+    report.add("composer.templates", heapBytes(entity_templates), entity_templates.size());
+}
+
 void ComposerCrew::setQualityThreshold(float threshold) {
     quality_threshold = threshold;
 }
@@ -320,6 +391,10 @@ void ComposerCrew::setMaxRetries(int retries) {
     max_retries = retries;
 }
 
+void ComposerCrew::setQualityAssessor(QualityAssessor assessor) {
+    quality_assessor = assessor;
+}
+
 // EntityStateManager Implementation
 EntityStateManager::EntityStateManager() {
     required_entities = {
@@ -411,4 +486,9 @@ std::vector<std::string> EntityStateManager::getRequiredEntities() const {
 void EntityStateManager::setRequiredEntities(const std::vector<std::string>& entities) {
     std::lock_guard<std::mutex> lock(state_mutex);
     required_entities = entities;
-}
\ No newline at end of file
+}
+
+size_t EntityStateManager::getMemoryBytes() const {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    return heapBytes(entity_values) + heapBytes(required_entities);
+}
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -11,20 +12,39 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+
+#include "memory_accounting.h"
+#include "prompt_builder.h"
+#include "llm_health.h"
+#include "question_scorer.h"
+#include "busy_poll.h"
+#include "transcript_ring.h"
 
 // Composition request structure
 struct CompositionRequest {
     std::vector<std::string> missing_entities;  // Up to 2 entities to ask about
     std::unordered_map<std::string, std::string> known_entities;  // Already extracted
-    std::string conversation_context;  // Previous conversation
+    TranscriptSnapshot conversation_context;  // The session's transcript, copied out of its TranscriptRing
+    uint64_t session_key = 0;   // Stable per conversation (PromptBuilder::newSessionKey); 0: none
+    size_t history_length = 0;  // Leading context bytes already sent in earlier prompts
     
     CompositionRequest() = default;
     CompositionRequest(const std::vector<std::string>& missing, 
                       const std::unordered_map<std::string, std::string>& known,
-                      const std::string& context = "")
-        : missing_entities(missing), known_entities(known), conversation_context(context) {}
+                      TranscriptSnapshot context = nullptr)
+        : missing_entities(missing), known_entities(known), conversation_context(std::move(context)) {}
+    
+    std::string_view context() const {
+        return conversation_context ? std::string_view(*conversation_context) : std::string_view();
+    }
 };
 
+inline size_t heapBytes(const CompositionRequest& request) {
+    return heapBytes(request.missing_entities) + heapBytes(request.known_entities) +
+           (request.conversation_context ? sizeof(std::string) + heapBytes(*request.conversation_context) : 0);
+}
+
 // Composition result structure
 struct CompositionResult {
     std::string generated_question;
@@ -45,6 +65,14 @@ public:
     // Generate question for missing entities
     virtual std::string generateQuestion(const CompositionRequest& request) = 0;
     
+    // Complete a prompt from PromptBuilder (crews call this). Backends that
+    // keep a prefix/KV cache can key it on prompt.prefix_id (one per session)
+    // and prefill only what extends the cached prefix; the default builds
+    // from the request as before.
+    virtual std::string complete(const LLMPrompt& prompt) {
+        return generateQuestion(*prompt.request);
+    }
+    
     // Quality check the generated question
     virtual float assessQuestionQuality(const std::string& question, 
                                        const CompositionRequest& request) = 0;
@@ -56,15 +84,23 @@ public:
 // Thread-safe composer with LLM integration
 class ComposerCrew {
 private:
-    std::unique_ptr<LLMInterface> llm_interface;
+    std::shared_ptr<LLMInterface> llm_interface;  // May be shared with other crews
+    std::shared_ptr<LLMCircuitBreaker> llm_health;  // Shared by every crew on the same LLM
     
     // Thread pool for composition tasks
     std::vector<std::thread> worker_threads;
     std::queue<std::function<void()>> task_queue;
-    std::mutex queue_mutex;
+    mutable std::mutex queue_mutex;
     std::condition_variable queue_condition;
     std::atomic<bool> stop_workers{false};
     
+    // Busy-poll mode (chosen at construction): workers pin and spin on spin_queue
+    bool busy_poll = false;
+    SpinTaskQueue spin_queue;
+    
+    // Bytes of CompositionRequest copies waiting in task_queue
+    std::atomic<size_t> queued_request_bytes{0};
+    
     // Configuration
     float quality_threshold;
     int max_retries;
@@ -73,14 +109,26 @@ private:
     // Template fallbacks
     std::unordered_map<std::string, std::vector<std::string>> entity_templates;
     
+    // Pre-rendered LLM instructions
+    PromptBuilder prompt_builder;
+    
+    // Question quality (scorer shared process-wide, see QualityAssessment)
+    std::shared_ptr<QuestionQualityScorer> quality_scorer;
+    std::atomic<QualityAssessor> quality_assessor{QualityAssessor::LOCAL};
+    
 public:
-    ComposerCrew(std::unique_ptr<LLMInterface> llm, int num_threads = 0);
+    ComposerCrew(std::shared_ptr<LLMInterface> llm, int num_threads = 0);
     ~ComposerCrew();
     
     // Main composition functions
     std::future<CompositionResult> composeQuestionAsync(const CompositionRequest& request);
     CompositionResult composeQuestion(const CompositionRequest& request);
     
+    // Run on the worker pool and hand the result to on_done (on a worker thread),
+    // so callers can continue without parking a thread in future.get()
+    void composeQuestionThen(const CompositionRequest& request, 
+                             std::function<void(CompositionResult)> on_done);
+    
     // Batch composition for multiple missing entity groups
     std::vector<std::future<CompositionResult>> composeMultipleQuestionsAsync(
         const std::vector<CompositionRequest>& requests);
@@ -88,15 +136,24 @@ public:
     // Configuration
     void setQualityThreshold(float threshold);
     void setMaxRetries(int retries);
+    void setQualityAssessor(QualityAssessor assessor);
+    QuestionQualityScorer& getQualityScorer() { return *quality_scorer; }
     
     // Thread management
     void startWorkers();
     void stopWorkers();
     void adjustThreadCount(int new_count);
     
+    PromptBuilderStats getPromptStats() const;
+    LLMCircuitBreaker* getLLMHealth() const { return llm_health.get(); }
+    
+    // Memory accounting: queued requests and fallback templates
+    void reportMemory(MemoryReport& report) const;
+    
 private:
     // Core composition logic
-    CompositionResult generateWithLLM(const CompositionRequest& request);
+    CompositionResult generateWithLLM(const CompositionRequest& request, const LLMPrompt& prompt,
+                                      const CircuitAdmission& admission);
     CompositionResult generateWithTemplate(const CompositionRequest& request);
     CompositionResult validateAndImprove(const CompositionResult& initial_result, 
                                         const CompositionRequest& request);
@@ -142,6 +199,9 @@ public:
     // Thread-safe accessors
     std::vector<std::string> getRequiredEntities() const;
     void setRequiredEntities(const std::vector<std::string>& entities);
+    
+    // Estimated heap bytes held by the entity values
+    size_t getMemoryBytes() const;
 };
 
 #endif // COMPOSER_H
\ No newline at end of file
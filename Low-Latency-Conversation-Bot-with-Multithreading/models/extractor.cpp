@@ -1,10 +1,11 @@
 #include "extractor.h"
+#include "busy_poll.h"
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
 
 // NER Model Implementation
-NERModel::NERModel(const std::string& model_path, const std::string& metadata_path) 
-    : env{ORT_LOGGING_LEVEL_WARNING, "NERModel"} {
+NERModel::NERModel(const std::string& model_path, const std::string& metadata_path) {
     
     // Load metadata
     std::ifstream metadata_file(metadata_path);
@@ -20,111 +21,272 @@ NERModel::NERModel(const std::string& model_path, const std::string& metadata_pa
     vocab_size = metadata["vocab_size"].get<int>();
     max_length = metadata["max_length"].get<int>();
     
-    // Load ONNX model
-    Ort::SessionOptions session_options;
-    session_options.SetIntraOpNumThreads(1);
+    auto unk = word_to_idx.find("<UNK>");
+    auto pad = word_to_idx.find("<PAD>");
+    if (unk == word_to_idx.end() || pad == word_to_idx.end()) {
+        throw std::runtime_error("NER vocabulary needs <UNK> and <PAD>: " + metadata_path);
+    }
+    unk_id = unk->second;
+    pad_id = pad->second;
+    
+    // Older metadata has no "tokenizer" block: lower().split(), as trained
+    if (metadata.contains("tokenizer")) {
+        const json& tokenizer = metadata["tokenizer"];
+        tokenizer_options.fold_case = tokenizer.value("lowercase", true);
+        tokenizer_options.split_punctuation = tokenizer.value("split_punctuation", false);
+    }
     
+    // Load ONNX model (session options come from OrtRuntime)
     try {
-        session = std::make_unique<Ort::Session>(env, model_path.c_str(), session_options);
+        session = OrtRuntime::instance().createSession(model_path, "ner:" + model_path, runtime_model_id);
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to load NER model: " + std::string(e.what()));
     }
 }
 
+NERModel::~NERModel() {
+    session.reset();
+    OrtRuntime::instance().releaseModel(runtime_model_id);
+}
+
+size_t NERModel::getSessionBytes() const {
+    return OrtRuntime::instance().getModelStats(runtime_model_id).load_rss_bytes;
+}
+
+size_t NERModel::getVocabularyBytes() const {
+    return heapBytes(word_to_idx) + heapBytes(label_classes);
+}
+
 std::vector<int> NERModel::tokenize(const std::string& text) {
+    NormalizedText normalized;
+    TextNormalizer::normalize(text, tokenizer_options, normalized);
+    
     std::vector<int> tokens;
-    std::istringstream iss(text);
+    tokens.reserve(max_length);
     std::string word;
-    
-    // Convert to lowercase and split by spaces
-    std::string lower_text = text;
-    std::transform(lower_text.begin(), lower_text.end(), lower_text.begin(), ::tolower);
-    std::istringstream lower_iss(lower_text);
-    
-    while (lower_iss >> word && tokens.size() < max_length) {
+    for (size_t i = 0; i < normalized.tokens.size() && tokens.size() < static_cast<size_t>(max_length); i++) {
+        word.assign(normalized.token(i));
         auto it = word_to_idx.find(word);
-        if (it != word_to_idx.end()) {
-            tokens.push_back(it->second);
-        } else {
-            tokens.push_back(word_to_idx.at("<UNK>")); // Unknown token
-        }
+        tokens.push_back(it != word_to_idx.end() ? it->second : unk_id);
     }
     
     // Pad to max_length
-    while (tokens.size() < max_length) {
-        tokens.push_back(word_to_idx.at("<PAD>")); // Padding token
-    }
+    tokens.resize(max_length, pad_id);
     
     return tokens;
 }
 
-std::string NERModel::extract(const std::string& text) {
-    try {
-        // Tokenize input
+std::vector<std::string> NERModel::sourceWords(const std::string& text) const {
+    NormalizedText normalized;
+    TextNormalizer::normalize(text, tokenizer_options, normalized);
+    
+    std::vector<std::string> words;
+    words.reserve(normalized.tokens.size());
+    for (const TextToken& token : normalized.tokens) {
+        words.emplace_back(text, token.source_begin, token.source_length);
+    }
+    return words;
+}
+
+std::string NERModel::extract(const std::string& text, bool* failed) {
+    std::vector<bool> row_failed;
+    std::string extracted = std::move(extractBatch({text}, &row_failed)[0]);
+    if (failed) *failed = row_failed[0];
+    return extracted;
+}
+
+std::vector<Ort::Value> NERModel::runBatch(const std::vector<std::string>& texts, int& seq_len, int& num_labels) {
+    // Tokenize every input into one [batch_size, max_length] block
+    std::vector<int64_t> input_ids;
+    input_ids.reserve(texts.size() * max_length);
+    for (const auto& text : texts) {
         std::vector<int> tokens = tokenize(text);
+        input_ids.insert(input_ids.end(), tokens.begin(), tokens.end());
+    }
+    
+    // Create input tensor
+    std::vector<int64_t> input_shape = {static_cast<int64_t>(texts.size()), max_length}; // [batch_size, seq_len]
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    
+    Ort::Value input_tensor = Ort::Value::CreateTensor<int64_t>(
+        memory_info, input_ids.data(), input_ids.size(), 
+        input_shape.data(), input_shape.size()
+    );
+    
+    // Run inference
+    const char* input_names[] = {"input_ids"};
+    const char* output_names[] = {"logits"};
+    
+    OrtRuntime::RunScope run_scope(OrtRuntime::instance(), runtime_model_id);
+    auto output_tensors = session->Run(
+        run_scope.options(), 
+        input_names, &input_tensor, 1,
+        output_names, 1
+    );
+    
+    auto output_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    seq_len = output_shape[1];
+    num_labels = output_shape[2];
+    
+    return output_tensors;
+}
+
+std::vector<std::string> NERModel::extractBatch(const std::vector<std::string>& texts, std::vector<bool>* failed) {
+    std::vector<std::string> extracted(texts.size());
+    if (failed) failed->assign(texts.size(), false);
+    if (texts.empty()) {
+        return extracted;
+    }
+    
+    try {
+        int seq_len = 0, num_labels = 0;
+        auto output_tensors = runBatch(texts, seq_len, num_labels);
         
-        // Convert to int64 for ONNX
-        std::vector<int64_t> input_ids(tokens.begin(), tokens.end());
+        // Get predictions
+        float* logits = output_tensors[0].GetTensorMutableData<float>();
         
-        // Create input tensor
-        std::vector<int64_t> input_shape = {1, max_length}; // [batch_size, seq_len]
-        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        for (size_t i = 0; i < texts.size(); i++) {
+            extracted[i] = decodeFirstEntity(logits + i * seq_len * num_labels, seq_len, num_labels, texts[i]);
+        }
         
-        Ort::Value input_tensor = Ort::Value::CreateTensor<int64_t>(
-            memory_info, input_ids.data(), input_ids.size(), 
-            input_shape.data(), input_shape.size()
-        );
+    } catch (const std::exception& e) {
+        if (texts.size() == 1) {
+            std::cerr << "NER extraction error: " << e.what() << std::endl;
+            if (failed) (*failed)[0] = true;
+            return extracted;
+        }
         
-        // Run inference
-        const char* input_names[] = {"input_ids"};
-        const char* output_names[] = {"logits"};
+        // Retry row by row so one bad row does not take the batch with it
+        std::cerr << "NER batch extraction error, retrying " << texts.size() << " rows singly: " << e.what() << std::endl;
+        for (size_t i = 0; i < texts.size(); i++) {
+            std::vector<bool> row_failed;
+            extracted[i] = std::move(extractBatch({texts[i]}, &row_failed)[0]);
+            if (failed) (*failed)[i] = row_failed[0];
+        }
+    }
+    
+    return extracted;
+}
+
+std::vector<NERSpan> NERModel::extractSpans(const std::string& text) {
+    return extractSpansBatch({text})[0];
+}
+
+std::vector<std::vector<NERSpan>> NERModel::extractSpansBatch(const std::vector<std::string>& texts,
+                                                              std::vector<bool>* failed) {
+    std::vector<std::vector<NERSpan>> spans(texts.size());
+    if (failed) failed->assign(texts.size(), false);
+    if (texts.empty()) {
+        return spans;
+    }
+    
+    try {
+        int seq_len = 0, num_labels = 0;
+        auto output_tensors = runBatch(texts, seq_len, num_labels);
+        float* logits = output_tensors[0].GetTensorMutableData<float>();
         
-        auto output_tensors = session->Run(
-            Ort::RunOptions{nullptr}, 
-            input_names, &input_tensor, 1,
-            output_names, 1
-        );
+        for (size_t i = 0; i < texts.size(); i++) {
+            spans[i] = decodeSpans(logits + i * seq_len * num_labels, seq_len, num_labels, texts[i]);
+        }
         
-        // Get predictions
-        float* logits = output_tensors[0].GetTensorMutableData<float>();
-        auto output_shape = output_tensors[0].GetTensorTypeAndShapeInfo().GetShape();
-        int seq_len = output_shape[1];
-        int num_labels = output_shape[2];
-        
-        // Find predicted labels (argmax)
-        std::vector<std::string> words;
-        std::istringstream iss(text);
-        std::string word;
-        while (iss >> word) {
-            words.push_back(word);
-        }
-        
-        // Extract entities
-        for (int i = 0; i < std::min(seq_len, static_cast<int>(words.size())); i++) {
-            int best_label = 0;
-            float best_score = logits[i * num_labels];
-            
-            for (int j = 1; j < num_labels; j++) {
-                if (logits[i * num_labels + j] > best_score) {
-                    best_score = logits[i * num_labels + j];
-                    best_label = j;
-                }
-            }
-            
-            if (best_label < label_classes.size()) {
-                std::string label = label_classes[best_label];
-                if (label.find("B-") == 0) { // Beginning of entity
-                    return words[i]; // Return the word
-                }
-            }
+    } catch (const std::exception& e) {
+        if (texts.size() == 1) {
+            std::cerr << "NER span extraction error: " << e.what() << std::endl;
+            if (failed) (*failed)[0] = true;
+            return spans;
+        }
+        
+        // Retry row by row so one bad row does not take the batch with it
+        std::cerr << "NER batch span extraction error, retrying " << texts.size() << " rows singly: " << e.what() << std::endl;
+        for (size_t i = 0; i < texts.size(); i++) {
+            std::vector<bool> row_failed;
+            spans[i] = std::move(extractSpansBatch({texts[i]}, &row_failed)[0]);
+            if (failed) (*failed)[i] = row_failed[0];
+        }
+    }
+    
+    return spans;
+}
+
+std::vector<NERSpan> NERModel::decodeSpans(const float* logits, int seq_len, int num_labels, const std::string& text) const {
+    std::vector<NERSpan> spans;
+    
+    std::vector<std::string> words = sourceWords(text);
+    
+    NERSpan* open_span = nullptr;
+    float probability_sum = 0.0f;
+    
+    auto close_span = [&]() {
+        if (open_span) {
+            open_span->confidence = probability_sum / (open_span->end_word - open_span->start_word);
+            open_span = nullptr;
+        }
+    };
+    
+    for (int i = 0; i < std::min(seq_len, static_cast<int>(words.size())); i++) {
+        const float* row = logits + i * num_labels;
+        int best_label = 0;
+        for (int j = 1; j < num_labels; j++) {
+            if (row[j] > row[best_label]) best_label = j;
         }
         
-        return ""; // No entity found
+        // Softmax probability of the argmax label
+        float denominator = 0.0f;
+        for (int j = 0; j < num_labels; j++) {
+            denominator += std::exp(row[j] - row[best_label]);
+        }
+        float probability = 1.0f / denominator;
         
-    } catch (const std::exception& e) {
-        std::cerr << "NER extraction error: " << e.what() << std::endl;
-        return "";
+        const std::string& label = best_label < static_cast<int>(label_classes.size()) ? label_classes[best_label] : "O";
+        bool begins = label.compare(0, 2, "B-") == 0;
+        bool inside = label.compare(0, 2, "I-") == 0;
+        
+        if (inside && open_span && open_span->label_type == label.substr(2)) {
+            open_span->text += " " + words[i];
+            open_span->end_word = i + 1;
+            probability_sum += probability;
+            continue;
+        }
+        
+        close_span();
+        
+        // A stray I- without its B- still starts a span
+        if (begins || inside) {
+            spans.push_back(NERSpan{label.substr(2), words[i], 0.0f, i, i + 1});
+            open_span = &spans.back();
+            probability_sum = probability;
+        }
     }
+    close_span();
+    
+    return spans;
+}
+
+std::string NERModel::decodeFirstEntity(const float* logits, int seq_len, int num_labels, const std::string& text) const {
+    // Find predicted labels (argmax)
+    std::vector<std::string> words = sourceWords(text);
+    
+    // Extract entities
+    for (int i = 0; i < std::min(seq_len, static_cast<int>(words.size())); i++) {
+        int best_label = 0;
+        float best_score = logits[i * num_labels];
+        
+        for (int j = 1; j < num_labels; j++) {
+            if (logits[i * num_labels + j] > best_score) {
+                best_score = logits[i * num_labels + j];
+                best_label = j;
+            }
+        }
+        
+        if (best_label < static_cast<int>(label_classes.size())) {
+            const std::string& label = label_classes[best_label];
+            if (label.find("B-") == 0) { // Beginning of entity
+                return words[i]; // Return the word
+            }
+        }
+    }
+    
+    return ""; // No entity found
 }
 
 // Extraction Crew Implementation
@@ -142,53 +304,377 @@ void ExtractionCrew::loadNERModels(const std::string& models_dir) {
     };
     
     for (const auto& entity : entity_types) {
-        std::string model_path = models_dir + "/" + entity + "_ner.onnx";
+        std::string model_path = modelVariantPath(models_dir, entity, "ner", ModelPrecision::FP32);
         std::string metadata_path = models_dir + "/" + entity + "_metadata.json";
         
         try {
-            ner_models[entity] = std::make_unique<NERModel>(model_path, metadata_path);
+            ner_models[entity].fp32 = std::make_unique<NERModel>(model_path, metadata_path);
             std::cout << "✅ Loaded NER extractor for " << entity << std::endl;
         } catch (const std::exception& e) {
             std::cerr << "❌ Failed to load NER extractor for " << entity << ": " << e.what() << std::endl;
         }
+        
+        // Optional INT8 variants (same vocabulary/metadata), each in its own slot
+        for (ModelPrecision precision : {ModelPrecision::INT8_DYNAMIC, ModelPrecision::INT8_STATIC}) {
+            std::string int8_path = modelVariantPath(models_dir, entity, "ner", precision);
+            if (!modelFileExists(int8_path)) continue;
+            
+            try {
+                auto model = std::make_unique<NERModel>(int8_path, metadata_path);
+                NERModelSet& model_set = ner_models[entity];
+                (precision == ModelPrecision::INT8_DYNAMIC ? model_set.int8_dynamic : model_set.int8_static) = std::move(model);
+                std::cout << "✅ Loaded " << modelPrecisionName(precision) << " NER extractor for " << entity << std::endl;
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Failed to load " << modelPrecisionName(precision) << " NER extractor for " 
+                          << entity << ": " << e.what() << std::endl;
+            }
+        }
     }
+    
+    loadJointModel(models_dir, entity_types);
+    invalidateCache();
 }
 
-std::future<ExtractionResult> ExtractionCrew::extractEntityAsync(const std::string& sentence, const std::string& entity_type) {
-    return std::async(std::launch::async, [this, sentence, entity_type]() {
-        ExtractionResult result(entity_type);
+void ExtractionCrew::loadJointModel(const std::string& models_dir, const std::vector<std::string>& entity_types) {
+    std::string model_path = modelVariantPath(models_dir, "joint", "ner", ModelPrecision::FP32);
+    std::string metadata_path = models_dir + "/joint_metadata.json";
+    if (!modelFileExists(model_path)) {
+        return;
+    }
+    
+    try {
+        joint_model = std::make_unique<NERModel>(model_path, metadata_path);
         
-        try {
-            if (ner_models.find(entity_type) != ner_models.end()) {
-                std::string extracted = ner_models[entity_type]->extract(sentence);
-                
-                if (!extracted.empty()) {
-                    result.found = true;
-                    result.extracted_value = extracted;
-                    result.ner_confidence = 1.0f; // Simplified for now
-                    result.method_used = "ner";
-                }
+        // Label types map to entities through "label_entities" in the metadata,
+        // falling back to the usual short names (B-NAME, B-PHONE, ...)
+        joint_label_entities = {
+            {"NAME", "caller_name"}, {"PHONE", "phone_number"}, {"DAY", "day_preference"},
+            {"DATE", "day_preference"}, {"TIME", "time_preference"}, {"SERVICE", "service_type"}
+        };
+        std::ifstream metadata_file(metadata_path);
+        json metadata;
+        metadata_file >> metadata;
+        if (metadata.contains("label_entities")) {
+            for (const auto& item : metadata["label_entities"].items()) {
+                joint_label_entities[item.key()] = item.value().get<std::string>();
+            }
+        }
+        
+        // Entity names used directly as label types (B-caller_name) also work
+        for (const auto& label : joint_model->getLabelClasses()) {
+            if (label.size() > 2 && std::find(entity_types.begin(), entity_types.end(), label.substr(2)) != entity_types.end()) {
+                joint_label_entities[label.substr(2)] = label.substr(2);
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Error extracting " << entity_type << ": " << e.what() << std::endl;
         }
         
-        return result;
+        extraction_mode = ExtractionMode::JOINT;
+        std::cout << "✅ Loaded joint NER extractor (" << joint_model->getLabelClasses().size() << " labels)" << std::endl;
+        
+    } catch (const std::exception& e) {
+        joint_model.reset();
+        std::cerr << "❌ Failed to load joint NER extractor: " << e.what() << std::endl;
+    }
+}
+
+bool ExtractionCrew::usesJointModel(const std::string& entity_type) const {
+    if (extraction_mode != ExtractionMode::JOINT || !joint_model) {
+        return false;
+    }
+    
+    // Only entities that have a B- label in the joint label set
+    for (const auto& label : joint_model->getLabelClasses()) {
+        if (label.compare(0, 2, "B-") != 0) continue;
+        auto it = joint_label_entities.find(label.substr(2));
+        if (it != joint_label_entities.end() && it->second == entity_type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ExtractionCrew::setExtractionMode(ExtractionMode mode) {
+    if (mode == ExtractionMode::JOINT && !joint_model) {
+        std::cerr << "⚠️ No joint NER model loaded, keeping per-entity extraction" << std::endl;
+        return false;
+    }
+    if (extraction_mode.exchange(mode) != mode) {
+        invalidateCache();
+    }
+    return true;
+}
+
+ExtractionMode ExtractionCrew::getExtractionMode() const {
+    return joint_model ? extraction_mode.load() : ExtractionMode::PER_ENTITY;
+}
+
+bool ExtractionCrew::hasJointModel() const {
+    return joint_model != nullptr;
+}
+
+bool ExtractionCrew::setModelPrecision(const std::string& entity_type, ModelPrecision precision) {
+    auto it = ner_models.find(entity_type);
+    if (it == ner_models.end()) {
+        return false;
+    }
+    
+    if (isQuantized(precision) && !it->second.variant(precision)) {
+        std::cerr << "⚠️ No " << modelPrecisionName(precision) << " NER model for " << entity_type 
+                  << ", keeping " << modelPrecisionName(getModelPrecision(entity_type)) << std::endl;
+        return false;
+    }
+    
+    if (it->second.selected.exchange(precision) != precision) invalidateCache();
+    return true;
+}
+
+ModelPrecision ExtractionCrew::getModelPrecision(const std::string& entity_type) const {
+    auto it = ner_models.find(entity_type);
+    if (it == ner_models.end()) {
+        return ModelPrecision::FP32;
+    }
+    return it->second.selected;
+}
+
+NERModel* ExtractionCrew::getModel(const std::string& entity_type, ModelPrecision precision) const {
+    auto it = ner_models.find(entity_type);
+    if (it == ner_models.end()) {
+        return nullptr;
+    }
+    return it->second.variant(precision);
+}
+
+ExtractionResult ExtractionCrew::extractEntity(const std::string& sentence, const std::string& entity_type) {
+    if (usesJointModel(entity_type)) {
+        return extractJointBatch({sentence}, {{entity_type}})[0][0];
+    }
+    
+    ExtractionResult result(entity_type);
+    
+    try {
+        auto it = ner_models.find(entity_type);
+        NERModel* model = (it != ner_models.end()) ? it->second.active() : nullptr;
+        if (model) {
+            std::string extracted = model->extract(sentence, &result.failed);
+            
+            if (!extracted.empty()) {
+                result.found = true;
+                result.extracted_value = extracted;
+                result.ner_confidence = 1.0f; // Simplified for now
+                result.method_used = "ner";
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error extracting " << entity_type << ": " << e.what() << std::endl;
+        result.failed = true;
+    }
+    
+    return result;
+}
+
+std::future<ExtractionResult> ExtractionCrew::extractEntityAsync(const std::string& sentence, const std::string& entity_type) {
+    return std::async(std::launch::async, [this, sentence, entity_type]() {
+        return extractEntity(sentence, entity_type);
     });
 }
 
+// Cache key: entity + unit separator + whitespace-normalized sentence (case kept)
+static bool extractionCacheKey(const std::string& sentence, const std::string& entity_type, std::string& key) {
+    std::string sentence_key;
+    if (!normalizeUtteranceKey(sentence, false, sentence_key)) {
+        return false;
+    }
+    key = entity_type + '\x1f' + sentence_key;
+    return true;
+}
+
+bool ExtractionCrew::getCachedResult(const std::string& sentence, const std::string& entity_type, ExtractionResult& result) {
+    std::string key;
+    if (!cache_enabled || !extractionCacheKey(sentence, entity_type, key)) {
+        return false;
+    }
+    return extraction_cache.get(hashUtteranceKey(key, model_version), key, result);
+}
+
+void ExtractionCrew::cacheResult(const std::string& sentence, const ExtractionResult& result) {
+    std::string key;
+    if (!result.failed && cache_enabled && extractionCacheKey(sentence, result.entity_name, key)) {
+        extraction_cache.put(hashUtteranceKey(key, model_version), key, result);
+    }
+}
+
 std::vector<ExtractionResult> ExtractionCrew::extractEntities(const std::string& input_sentence, const std::vector<std::string>& target_entities) {
-    std::vector<std::future<ExtractionResult>> futures;
+    std::vector<ExtractionResult> results;
+    std::vector<std::pair<size_t, std::future<ExtractionResult>>> pending;
+    std::vector<size_t> joint_pending;
+    
+    // Answer repeat utterances from the cache, launch async extraction for the
+    // per-entity models and batch the joint-covered entities into one pass
+    for (size_t i = 0; i < target_entities.size(); i++) {
+        results.emplace_back(target_entities[i]);
+        if (getCachedResult(input_sentence, target_entities[i], results[i])) {
+            continue;
+        }
+        if (usesJointModel(target_entities[i])) {
+            joint_pending.push_back(i);
+        } else {
+            pending.emplace_back(i, extractEntityAsync(input_sentence, target_entities[i]));
+        }
+    }
     
-    // Launch async extraction for target entities only
-    for (const auto& entity : target_entities) {
-        futures.push_back(extractEntityAsync(input_sentence, entity));
+    // Joint pass runs on this thread while the per-entity models run async
+    if (!joint_pending.empty()) {
+        std::vector<std::string> joint_targets;
+        for (size_t index : joint_pending) {
+            joint_targets.push_back(target_entities[index]);
+        }
+        auto joint_results = extractJointBatch({input_sentence}, {joint_targets})[0];
+        for (size_t k = 0; k < joint_pending.size(); k++) {
+            results[joint_pending[k]] = joint_results[k];
+            cacheResult(input_sentence, joint_results[k]);
+        }
     }
     
     // Collect results
-    std::vector<ExtractionResult> results;
-    for (auto& future : futures) {
-        results.push_back(future.get());
+    for (auto& task : pending) {
+        results[task.first] = BusyPoll::get(task.second);
+        cacheResult(input_sentence, results[task.first]);
+    }
+    
+    return results;
+}
+
+std::vector<std::vector<ExtractionResult>> ExtractionCrew::extractJointBatch(const std::vector<std::string>& sentences,
+                                                                             const std::vector<std::vector<std::string>>& targets) {
+    std::vector<std::vector<ExtractionResult>> results(sentences.size());
+    for (size_t i = 0; i < sentences.size(); i++) {
+        for (const auto& entity : targets[i]) {
+            results[i].emplace_back(entity);
+        }
+    }
+    
+    std::vector<bool> failed;
+    std::vector<std::vector<NERSpan>> spans = joint_model->extractSpansBatch(sentences, &failed);
+    
+    // Keep the most confident span per requested entity, if it clears the
+    // confidence threshold (a span under it is not a detection)
+    float threshold = ner_confidence_threshold;
+    for (size_t i = 0; i < sentences.size(); i++) {
+        for (auto& result : results[i]) result.failed = failed[i];
+        
+        for (const auto& span : spans[i]) {
+            if (span.confidence < threshold) continue;
+            auto mapped = joint_label_entities.find(span.label_type);
+            if (mapped == joint_label_entities.end()) continue;
+            
+            for (auto& result : results[i]) {
+                if (result.entity_name != mapped->second) continue;
+                if (!result.found || span.confidence > result.ner_confidence) {
+                    result.found = true;
+                    result.extracted_value = span.text;
+                    result.ner_confidence = span.confidence;
+                    result.method_used = "joint_ner";
+                }
+            }
+        }
+    }
+    
+    return results;
+}
+
+std::vector<ExtractionResult> ExtractionCrew::extractBatch(const std::vector<std::string>& sentences, const std::string& entity_type) {
+    if (usesJointModel(entity_type)) {
+        auto joint_results = extractJointBatch(sentences, std::vector<std::vector<std::string>>(sentences.size(), {entity_type}));
+        std::vector<ExtractionResult> results;
+        results.reserve(sentences.size());
+        for (auto& sentence_results : joint_results) {
+            results.push_back(std::move(sentence_results[0]));
+        }
+        return results;
+    }
+    
+    std::vector<ExtractionResult> results(sentences.size(), ExtractionResult(entity_type));
+    
+    auto it = ner_models.find(entity_type);
+    NERModel* model = (it != ner_models.end()) ? it->second.active() : nullptr;
+    if (!model) {
+        return results;
+    }
+    
+    std::vector<bool> failed;
+    std::vector<std::string> extracted = model->extractBatch(sentences, &failed);
+    for (size_t i = 0; i < sentences.size(); i++) {
+        results[i].failed = failed[i];
+        if (!extracted[i].empty()) {
+            results[i].found = true;
+            results[i].extracted_value = extracted[i];
+            results[i].ner_confidence = 1.0f; // Simplified for now
+            results[i].method_used = "ner";
+        }
+    }
+    
+    return results;
+}
+
+std::vector<std::vector<ExtractionResult>> ExtractionCrew::extractEntitiesBatch(const std::vector<std::string>& sentences,
+                                                                                const std::vector<std::vector<std::string>>& targets) {
+    std::vector<std::vector<ExtractionResult>> results(sentences.size());
+    for (size_t i = 0; i < sentences.size(); i++) {
+        for (const auto& entity : targets[i]) {
+            results[i].emplace_back(entity);
+        }
+    }
+    
+    // Joint-covered entities: one forward pass over every sentence that needs one
+    std::vector<size_t> joint_rows;
+    std::vector<std::string> joint_sentences;
+    std::vector<std::vector<std::string>> joint_targets;
+    
+    // Everything else: one batched pass per entity model
+    std::unordered_map<std::string, std::vector<size_t>> entity_rows;
+    
+    for (size_t i = 0; i < sentences.size(); i++) {
+        std::vector<std::string> covered;
+        for (const auto& entity : targets[i]) {
+            if (usesJointModel(entity)) {
+                covered.push_back(entity);
+            } else {
+                entity_rows[entity].push_back(i);
+            }
+        }
+        if (!covered.empty()) {
+            joint_rows.push_back(i);
+            joint_sentences.push_back(sentences[i]);
+            joint_targets.push_back(std::move(covered));
+        }
+    }
+    
+    auto place = [&](size_t row, const ExtractionResult& extracted) {
+        for (auto& result : results[row]) {
+            if (result.entity_name == extracted.entity_name) {
+                result = extracted;
+                return;
+            }
+        }
+    };
+    
+    if (!joint_rows.empty()) {
+        auto joint_results = extractJointBatch(joint_sentences, joint_targets);
+        for (size_t k = 0; k < joint_rows.size(); k++) {
+            for (const auto& extracted : joint_results[k]) {
+                place(joint_rows[k], extracted);
+            }
+        }
+    }
+    
+    for (const auto& entry : entity_rows) {
+        std::vector<std::string> entity_sentences;
+        for (size_t row : entry.second) {
+            entity_sentences.push_back(sentences[row]);
+        }
+        auto entity_results = extractBatch(entity_sentences, entry.first);
+        for (size_t k = 0; k < entry.second.size(); k++) {
+            place(entry.second[k], entity_results[k]);
+        }
     }
     
     return results;
@@ -222,8 +708,54 @@ std::vector<ExtractionResult> ExtractionCrew::extractWithFallback(const std::str
     return results;
 }
 
+void ExtractionCrew::invalidateCache() {
+    model_version++;
+    extraction_cache.clear();
+}
+
+void ExtractionCrew::setCacheEnabled(bool enabled) {
+    cache_enabled = enabled;
+}
+
+void ExtractionCrew::clearCache() {
+    extraction_cache.clear();
+}
+
+CacheStats ExtractionCrew::getCacheStats() const {
+    return extraction_cache.stats();
+}
+
+void ExtractionCrew::reportMemory(MemoryReport& report) const {
+    size_t session_bytes = 0, vocabulary_bytes = 0;
+    size_t sessions = 0, vocabulary_words = 0;
+    
+    auto account = [&](const NERModel* model) {
+        if (!model) return;
+        session_bytes += model->getSessionBytes();
+        vocabulary_bytes += model->getVocabularyBytes();
+        vocabulary_words += model->getVocabularySize();
+        sessions++;
+    };
+    for (const auto& [entity, model_set] : ner_models) {
+        account(model_set.fp32.get());
+        account(model_set.int8_dynamic.get());
+        account(model_set.int8_static.get());
+    }
+    account(joint_model.get());
+    
+    report.add("extractor.ner_sessions", session_bytes, sessions);
+    report.add("extractor.vocabularies", vocabulary_bytes, vocabulary_words);
+    report.add("extractor.result_cache", extraction_cache.memoryBytes(), extraction_cache.size());
+}
+
+uint64_t ExtractionCrew::getModelVersion() const {
+    return model_version.load();
+}
+
 void ExtractionCrew::setNERConfidenceThreshold(float threshold) {
-    ner_confidence_threshold = threshold;
+    if (ner_confidence_threshold.exchange(threshold) != threshold) {
+        invalidateCache();  // Cached joint results were decided with the old threshold
+    }
 }
 
 void ExtractionCrew::printExtractionResults(const std::vector<ExtractionResult>& results) {
@@ -236,7 +768,7 @@ void ExtractionCrew::printExtractionResults(const std::vector<ExtractionResult>&
         if (result.found) {
             std::cout << "✅ \"" << result.extracted_value << "\" ";
             std::cout << "(method: " << result.method_used;
-            if (result.method_used == "ner") {
+            if (result.method_used == "ner" || result.method_used == "joint_ner") {
                 std::cout << ", confidence: " << std::fixed << std::setprecision(2) << result.ner_confidence;
             }
             std::cout << ")";
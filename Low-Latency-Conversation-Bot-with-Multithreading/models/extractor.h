@@ -9,6 +9,12 @@
 #include <future>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+
+#include "model_precision.h"
+#include "ort_runtime.h"
+#include "result_cache.h"
+#include "text_normalizer.h"
 
 // ONNX Runtime
 #include <onnxruntime/onnxruntime_cxx_api.h>
@@ -23,34 +29,124 @@ struct ExtractionResult {
     std::string extracted_value;
     float ner_confidence;
     bool found;
-    std::string method_used; // "ner", "llm_fallback"
+    std::string method_used; // "ner", "joint_ner", "llm_fallback"
+    bool failed;             // The model run failed; not found is not a verdict
     
     ExtractionResult(const std::string& name) 
         : entity_name(name), extracted_value(""), ner_confidence(0.0f), 
-          found(false), method_used("none") {}
+          found(false), method_used("none"), failed(false) {}
+};
+
+inline size_t heapBytes(const ExtractionResult& result) {
+    return heapBytes(result.entity_name) + heapBytes(result.extracted_value) + heapBytes(result.method_used);
+}
+
+// One decoded B-/I- span from a NER forward pass
+struct NERSpan {
+    std::string label_type;  // Label without the B-/I- prefix, e.g. "PHONE"
+    std::string text;        // Words of the span, space separated
+    float confidence;        // Mean softmax probability of the span's labels
+    int start_word;
+    int end_word;            // Exclusive
+};
+
+// How ExtractionCrew runs its NER models
+enum class ExtractionMode {
+    PER_ENTITY,  // One model and one forward pass per entity type
+    JOINT        // One multi-entity model fills every covered entity in one pass
 };
 
 // NER Model wrapper
 class NERModel {
 private:
-    std::unique_ptr<Ort::Session> session;
-    Ort::Env env;
+    std::unique_ptr<Ort::Session> session;  // Shares OrtRuntime's env and arena
+    size_t runtime_model_id = 0;
     std::unordered_map<std::string, int> word_to_idx;
     std::vector<std::string> label_classes;
     int vocab_size;
     int max_length;
+    int unk_id;
+    int pad_id;
+    NormalizerOptions tokenizer_options;  // From the metadata "tokenizer" block
+    
+    // Input words as the tokenizer split them, copied from the original text
+    std::vector<std::string> sourceWords(const std::string& text) const;
+    
+    // Argmax over one sentence's logits, returns the first B- word
+    std::string decodeFirstEntity(const float* logits, int seq_len, int num_labels, const std::string& text) const;
+    
+    // Argmax + softmax over one sentence's logits, returns every span
+    std::vector<NERSpan> decodeSpans(const float* logits, int seq_len, int num_labels, const std::string& text) const;
+    
+    // Shared forward pass: [batch_size, seq_len, num_labels] logits
+    std::vector<Ort::Value> runBatch(const std::vector<std::string>& texts, int& seq_len, int& num_labels);
     
 public:
     NERModel(const std::string& model_path, const std::string& metadata_path);
+    ~NERModel();
     std::vector<int> tokenize(const std::string& text);
-    std::string extract(const std::string& text);
+    std::string extract(const std::string& text, bool* failed = nullptr);  // *failed: the run failed
+    
+    // One forward pass over a batch of sentences padded to max_length. A
+    // failed pass is retried row by row; rows that still fail come back empty
+    // and are flagged in `failed` when given (same for extractSpansBatch).
+    std::vector<std::string> extractBatch(const std::vector<std::string>& texts, std::vector<bool>* failed = nullptr);
+    
+    // All labelled spans per sentence (used with the joint multi-entity model)
+    std::vector<NERSpan> extractSpans(const std::string& text);
+    std::vector<std::vector<NERSpan>> extractSpansBatch(const std::vector<std::string>& texts,
+                                                        std::vector<bool>* failed = nullptr);
+    
+    const std::vector<std::string>& getLabelClasses() const { return label_classes; }
+    
+    // Memory accounting
+    size_t getSessionBytes() const;
+    size_t getVocabularyBytes() const;
+    size_t getVocabularySize() const { return word_to_idx.size(); }
+};
+
+// FP32 model plus the optional INT8 variants, loaded side by side
+struct NERModelSet {
+    std::unique_ptr<NERModel> fp32;
+    std::unique_ptr<NERModel> int8_dynamic;
+    std::unique_ptr<NERModel> int8_static;
+    std::atomic<ModelPrecision> selected{ModelPrecision::FP32};  // Per entity, switchable at runtime
+    
+    NERModel* variant(ModelPrecision precision) const {
+        switch (precision) {
+            case ModelPrecision::INT8_DYNAMIC: return int8_dynamic.get();
+            case ModelPrecision::INT8_STATIC: return int8_static.get();
+            default: return fp32.get();
+        }
+    }
+    NERModel* active() const { return variant(selected); }
 };
 
 // Extraction Crew - handles entity value extraction
 class ExtractionCrew {
 private:
-    std::unordered_map<std::string, std::unique_ptr<NERModel>> ner_models;
-    float ner_confidence_threshold;
+    std::unordered_map<std::string, NERModelSet> ner_models;
+    std::atomic<float> ner_confidence_threshold;  // Joint spans under it are not found
+    
+    // Optional joint model (joint_ner.onnx + joint_metadata.json) whose label
+    // set covers several entities; label type -> entity type
+    std::unique_ptr<NERModel> joint_model;
+    std::unordered_map<std::string, std::string> joint_label_entities;
+    std::atomic<ExtractionMode> extraction_mode{ExtractionMode::PER_ENTITY};
+    
+    // Repeat-utterance cache keyed by entity + normalized sentence + model version.
+    // Case is preserved in the key because the extracted span is copied from the input.
+    ShardedResultCache<ExtractionResult> extraction_cache;
+    std::atomic<uint64_t> model_version{0};
+    std::atomic<bool> cache_enabled{true};
+    
+    void invalidateCache();
+    
+    void loadJointModel(const std::string& models_dir, const std::vector<std::string>& entity_types);
+    
+    // One joint forward pass; results[i] holds targets[i] for sentences[i]
+    std::vector<std::vector<ExtractionResult>> extractJointBatch(const std::vector<std::string>& sentences,
+                                                                 const std::vector<std::vector<std::string>>& targets);
     
 public:
     ExtractionCrew(const std::string& ner_models_dir, float threshold = 0.5f);
@@ -58,19 +154,58 @@ public:
     // Load all NER models
     void loadNERModels(const std::string& models_dir);
     
+    // Extract single entity on the calling thread
+    ExtractionResult extractEntity(const std::string& sentence, const std::string& entity_type);
+    
     // Extract single entity async
     std::future<ExtractionResult> extractEntityAsync(const std::string& sentence, const std::string& entity_type);
     
     // Extract given entities in parallel
     std::vector<ExtractionResult> extractEntities(const std::string& input_sentence, const std::vector<std::string>& target_entities);
     
+    // Cache access for callers that schedule extractEntity() themselves; a
+    // failed result is not cached
+    bool getCachedResult(const std::string& sentence, const std::string& entity_type, ExtractionResult& result);
+    void cacheResult(const std::string& sentence, const ExtractionResult& result);
+    
+    // Extract one entity type from a batch of sentences with a single forward pass
+    // (offline/bulk use; results[i] belongs to sentences[i])
+    std::vector<ExtractionResult> extractBatch(const std::vector<std::string>& sentences, const std::string& entity_type);
+    
+    // Extract several entity types per sentence from a batch; in JOINT mode
+    // the whole batch costs one forward pass for the covered entities
+    std::vector<std::vector<ExtractionResult>> extractEntitiesBatch(const std::vector<std::string>& sentences,
+                                                                    const std::vector<std::vector<std::string>>& targets);
+    
     // LLM fallback for low-confidence extractions
     ExtractionResult llmFallback(const std::string& sentence, const std::string& entity_type);
     
     // Extract with LLM fallback
     std::vector<ExtractionResult> extractWithFallback(const std::string& input_sentence, const std::vector<std::string>& target_entities);
     
+    // Precision selection (falls back to FP32 if the INT8 variant is not on disk)
+    bool setModelPrecision(const std::string& entity_type, ModelPrecision precision);
+    ModelPrecision getModelPrecision(const std::string& entity_type) const;
+    NERModel* getModel(const std::string& entity_type, ModelPrecision precision) const;
+    
+    // Joint vs per-entity mode (JOINT needs joint_ner.onnx; entities the joint
+    // label set does not cover always use their per-entity model)
+    bool setExtractionMode(ExtractionMode mode);
+    ExtractionMode getExtractionMode() const;
+    bool hasJointModel() const;
+    bool usesJointModel(const std::string& entity_type) const;
+    
+    // Result cache
+    void setCacheEnabled(bool enabled);
+    void clearCache();
+    CacheStats getCacheStats() const;
+    uint64_t getModelVersion() const;
+    
+    // Memory accounting: loaded sessions, vocabularies and the result cache
+    void reportMemory(MemoryReport& report) const;
+    
     void setNERConfidenceThreshold(float threshold);
+    float getNERConfidenceThreshold() const { return ner_confidence_threshold; }
     void printExtractionResults(const std::vector<ExtractionResult>& results);
 };
 
@@ -0,0 +1,466 @@
+#include "http_llm_client.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+static constexpr size_t kLatencySamples = 1024;
+
+LLMEndpointConfig LLMEndpointConfig::fromUrl(const std::string& url) {
+    LLMEndpointConfig config;
+    std::string rest = url;
+
+    const std::string scheme = "http://";
+    if (rest.compare(0, scheme.size(), scheme) == 0) {
+        rest = rest.substr(scheme.size());
+    } else if (rest.find("://") != std::string::npos) {
+        throw std::runtime_error("Only http:// LLM endpoints are supported: " + url);
+    }
+
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    if (slash != std::string::npos) {
+        config.path = rest.substr(slash);
+    }
+
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        config.host = authority.substr(0, colon);
+        config.port = std::stoi(authority.substr(colon + 1));
+    } else if (!authority.empty()) {
+        config.host = authority;
+        config.port = 80;
+    }
+    return config;
+}
+
+void LLMClientStats::print() const {
+    std::cout << "\n🌐 LLM Client Statistics:" << std::endl;
+    std::cout << "  Requests: " << requests << " (" << failures << " failed, " << in_flight << " in flight)" << std::endl;
+    std::cout << "  Connections: " << connections_opened << " opened, " << connections_reused << " reused, "
+              << pooled_idle << " idle" << std::endl;
+    std::cout << "  Latency: p50 " << std::fixed << std::setprecision(1) << p50_ms << "ms, p95 " << p95_ms
+              << "ms, max " << max_ms << "ms (connect avg " << avg_connect_ms << "ms)" << std::endl;
+}
+
+HttpLLMClient::HttpLLMClient(const LLMEndpointConfig& config) : config(config) {
+    if (this->config.max_connections <= 0) this->config.max_connections = 1;
+    latency_samples_ms.reserve(kLatencySamples);
+
+    std::cout << "🌐 LLM client for http://" << this->config.host << ":" << this->config.port << this->config.path
+              << " (" << this->config.max_connections << " pooled connections)" << std::endl;
+    prewarm();
+}
+
+HttpLLMClient::~HttpLLMClient() {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    for (auto& connection : idle_connections) {
+        closeConnection(connection);
+    }
+    idle_connections.clear();
+}
+
+void HttpLLMClient::prewarm() {
+    int target = std::min(config.prewarm_connections, config.max_connections);
+
+    for (int i = 0; i < target; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            if (static_cast<int>(idle_connections.size()) + in_flight >= target) return;
+        }
+        try {
+            Connection connection = openConnection();
+            std::lock_guard<std::mutex> lock(pool_mutex);
+            idle_connections.push_back(connection);
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️ LLM prewarm failed: " << e.what() << std::endl;
+            return;
+        }
+    }
+}
+
+HttpLLMClient::Connection HttpLLMClient::openConnection() {
+    auto start = std::chrono::steady_clock::now();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    std::string port = std::to_string(config.port);
+
+    int rc = getaddrinfo(config.host.c_str(), port.c_str(), &hints, &addresses);
+    if (rc != 0) {
+        throw std::runtime_error("Cannot resolve " + config.host + ": " + gai_strerror(rc));
+    }
+
+    Connection connection;
+    for (addrinfo* address = addresses; address && connection.fd < 0; address = address->ai_next) {
+        int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) continue;
+
+        // Non-blocking connect so the timeout is ours, then back to blocking
+        int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+        bool connected = ::connect(fd, address->ai_addr, address->ai_addrlen) == 0;
+        if (!connected && errno == EINPROGRESS) {
+            pollfd pfd{fd, POLLOUT, 0};
+            if (poll(&pfd, 1, config.connect_timeout_ms) == 1) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                connected = error == 0;
+            }
+        }
+
+        if (!connected) {
+            ::close(fd);
+            continue;
+        }
+
+        fcntl(fd, F_SETFL, flags);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        timeval timeout{config.request_timeout_ms / 1000, (config.request_timeout_ms % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        connection.fd = fd;
+    }
+    freeaddrinfo(addresses);
+
+    if (connection.fd < 0) {
+        throw std::runtime_error("Cannot connect to " + config.host + ":" + port);
+    }
+
+    connection.last_used = std::chrono::steady_clock::now();
+    connections_opened++;
+    connect_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(connection.last_used - start).count();
+    return connection;
+}
+
+// A pooled connection the server has closed reads as EOF without blocking
+bool HttpLLMClient::isStale(const Connection& connection) {
+    char byte;
+    ssize_t n = recv(connection.fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return true;
+    if (n < 0) return errno != EAGAIN && errno != EWOULDBLOCK;
+    return true;  // Unsolicited bytes: the stream is out of sync
+}
+
+void HttpLLMClient::closeConnection(Connection& connection) {
+    if (connection.fd >= 0) {
+        ::close(connection.fd);
+        connection.fd = -1;
+    }
+}
+
+HttpLLMClient::Connection HttpLLMClient::acquire(bool fresh) {
+    Connection connection;
+    {
+        // Per-endpoint concurrency limit
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        pool_condition.wait(lock, [this] { return in_flight < config.max_connections; });
+        in_flight++;
+
+        auto now = std::chrono::steady_clock::now();
+        while (!fresh && !idle_connections.empty()) {
+            Connection candidate = idle_connections.back();
+            idle_connections.pop_back();
+            if (now - candidate.last_used < config.idle_timeout && !isStale(candidate)) {
+                connection = candidate;
+                break;
+            }
+            closeConnection(candidate);
+        }
+    }
+
+    if (connection.fd >= 0) {
+        connections_reused++;
+        connection.reused = true;
+        return connection;
+    }
+
+    try {
+        return openConnection();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        in_flight--;
+        pool_condition.notify_one();
+        throw;
+    }
+}
+
+void HttpLLMClient::release(Connection connection, bool reusable) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        in_flight--;
+        if (reusable && connection.fd >= 0) {
+            connection.last_used = std::chrono::steady_clock::now();
+            idle_connections.push_back(connection);
+            connection.fd = -1;
+        }
+    }
+    closeConnection(connection);
+    pool_condition.notify_one();
+}
+
+static bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Content-Length framed HTTP/1.1 response; chunked bodies are not supported
+HttpLLMClient::Exchange HttpLLMClient::exchange(Connection& connection, const std::string& request,
+                                                std::string& body, int& status) {
+    // A server that dropped the connection refuses the write (or part of it);
+    // an incomplete request is never handled
+    if (!sendAll(connection.fd, request)) return Exchange::CLOSED_BEFORE_RESPONSE;
+
+    std::string buffer;
+    size_t header_end = std::string::npos;
+    char chunk[4096];
+
+    while (header_end == std::string::npos) {
+        ssize_t n = recv(connection.fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            // EOF/reset with nothing read is a keep-alive close racing our
+            // request; a timeout (EAGAIN) means the server may be working on it
+            bool closed = n == 0 || errno == ECONNRESET || errno == EPIPE;
+            return closed && buffer.empty() ? Exchange::CLOSED_BEFORE_RESPONSE : Exchange::FAILED;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        header_end = buffer.find("\r\n\r\n");
+    }
+
+    // Status line + headers
+    status = 0;
+    size_t space = buffer.find(' ');
+    if (space != std::string::npos) {
+        status = std::atoi(buffer.c_str() + space + 1);
+    }
+
+    std::string headers = buffer.substr(0, header_end);
+    std::transform(headers.begin(), headers.end(), headers.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    size_t content_length = 0;
+    size_t length_pos = headers.find("content-length:");
+    if (length_pos == std::string::npos) {
+        if (headers.find("transfer-encoding: chunked") != std::string::npos) {
+            throw std::runtime_error("Chunked LLM responses are not supported");
+        }
+        return Exchange::FAILED;
+    }
+    content_length = std::strtoul(headers.c_str() + length_pos + 15, nullptr, 10);
+
+    body = buffer.substr(header_end + 4);
+    while (body.size() < content_length) {
+        ssize_t n = recv(connection.fd, chunk, std::min(sizeof(chunk), content_length - body.size()), 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return Exchange::FAILED;
+        }
+        body.append(chunk, static_cast<size_t>(n));
+    }
+    body.resize(content_length);
+
+    // Server asked to close: don't pool it
+    if (headers.find("connection: close") != std::string::npos) {
+        closeConnection(connection);
+    }
+    return Exchange::COMPLETE;
+}
+
+std::string HttpLLMClient::post(const std::string& json_body) {
+    std::string request;
+    request.reserve(192 + config.host.size() + config.path.size() + json_body.size());
+    request += "POST ";
+    request += config.path;
+    request += " HTTP/1.1\r\nHost: ";
+    request += config.host;
+    request += "\r\nContent-Type: application/json\r\nConnection: keep-alive\r\nContent-Length: ";
+    request += std::to_string(json_body.size());
+    request += "\r\n\r\n";
+    request += json_body;
+
+    requests++;
+    auto start = std::chrono::steady_clock::now();
+
+    // POST is not idempotent: the only retry is for a reused connection the
+    // server closed before answering, and it goes out on a new connection
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        Connection connection;
+        try {
+            connection = acquire(attempt > 0);
+        } catch (...) {
+            failures++;
+            throw;
+        }
+
+        std::string body;
+        int status = 0;
+        Exchange result = Exchange::FAILED;
+        try {
+            result = exchange(connection, request, body, status);
+        } catch (...) {
+            release(connection, false);
+            failures++;
+            throw;
+        }
+
+        if (result != Exchange::COMPLETE) {
+            bool retry = result == Exchange::CLOSED_BEFORE_RESPONSE && connection.reused;
+            release(connection, false);
+            if (retry) continue;
+            break;
+        }
+
+        release(connection, connection.fd >= 0);
+        recordLatency(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        if (status < 200 || status >= 300) {
+            failures++;
+            throw std::runtime_error("LLM endpoint returned HTTP " + std::to_string(status));
+        }
+        return body;
+    }
+
+    failures++;
+    throw std::runtime_error("LLM connection failed");
+}
+
+void HttpLLMClient::recordLatency(double ms) {
+    std::lock_guard<std::mutex> lock(latency_mutex);
+    if (latency_samples_ms.size() < kLatencySamples) {
+        latency_samples_ms.push_back(ms);
+    } else {
+        latency_samples_ms[next_sample] = ms;
+    }
+    next_sample = (next_sample + 1) % kLatencySamples;
+}
+
+std::string HttpLLMClient::complete(const LLMPrompt& prompt) {
+    return completeText(prompt.text(), prompt.prefix_id, prompt.prefixLength(), config.max_tokens);
+}
+
+std::string HttpLLMClient::completeText(const std::string& prompt, uint64_t prefix_id, size_t prefix_length,
+                                        int max_tokens) {
+    json body = {
+        {"prompt", prompt},
+        {"prefix_id", prefix_id},
+        {"prefix_length", prefix_length},
+        {"max_tokens", max_tokens}
+    };
+
+    json response = json::parse(post(body.dump()));
+
+    // {"text": ...} or OpenAI-style {"choices": [{"text": ...}]}
+    std::string text;
+    if (response.contains("text")) {
+        text = response["text"].get<std::string>();
+    } else if (response.contains("choices") && !response["choices"].empty()) {
+        text = response["choices"][0].value("text", "");
+    }
+
+    size_t first = text.find_first_not_of(" \t\r\n");
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return first == std::string::npos ? "" : text.substr(first, last - first + 1);
+}
+
+std::string HttpLLMClient::generateQuestion(const CompositionRequest& request) {
+    return complete(prompt_builder.buildQuestion(request));
+}
+
+// A second round trip; ComposerCrew and CloserCrew only call this with
+// QualityAssessor::LLM or SHADOW; by default they score locally
+float HttpLLMClient::assessQuestionQuality(const std::string& question, const CompositionRequest& request) {
+    std::string prompt = "Rate how well the question below asks a hair salon caller for:";
+    for (const auto& entity : request.missing_entities) {
+        prompt += " " + entity;
+    }
+    if (!request.known_entities.empty()) {
+        prompt += ". It must not ask again for:";
+        for (const auto& [entity, value] : request.known_entities) {
+            prompt += " " + entity;
+        }
+    }
+    prompt += ". Reply with a number between 0 and 1 only.\nQuestion: " + question + "\nScore:";
+
+    std::string text = completeText(prompt, 0, 0, 4);
+    size_t start = text.find_first_of("0123456789.");
+    if (start == std::string::npos) {
+        throw std::runtime_error("LLM quality score is not a number: " + text);
+    }
+    float quality = std::strtof(text.c_str() + start, nullptr);
+    return std::max(0.0f, std::min(1.0f, quality));
+}
+
+// Called by the circuit breaker's prober, never per request. Checking out a
+// connection finds stale pooled ones and reconnects, so a passing probe also
+// leaves a warm connection behind.
+bool HttpLLMClient::isAvailable() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        if (in_flight >= config.max_connections) return true;  // Busy answering requests
+    }
+    try {
+        Connection connection = acquire();
+        release(connection, true);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+LLMClientStats HttpLLMClient::getStats() const {
+    LLMClientStats stats;
+    stats.requests = requests.load();
+    stats.failures = failures.load();
+    stats.connections_opened = connections_opened.load();
+    stats.connections_reused = connections_reused.load();
+    if (stats.connections_opened > 0) {
+        stats.avg_connect_ms = connect_ns.load() / 1e6 / stats.connections_opened;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        stats.in_flight = in_flight;
+        stats.pooled_idle = static_cast<int>(idle_connections.size());
+    }
+
+    std::vector<double> samples;
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex);
+        samples = latency_samples_ms;
+    }
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        stats.p50_ms = samples[samples.size() / 2];
+        stats.p95_ms = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+        stats.max_ms = samples.back();
+    }
+    return stats;
+}
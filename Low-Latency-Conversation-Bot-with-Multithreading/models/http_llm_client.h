@@ -0,0 +1,118 @@
+#ifndef HTTP_LLM_CLIENT_H
+#define HTTP_LLM_CLIENT_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "composer.h"
+#include "prompt_builder.h"
+
+// Where and how hard to call the completion endpoint
+struct LLMEndpointConfig {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string path = "/v1/completions";
+
+    int max_connections = 8;       // Keep-alive pool size = max requests in flight
+    int prewarm_connections = 2;   // Opened up front so turns never pay connection setup
+    int connect_timeout_ms = 500;
+    int request_timeout_ms = 5000;
+    std::chrono::seconds idle_timeout{30};  // Pooled connections idle longer are reopened
+    int max_tokens = 64;
+
+    // http://host[:port][/path]
+    static LLMEndpointConfig fromUrl(const std::string& url);
+};
+
+// Client counters and latency percentiles (over the last 1024 calls)
+struct LLMClientStats {
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    uint64_t connections_opened = 0;
+    uint64_t connections_reused = 0;
+    int in_flight = 0;
+    int pooled_idle = 0;
+    double avg_connect_ms = 0.0;
+    double p50_ms = 0.0;
+    double p95_ms = 0.0;
+    double max_ms = 0.0;
+
+    void print() const;
+};
+
+// Thread-safe LLMInterface over HTTP/1.1 keep-alive. One instance is shared
+// (std::shared_ptr) by the composer and closer of every controller; concurrent
+// requests are spread over the pooled connections, and at most
+// max_connections are in flight against the endpoint at once.
+class HttpLLMClient : public LLMInterface {
+private:
+    struct Connection {
+        int fd = -1;
+        bool reused = false;  // Came from the pool rather than a new connect()
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    // How one request/response on a connection ended
+    enum class Exchange {
+        COMPLETE,
+        CLOSED_BEFORE_RESPONSE,  // Peer closed/reset before any response byte: nothing was processed
+        FAILED                   // Timed out or broke mid-response: the request may have run
+    };
+
+    LLMEndpointConfig config;
+    PromptBuilder prompt_builder;  // For callers still using generateQuestion()
+
+    // Pool
+    std::vector<Connection> idle_connections;
+    int in_flight = 0;
+    mutable std::mutex pool_mutex;
+    std::condition_variable pool_condition;
+
+    // Metrics
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> connections_opened{0};
+    std::atomic<uint64_t> connections_reused{0};
+    std::atomic<uint64_t> connect_ns{0};
+    mutable std::mutex latency_mutex;
+    std::vector<double> latency_samples_ms;  // Ring
+    size_t next_sample = 0;
+
+    Connection acquire(bool fresh = false);  // fresh: skip the pool, always connect
+    void release(Connection connection, bool reusable);
+    Connection openConnection();
+    static bool isStale(const Connection& connection);
+    static void closeConnection(Connection& connection);
+
+    // One request/response on a connection
+    Exchange exchange(Connection& connection, const std::string& request, std::string& body, int& status);
+    std::string post(const std::string& json_body);
+    std::string completeText(const std::string& prompt, uint64_t prefix_id, size_t prefix_length, int max_tokens);
+    void recordLatency(double ms);
+
+public:
+    explicit HttpLLMClient(const LLMEndpointConfig& config);
+    ~HttpLLMClient() override;
+
+    HttpLLMClient(const HttpLLMClient&) = delete;
+    HttpLLMClient& operator=(const HttpLLMClient&) = delete;
+
+    // LLMInterface
+    std::string generateQuestion(const CompositionRequest& request) override;
+    std::string complete(const LLMPrompt& prompt) override;
+    float assessQuestionQuality(const std::string& question, const CompositionRequest& request) override;
+    bool isAvailable() override;  // Real probe: a pooled or fresh connection is reachable
+
+    // Open connections up to prewarm_connections
+    void prewarm();
+
+    LLMClientStats getStats() const;
+    const LLMEndpointConfig& getConfig() const { return config; }
+};
+
+#endif // HTTP_LLM_CLIENT_H
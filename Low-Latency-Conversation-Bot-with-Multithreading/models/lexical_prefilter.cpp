@@ -0,0 +1,289 @@
+#include "lexical_prefilter.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Keyword table: lowercase token -> keyword bit
+static const std::unordered_map<std::string_view, uint64_t>& keywordTable() {
+    static const std::unordered_map<std::string_view, uint64_t> table = {
+        // Weekdays
+        {"monday", KW_WEEKDAY}, {"mon", KW_WEEKDAY}, {"tuesday", KW_WEEKDAY}, {"tue", KW_WEEKDAY},
+        {"tues", KW_WEEKDAY}, {"wednesday", KW_WEEKDAY}, {"wed", KW_WEEKDAY}, {"thursday", KW_WEEKDAY},
+        {"thu", KW_WEEKDAY}, {"thurs", KW_WEEKDAY}, {"friday", KW_WEEKDAY}, {"fri", KW_WEEKDAY},
+        {"saturday", KW_WEEKDAY}, {"sat", KW_WEEKDAY}, {"sunday", KW_WEEKDAY}, {"sun", KW_WEEKDAY},
+        {"mondays", KW_WEEKDAY}, {"tuesdays", KW_WEEKDAY}, {"wednesdays", KW_WEEKDAY},
+        {"thursdays", KW_WEEKDAY}, {"fridays", KW_WEEKDAY}, {"saturdays", KW_WEEKDAY}, {"sundays", KW_WEEKDAY},
+        // Relative days
+        {"today", KW_RELATIVE_DAY}, {"tomorrow", KW_RELATIVE_DAY}, {"tonight", KW_RELATIVE_DAY | KW_TIME_OF_DAY},
+        {"weekend", KW_RELATIVE_DAY}, {"weekday", KW_RELATIVE_DAY}, {"next", KW_RELATIVE_DAY},
+        {"this", KW_RELATIVE_DAY | KW_NAME_CUE}, {"asap", KW_RELATIVE_DAY}, {"soon", KW_RELATIVE_DAY},
+        // Months
+        {"january", KW_MONTH}, {"jan", KW_MONTH}, {"february", KW_MONTH}, {"feb", KW_MONTH},
+        {"march", KW_MONTH}, {"mar", KW_MONTH}, {"april", KW_MONTH}, {"apr", KW_MONTH},
+        {"may", KW_MONTH}, {"june", KW_MONTH}, {"jun", KW_MONTH}, {"july", KW_MONTH}, {"jul", KW_MONTH},
+        {"august", KW_MONTH}, {"aug", KW_MONTH}, {"september", KW_MONTH}, {"sep", KW_MONTH},
+        {"sept", KW_MONTH}, {"october", KW_MONTH}, {"oct", KW_MONTH}, {"november", KW_MONTH},
+        {"nov", KW_MONTH}, {"december", KW_MONTH}, {"dec", KW_MONTH},
+        // Date words
+        {"date", KW_DATE}, {"day", KW_DATE}, {"days", KW_DATE}, {"week", KW_DATE}, {"weeks", KW_DATE},
+        {"first", KW_DATE}, {"second", KW_DATE}, {"third", KW_DATE}, {"fourth", KW_DATE}, {"fifth", KW_DATE},
+        {"sixth", KW_DATE}, {"seventh", KW_DATE}, {"eighth", KW_DATE}, {"ninth", KW_DATE}, {"tenth", KW_DATE},
+        {"eleventh", KW_DATE}, {"twelfth", KW_DATE}, {"thirteenth", KW_DATE}, {"fourteenth", KW_DATE},
+        {"fifteenth", KW_DATE}, {"sixteenth", KW_DATE}, {"seventeenth", KW_DATE}, {"eighteenth", KW_DATE},
+        {"nineteenth", KW_DATE}, {"twentieth", KW_DATE}, {"thirtieth", KW_DATE},
+        // Times of day
+        {"morning", KW_TIME_OF_DAY}, {"mornings", KW_TIME_OF_DAY}, {"afternoon", KW_TIME_OF_DAY},
+        {"afternoons", KW_TIME_OF_DAY}, {"evening", KW_TIME_OF_DAY}, {"evenings", KW_TIME_OF_DAY},
+        {"night", KW_TIME_OF_DAY}, {"noon", KW_TIME_OF_DAY}, {"midday", KW_TIME_OF_DAY},
+        {"lunch", KW_TIME_OF_DAY}, {"lunchtime", KW_TIME_OF_DAY}, {"early", KW_TIME_OF_DAY},
+        {"late", KW_TIME_OF_DAY}, {"later", KW_TIME_OF_DAY}, {"anytime", KW_TIME_OF_DAY},
+        // Meridiem / clock
+        {"am", KW_MERIDIEM}, {"pm", KW_MERIDIEM}, {"a.m", KW_MERIDIEM}, {"p.m", KW_MERIDIEM},
+        {"o'clock", KW_CLOCK}, {"oclock", KW_CLOCK}, {"hour", KW_CLOCK}, {"hours", KW_CLOCK},
+        {"half", KW_CLOCK}, {"quarter", KW_CLOCK}, {"thirty", KW_CLOCK | KW_SPOKEN_NUMBER},
+        {"fifteen", KW_CLOCK | KW_SPOKEN_NUMBER}, {"fortyfive", KW_CLOCK},
+        // Spoken numbers
+        {"zero", KW_SPOKEN_NUMBER}, {"oh", KW_SPOKEN_NUMBER}, {"one", KW_SPOKEN_NUMBER},
+        {"two", KW_SPOKEN_NUMBER}, {"three", KW_SPOKEN_NUMBER}, {"four", KW_SPOKEN_NUMBER},
+        {"five", KW_SPOKEN_NUMBER}, {"six", KW_SPOKEN_NUMBER}, {"seven", KW_SPOKEN_NUMBER},
+        {"eight", KW_SPOKEN_NUMBER}, {"nine", KW_SPOKEN_NUMBER}, {"ten", KW_SPOKEN_NUMBER},
+        {"eleven", KW_SPOKEN_NUMBER}, {"twelve", KW_SPOKEN_NUMBER},
+        // Services
+        {"haircut", KW_SERVICE}, {"haircuts", KW_SERVICE}, {"cut", KW_SERVICE}, {"trim", KW_SERVICE},
+        {"color", KW_SERVICE}, {"colour", KW_SERVICE}, {"coloring", KW_SERVICE}, {"dye", KW_SERVICE},
+        {"highlights", KW_SERVICE}, {"lowlights", KW_SERVICE}, {"balayage", KW_SERVICE},
+        {"blowout", KW_SERVICE}, {"blowdry", KW_SERVICE}, {"blow", KW_SERVICE}, {"style", KW_SERVICE},
+        {"styling", KW_SERVICE}, {"updo", KW_SERVICE}, {"perm", KW_SERVICE}, {"keratin", KW_SERVICE},
+        {"straightening", KW_SERVICE}, {"extensions", KW_SERVICE}, {"braids", KW_SERVICE},
+        {"braiding", KW_SERVICE}, {"shave", KW_SERVICE}, {"beard", KW_SERVICE}, {"wash", KW_SERVICE},
+        {"shampoo", KW_SERVICE}, {"treatment", KW_SERVICE}, {"manicure", KW_SERVICE},
+        {"pedicure", KW_SERVICE}, {"nails", KW_SERVICE}, {"wax", KW_SERVICE}, {"waxing", KW_SERVICE},
+        {"facial", KW_SERVICE}, {"massage", KW_SERVICE}, {"service", KW_SERVICE}, {"fade", KW_SERVICE},
+        // Name cues
+        {"name", KW_NAME_CUE}, {"i'm", KW_NAME_CUE}, {"im", KW_NAME_CUE}, {"call", KW_NAME_CUE},
+        {"called", KW_NAME_CUE}, {"it's", KW_NAME_CUE}, {"mr", KW_NAME_CUE}, {"mrs", KW_NAME_CUE},
+        {"ms", KW_NAME_CUE}
+    };
+    return table;
+}
+
+uint64_t LexicalPrefilter::lookupKeyword(std::string_view token) {
+    const auto& table = keywordTable();
+    auto it = table.find(token);
+    if (it != table.end()) {
+        return it->second;
+    }
+
+    // Numeric tokens with a suffix: "15th" is a date, "2pm" a time
+    size_t digits = 0;
+    while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9') digits++;
+    if (digits == 0 || digits == token.size()) {
+        return 0;
+    }
+    std::string_view suffix = token.substr(digits);
+    if (suffix == "st" || suffix == "nd" || suffix == "rd" || suffix == "th") return KW_DATE;
+    if (suffix == "am" || suffix == "pm" || suffix == "a.m" || suffix == "p.m") return KW_MERIDIEM;
+    return 0;
+}
+
+// Counts digits/uppercase and flags non-ASCII, '/' and ':' in one pass
+static void scanByteClasses(const char* data, size_t size, LexicalFeatures& features,
+                            bool& has_slash, bool& has_colon) {
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i below_zero = _mm_set1_epi8('0' - 1);
+    const __m128i above_nine = _mm_set1_epi8('9' + 1);
+    const __m128i below_a = _mm_set1_epi8('A' - 1);
+    const __m128i above_z = _mm_set1_epi8('Z' + 1);
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i colon = _mm_set1_epi8(':');
+
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        // Signed compares: bytes >= 0x80 are negative and fall outside both ranges
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, below_zero), _mm_cmplt_epi8(v, above_nine));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, below_a), _mm_cmplt_epi8(v, above_z));
+
+        features.digit_count += __builtin_popcount(_mm_movemask_epi8(digit));
+        features.upper_count += __builtin_popcount(_mm_movemask_epi8(upper));
+        features.has_non_ascii |= _mm_movemask_epi8(v) != 0;
+        has_slash |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, slash)) != 0;
+        has_colon |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, colon)) != 0;
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t ones = vdupq_n_u8(1);
+
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+
+        uint8x16_t digit = vandq_u8(vcgeq_u8(v, vdupq_n_u8('0')), vcleq_u8(v, vdupq_n_u8('9')));
+        uint8x16_t upper = vandq_u8(vcgeq_u8(v, vdupq_n_u8('A')), vcleq_u8(v, vdupq_n_u8('Z')));
+
+        features.digit_count += vaddvq_u8(vandq_u8(digit, ones));
+        features.upper_count += vaddvq_u8(vandq_u8(upper, ones));
+        features.has_non_ascii |= vmaxvq_u8(v) >= 0x80;
+        has_slash |= vmaxvq_u8(vceqq_u8(v, vdupq_n_u8('/'))) != 0;
+        has_colon |= vmaxvq_u8(vceqq_u8(v, vdupq_n_u8(':'))) != 0;
+    }
+#endif
+
+    // Scalar tail (and fallback)
+    for (; i < size; i++) {
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c >= '0' && c <= '9') features.digit_count++;
+        else if (c >= 'A' && c <= 'Z') features.upper_count++;
+        else if (c >= 0x80) features.has_non_ascii = true;
+        else if (c == '/') has_slash = true;
+        else if (c == ':') has_colon = true;
+    }
+}
+
+LexicalFeatures LexicalPrefilter::scan(const std::string& sentence) {
+    LexicalFeatures features;
+    bool has_slash = false;
+    bool has_colon = false;
+
+    scanByteClasses(sentence.data(), sentence.size(), features, has_slash, has_colon);
+
+    if (features.digit_count > 0) {
+        if (has_slash) features.keywords |= KW_DATE;   // 3/14
+        if (has_colon) features.keywords |= KW_CLOCK;  // 2:30
+    }
+
+    // Keyword bitmap over lowercase ASCII tokens (letters, digits, ' and .)
+    char token[24];
+    size_t length = 0;
+    bool overflow = false;
+
+    auto flush = [&]() {
+        if (length > 0 && !overflow) {
+            // Trailing dots ("p.m.") are not part of the keyword
+            while (length > 0 && token[length - 1] == '.') length--;
+            features.keywords |= lookupKeyword(std::string_view(token, length));
+        }
+        length = 0;
+        overflow = false;
+    };
+
+    for (char raw : sentence) {
+        unsigned char c = static_cast<unsigned char>(raw);
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool digit = c >= '0' && c <= '9';
+
+        if (alpha || digit || c == '\'' || (c == '.' && length > 0)) {
+            if (length < sizeof(token)) {
+                token[length++] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : static_cast<char>(c);
+            } else {
+                overflow = true;
+            }
+        } else {
+            flush();
+        }
+    }
+    flush();
+
+    return features;
+}
+
+LexicalPrefilter::LexicalPrefilter() {
+    auto add = [this](const std::string& entity, bool enabled, int min_digits, uint64_t keywords) {
+        auto state = std::make_unique<GateState>();
+        state->enabled = enabled;
+        state->min_digits = min_digits;
+        state->any_keywords = keywords;
+        gates[entity] = std::move(state);
+    };
+
+    // Names have no cheap lexical signature ("john" is just a word), so the
+    // caller_name head always runs unless this gate is explicitly enabled
+    add("caller_name", false, 0, KW_NAME_CUE);
+    add("phone_number", true, 3, KW_SPOKEN_NUMBER);
+    add("day_preference", true, 0, KW_WEEKDAY | KW_RELATIVE_DAY | KW_MONTH | KW_DATE);
+    add("time_preference", true, 1, KW_TIME_OF_DAY | KW_MERIDIEM | KW_CLOCK | KW_SPOKEN_NUMBER);
+    add("service_type", true, 0, KW_SERVICE);
+}
+
+bool LexicalPrefilter::mayContain(const LexicalFeatures& features, const std::string& entity_type) const {
+    auto it = gates.find(entity_type);
+    if (it == gates.end() || !it->second->enabled) {
+        return true;
+    }
+
+    int min_digits = it->second->min_digits;
+    uint64_t any_keywords = it->second->any_keywords;
+    if (min_digits <= 0 && any_keywords == 0) {
+        return true;
+    }
+
+    return (min_digits > 0 && features.digit_count >= min_digits) ||
+           (features.keywords & any_keywords) != 0;
+}
+
+bool LexicalPrefilter::admit(const LexicalFeatures& features, const std::string& entity_type) {
+    bool may_contain = mayContain(features, entity_type);
+
+    auto it = gates.find(entity_type);
+    if (it != gates.end()) {
+        it->second->evaluated++;
+        if (!may_contain) it->second->skipped++;
+    }
+
+    return may_contain;
+}
+
+bool LexicalPrefilter::setGate(const std::string& entity_type, const EntityGate& gate) {
+    auto it = gates.find(entity_type);
+    if (it == gates.end()) {
+        return false;
+    }
+    it->second->min_digits = gate.min_digits;
+    it->second->any_keywords = gate.any_keywords;
+    it->second->enabled = gate.enabled;
+    return true;
+}
+
+EntityGate LexicalPrefilter::getGate(const std::string& entity_type) const {
+    EntityGate gate;
+    auto it = gates.find(entity_type);
+    if (it == gates.end()) {
+        gate.enabled = false;
+        return gate;
+    }
+    gate.enabled = it->second->enabled;
+    gate.min_digits = it->second->min_digits;
+    gate.any_keywords = it->second->any_keywords;
+    return gate;
+}
+
+bool LexicalPrefilter::setGateEnabled(const std::string& entity_type, bool enabled) {
+    auto it = gates.find(entity_type);
+    if (it == gates.end()) {
+        return false;
+    }
+    it->second->enabled = enabled;
+    return true;
+}
+
+std::unordered_map<std::string, PrefilterEntityStats> LexicalPrefilter::getStats() const {
+    std::unordered_map<std::string, PrefilterEntityStats> stats;
+    for (const auto& pair : gates) {
+        PrefilterEntityStats entity_stats;
+        entity_stats.evaluated = pair.second->evaluated.load();
+        entity_stats.skipped = pair.second->skipped.load();
+        stats[pair.first] = entity_stats;
+    }
+    return stats;
+}
+
+void LexicalPrefilter::resetStats() {
+    for (auto& pair : gates) {
+        pair.second->evaluated = 0;
+        pair.second->skipped = 0;
+    }
+}
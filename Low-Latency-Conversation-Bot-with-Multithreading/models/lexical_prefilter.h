@@ -0,0 +1,93 @@
+#ifndef LEXICAL_PREFILTER_H
+#define LEXICAL_PREFILTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// Keyword groups recognised by the pre-filter (one bit each)
+enum LexicalKeyword : uint64_t {
+    KW_WEEKDAY       = 1ull << 0,   // monday, fri, ...
+    KW_RELATIVE_DAY  = 1ull << 1,   // today, tomorrow, weekend, next
+    KW_MONTH         = 1ull << 2,   // january, dec, ...
+    KW_DATE          = 1ull << 3,   // date, day, week, 15th, 3/14
+    KW_TIME_OF_DAY   = 1ull << 4,   // morning, afternoon, noon, ...
+    KW_MERIDIEM      = 1ull << 5,   // am, pm, 2pm
+    KW_CLOCK         = 1ull << 6,   // o'clock, hour, half, quarter
+    KW_SPOKEN_NUMBER = 1ull << 7,   // zero .. twelve, oh
+    KW_SERVICE       = 1ull << 8,   // haircut, color, trim, ...
+    KW_NAME_CUE      = 1ull << 9    // name, i'm, this, call
+};
+
+// What one linear scan of the sentence found
+struct LexicalFeatures {
+    int digit_count = 0;
+    int upper_count = 0;
+    bool has_non_ascii = false;
+    uint64_t keywords = 0;
+};
+
+// Per-entity rule: the SVM head runs if the sentence has at least
+// min_digits digits OR any of the keyword bits. A disabled gate (or one
+// with no criteria) always runs the head.
+struct EntityGate {
+    bool enabled = true;
+    int min_digits = 0;
+    uint64_t any_keywords = 0;
+};
+
+// Skip counters for one entity head
+struct PrefilterEntityStats {
+    uint64_t evaluated = 0;
+    uint64_t skipped = 0;
+
+    float skipRate() const {
+        return evaluated == 0 ? 0.0f : static_cast<float>(skipped) / evaluated;
+    }
+};
+
+// Cheap cascade stage in front of the SVM heads: a vectorized byte-class
+// scan plus a keyword bitmap decide which heads cannot possibly fire.
+class LexicalPrefilter {
+private:
+    // Fields are atomic so gates can be retuned while turns are running
+    struct GateState {
+        std::atomic<bool> enabled{true};
+        std::atomic<int> min_digits{0};
+        std::atomic<uint64_t> any_keywords{0};
+        std::atomic<uint64_t> evaluated{0};
+        std::atomic<uint64_t> skipped{0};
+    };
+
+    // One entry per entity type, created in the constructor and never rehashed
+    std::unordered_map<std::string, std::unique_ptr<GateState>> gates;
+
+    static uint64_t lookupKeyword(std::string_view token);
+
+public:
+    LexicalPrefilter();
+
+    // Byte-class scan (SSE2/NEON with scalar fallback) + keyword bitmap
+    static LexicalFeatures scan(const std::string& sentence);
+
+    // Whether the entity's head may fire for these features (no stats)
+    bool mayContain(const LexicalFeatures& features, const std::string& entity_type) const;
+
+    // Same, recording evaluated/skipped counts for the entity
+    bool admit(const LexicalFeatures& features, const std::string& entity_type);
+
+    // Configuration (known entity types only)
+    bool setGate(const std::string& entity_type, const EntityGate& gate);
+    EntityGate getGate(const std::string& entity_type) const;
+    bool setGateEnabled(const std::string& entity_type, bool enabled);
+
+    // Statistics
+    std::unordered_map<std::string, PrefilterEntityStats> getStats() const;
+    void resetStats();
+};
+
+#endif // LEXICAL_PREFILTER_H
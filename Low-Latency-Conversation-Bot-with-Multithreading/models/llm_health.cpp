@@ -0,0 +1,178 @@
+#include "llm_health.h"
+#include "composer.h"  // For LLMInterface
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <stdexcept>
+
+// Weight of the newest call in the latency average
+static constexpr double kLatencyAlpha = 0.2;
+
+const char* toString(CircuitState state) {
+    switch (state) {
+        case CircuitState::CLOSED:    return "closed";
+        case CircuitState::OPEN:      return "open";
+        case CircuitState::HALF_OPEN: return "half_open";
+    }
+    return "unknown";
+}
+
+void CircuitBreakerStats::print() const {
+    std::cout << "\n🩺 LLM Circuit Breaker:" << std::endl;
+    std::cout << "  State: " << toString(state) << " (" << trips << " trips)" << std::endl;
+    std::cout << "  Calls: " << calls << " (" << failures << " failed), " << rejected << " sent to templates" << std::endl;
+    std::cout << "  Probes: " << probes << " (" << failed_probes << " failed)" << std::endl;
+    std::cout << "  Latency EWMA: " << std::fixed << std::setprecision(1) << latency_ewma_ms << "ms" << std::endl;
+}
+
+LLMCircuitBreaker::LLMCircuitBreaker(std::shared_ptr<LLMInterface> llm, const CircuitBreakerConfig& config)
+    : llm(std::move(llm)), config(config) {
+    if (!this->llm) {
+        throw std::runtime_error("LLMCircuitBreaker needs an LLM interface");
+    }
+    prober = std::thread(&LLMCircuitBreaker::probeLoop, this);
+}
+
+LLMCircuitBreaker::~LLMCircuitBreaker() {
+    {
+        std::lock_guard<std::mutex> lock(prober_mutex);
+        stop_prober = true;
+    }
+    prober_condition.notify_all();
+    if (prober.joinable()) {
+        prober.join();
+    }
+}
+
+std::shared_ptr<LLMCircuitBreaker> LLMCircuitBreaker::attach(std::shared_ptr<LLMInterface> llm,
+                                                             const CircuitBreakerConfig& config) {
+    static std::mutex registry_mutex;
+    static std::unordered_map<const LLMInterface*, std::weak_ptr<LLMCircuitBreaker>> registry;
+
+    if (!llm) return nullptr;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto& entry = registry[llm.get()];
+    if (auto existing = entry.lock()) {
+        return existing;
+    }
+
+    auto breaker = std::make_shared<LLMCircuitBreaker>(std::move(llm), config);
+    entry = breaker;
+    return breaker;
+}
+
+void LLMCircuitBreaker::probeLoop() {
+    std::unique_lock<std::mutex> lock(prober_mutex);
+    while (!stop_prober) {
+        lock.unlock();
+        probeOnce();
+        lock.lock();
+        prober_condition.wait_for(lock, config.probe_interval, [this] { return stop_prober; });
+    }
+}
+
+void LLMCircuitBreaker::probeOnce() {
+    // An OPEN breaker is left alone until its cooldown is over
+    if (state.load() == CircuitState::OPEN) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (std::chrono::steady_clock::now() - opened_at < config.open_cooldown) return;
+    }
+
+    bool available = false;
+    try {
+        available = llm->isAvailable();
+    } catch (const std::exception& e) {
+        std::cerr << "LLM probe failed: " << e.what() << std::endl;
+    }
+
+    probes++;
+    if (!available) failed_probes++;
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+    CircuitState current = state.load();
+
+    if (!available) {
+        if (current == CircuitState::OPEN) {
+            opened_at = std::chrono::steady_clock::now();  // Wait another cooldown
+        } else {
+            trip("probe failed");
+        }
+    } else if (current == CircuitState::OPEN) {
+        half_open_passes = 0;
+        half_open_epoch++;
+        trial_in_flight = false;
+        state = CircuitState::HALF_OPEN;
+        std::cout << "🩺 LLM probe passed, circuit half-open" << std::endl;
+    }
+}
+
+void LLMCircuitBreaker::trip(const char* reason) {
+    opened_at = std::chrono::steady_clock::now();
+    consecutive_failures = 0;
+    half_open_passes = 0;
+    latency_ewma_ms = 0.0;
+    trial_in_flight = false;
+
+    if (state.exchange(CircuitState::OPEN) != CircuitState::OPEN) {
+        trips++;
+        std::cout << "🩺 LLM circuit open (" << reason << "), using templates" << std::endl;
+    }
+}
+
+void LLMCircuitBreaker::recordResult(const CircuitAdmission& admission, bool success, double latency_ms) {
+    calls++;
+    bool slow = latency_ms > config.slow_call_ms;
+    if (!success || slow) failures++;
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+    CircuitState current = state.load();
+
+    if (admission.trial) {
+        // A trial from an earlier half-open period finishing late changes
+        // nothing; its trial_in_flight was reset by the transition since
+        if (current != CircuitState::HALF_OPEN || admission.epoch != half_open_epoch.load()) return;
+
+        trial_in_flight = false;
+        if (!success || slow) {
+            trip("half-open trial failed");
+        } else if (++half_open_passes >= config.half_open_successes) {
+            consecutive_failures = 0;
+            latency_ewma_ms = latency_ms;
+            state = CircuitState::CLOSED;
+            std::cout << "🩺 LLM circuit closed" << std::endl;
+        }
+        return;
+    }
+
+    // A call admitted before the circuit opened finishing late changes
+    // nothing, even once the breaker is half-open and waiting on its trial
+    if (current != CircuitState::CLOSED) return;
+
+    if (success) {
+        latency_ewma_ms = latency_ewma_ms == 0.0 ? latency_ms
+                                                 : kLatencyAlpha * latency_ms + (1.0 - kLatencyAlpha) * latency_ewma_ms;
+    }
+    consecutive_failures = (!success || slow) ? consecutive_failures + 1 : 0;
+
+    if (consecutive_failures >= config.failure_threshold) {
+        trip(success ? "slow calls" : "call errors");
+    } else if (latency_ewma_ms > config.latency_trip_ms) {
+        trip("latency");
+    }
+}
+
+CircuitBreakerStats LLMCircuitBreaker::getStats() {
+    CircuitBreakerStats stats;
+    stats.state = state.load();
+    stats.calls = calls.load();
+    stats.failures = failures.load();
+    stats.rejected = rejected.load();
+    stats.trips = trips.load();
+    stats.probes = probes.load();
+    stats.failed_probes = failed_probes.load();
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+    stats.latency_ewma_ms = latency_ewma_ms;
+    return stats;
+}
@@ -0,0 +1,140 @@
+#ifndef LLM_HEALTH_H
+#define LLM_HEALTH_H
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class LLMInterface;
+
+enum class CircuitState : uint8_t {
+    CLOSED,     // LLM healthy, every request goes through
+    OPEN,       // LLM degraded, crews go straight to templates
+    HALF_OPEN   // Cooling down done and the probe passed: one trial call at a time
+};
+
+struct CircuitBreakerConfig {
+    std::chrono::milliseconds probe_interval{1000};  // Background isAvailable() cadence
+    std::chrono::milliseconds open_cooldown{5000};   // Time OPEN before probing for HALF_OPEN
+    int failure_threshold = 3;        // Consecutive failed/slow calls that trip the breaker
+    double slow_call_ms = 2000.0;     // A call slower than this counts as a failure
+    double latency_trip_ms = 1200.0;  // Latency EWMA over this trips the breaker too
+    int half_open_successes = 2;      // Trial successes needed to close again
+};
+
+struct CircuitBreakerStats {
+    CircuitState state = CircuitState::CLOSED;
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t rejected = 0;  // Requests sent to templates while OPEN
+    uint64_t trips = 0;
+    uint64_t probes = 0;
+    uint64_t failed_probes = 0;
+    double latency_ewma_ms = 0.0;
+
+    void print() const;
+};
+
+// What allowRequest() let through. A trial admission is the one HALF_OPEN
+// call whose result decides the circuit; the epoch ties it to the half-open
+// period it was admitted in.
+struct CircuitAdmission {
+    bool allowed = false;
+    bool trial = false;
+    uint64_t epoch = 0;
+
+    explicit operator bool() const { return allowed; }
+};
+
+// Availability of one LLMInterface, tracked off the request path.
+//
+// A background thread calls llm->isAvailable() every probe_interval, and the
+// crews report each real call's latency and outcome. Too many consecutive
+// failed or slow calls, a high latency average or a failed probe open the
+// circuit; after open_cooldown a passing probe moves it to HALF_OPEN, where
+// single trial calls decide between CLOSED and OPEN again.
+//
+// Crews only ever do an atomic load in allowRequest(), so a healthy LLM costs
+// nothing extra per request and a degraded one is skipped without waiting.
+class LLMCircuitBreaker {
+private:
+    std::shared_ptr<LLMInterface> llm;
+    CircuitBreakerConfig config;
+
+    std::atomic<CircuitState> state{CircuitState::CLOSED};
+    std::atomic<bool> trial_in_flight{false};
+    std::atomic<uint64_t> half_open_epoch{0};  // Bumped on every move to HALF_OPEN
+
+    // Transition bookkeeping (not on the request path)
+    std::mutex state_mutex;
+    int consecutive_failures = 0;
+    int half_open_passes = 0;
+    double latency_ewma_ms = 0.0;
+    std::chrono::steady_clock::time_point opened_at;
+
+    // Stats
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> trips{0};
+    std::atomic<uint64_t> probes{0};
+    std::atomic<uint64_t> failed_probes{0};
+
+    // Prober
+    std::thread prober;
+    std::mutex prober_mutex;
+    std::condition_variable prober_condition;
+    bool stop_prober = false;
+
+    void probeLoop();
+    void probeOnce();
+    void trip(const char* reason);  // Caller holds state_mutex
+
+public:
+    LLMCircuitBreaker(std::shared_ptr<LLMInterface> llm, const CircuitBreakerConfig& config = CircuitBreakerConfig());
+    ~LLMCircuitBreaker();
+
+    LLMCircuitBreaker(const LLMCircuitBreaker&) = delete;
+    LLMCircuitBreaker& operator=(const LLMCircuitBreaker&) = delete;
+
+    // The breaker for `llm`, shared by every crew using the same interface
+    // (so one prober per LLM); config only applies when it is first created
+    static std::shared_ptr<LLMCircuitBreaker> attach(std::shared_ptr<LLMInterface> llm,
+                                                     const CircuitBreakerConfig& config = CircuitBreakerConfig());
+
+    // Whether to call the LLM now. In HALF_OPEN only one caller at a time is
+    // admitted, as the trial, and it must report back with recordResult().
+    CircuitAdmission allowRequest() {
+        CircuitAdmission admission;
+        CircuitState current = state.load(std::memory_order_acquire);
+        if (current == CircuitState::CLOSED) {
+            admission.allowed = true;
+            return admission;
+        }
+        if (current == CircuitState::HALF_OPEN && !trial_in_flight.exchange(true, std::memory_order_acq_rel)) {
+            admission.allowed = true;
+            admission.trial = true;
+            admission.epoch = half_open_epoch.load(std::memory_order_acquire);
+            return admission;
+        }
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        return admission;
+    }
+
+    // Outcome of a call admitted by allowRequest(). Only the trial admitted in
+    // the current half-open period moves the circuit out of HALF_OPEN; calls
+    // admitted while CLOSED only count while it is still CLOSED.
+    void recordResult(const CircuitAdmission& admission, bool success, double latency_ms);
+
+    CircuitState getState() const { return state.load(std::memory_order_acquire); }
+    CircuitBreakerStats getStats();
+};
+
+const char* toString(CircuitState state);
+
+#endif // LLM_HEALTH_H
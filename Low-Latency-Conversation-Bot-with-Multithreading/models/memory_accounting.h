@@ -0,0 +1,114 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+
+// Estimated heap bytes owned by a value (its own sizeof is counted by the
+// container holding it). Estimates follow libstdc++/libc++ layouts closely
+// enough to spot growth; they are not allocator-exact.
+
+inline size_t heapBytes(const std::string& text) {
+    // Short strings live inline (SSO)
+    static const size_t inline_capacity = std::string().capacity();
+    return text.capacity() > inline_capacity ? text.capacity() + 1 : 0;
+}
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, size_t>::type
+heapBytes(const T&) {
+    return 0;
+}
+
+template <typename T>
+size_t heapBytes(const std::vector<T>& values);
+
+template <typename K, typename V>
+size_t heapBytes(const std::unordered_map<K, V>& map);
+
+template <typename T>
+size_t heapBytes(const std::vector<T>& values) {
+    size_t bytes = values.capacity() * sizeof(T);
+    for (const auto& value : values) {
+        bytes += heapBytes(value);
+    }
+    return bytes;
+}
+
+template <typename K, typename V>
+size_t heapBytes(const std::unordered_map<K, V>& map) {
+    // Bucket array plus one node (next pointer + cached hash + pair) per entry
+    size_t bytes = map.bucket_count() * sizeof(void*);
+    bytes += map.size() * (sizeof(std::pair<const K, V>) + 2 * sizeof(void*));
+    for (const auto& entry : map) {
+        bytes += heapBytes(entry.first) + heapBytes(entry.second);
+    }
+    return bytes;
+}
+
+// Bytes and live objects attributed to one named component
+struct MemoryAccount {
+    std::string component;  // Dotted name, e.g. "extractor.vocabularies"
+    size_t bytes = 0;
+    size_t objects = 0;
+};
+
+// Accounting hooks append to a report; reports from several owners (e.g.
+// one per session controller) merge by component name
+class MemoryReport {
+private:
+    std::vector<MemoryAccount> accounts;
+
+public:
+    void add(const std::string& component, size_t bytes, size_t objects) {
+        for (auto& account : accounts) {
+            if (account.component == component) {
+                account.bytes += bytes;
+                account.objects += objects;
+                return;
+            }
+        }
+        accounts.push_back(MemoryAccount{component, bytes, objects});
+    }
+
+    void merge(const MemoryReport& other) {
+        for (const auto& account : other.accounts) {
+            add(account.component, account.bytes, account.objects);
+        }
+    }
+
+    size_t totalBytes() const {
+        size_t total = 0;
+        for (const auto& account : accounts) total += account.bytes;
+        return total;
+    }
+
+    // Sorted by component name
+    std::vector<MemoryAccount> getAccounts() const {
+        std::vector<MemoryAccount> sorted = accounts;
+        std::sort(sorted.begin(), sorted.end(), [](const MemoryAccount& a, const MemoryAccount& b) {
+            return a.component < b.component;
+        });
+        return sorted;
+    }
+
+    void print() const {
+        const double kb = 1024.0;
+        std::cout << "\n🧮 Memory Accounting:" << std::endl;
+        for (const auto& account : getAccounts()) {
+            std::cout << "  " << std::left << std::setw(32) << account.component << std::right
+                      << std::fixed << std::setprecision(1) << std::setw(12) << account.bytes / kb << " KB"
+                      << std::setw(10) << account.objects << " objects" << std::endl;
+        }
+        std::cout << "  " << std::left << std::setw(32) << "total" << std::right
+                  << std::setw(12) << totalBytes() / kb << " KB" << std::endl;
+    }
+};
+
+#endif // MEMORY_ACCOUNTING_H
@@ -0,0 +1,51 @@
+#ifndef MODEL_PRECISION_H
+#define MODEL_PRECISION_H
+
+#include <string>
+#include <fstream>
+
+// Numeric precision of an ONNX model variant.
+// INT8 variants are produced offline with onnxruntime.quantization
+// (quantize_dynamic / quantize_static) and sit next to the FP32 file:
+//   caller_name_svm.onnx              -> FP32
+//   caller_name_svm_int8_dynamic.onnx -> INT8, dynamic quantization
+//   caller_name_svm_int8_static.onnx  -> INT8, static (calibrated) quantization
+enum class ModelPrecision {
+    FP32,
+    INT8_DYNAMIC,
+    INT8_STATIC
+};
+
+inline const char* modelPrecisionName(ModelPrecision precision) {
+    switch (precision) {
+        case ModelPrecision::INT8_DYNAMIC: return "int8_dynamic";
+        case ModelPrecision::INT8_STATIC: return "int8_static";
+        default: return "fp32";
+    }
+}
+
+inline bool isQuantized(ModelPrecision precision) {
+    return precision != ModelPrecision::FP32;
+}
+
+// Build the on-disk path of a model variant, e.g.
+// modelVariantPath("./models/svm", "phone_number", "svm", INT8_STATIC)
+//   -> "./models/svm/phone_number_svm_int8_static.onnx"
+inline std::string modelVariantPath(const std::string& models_dir,
+                                    const std::string& entity,
+                                    const std::string& kind,
+                                    ModelPrecision precision) {
+    std::string path = models_dir + "/" + entity + "_" + kind;
+    if (isQuantized(precision)) {
+        path += "_";
+        path += modelPrecisionName(precision);
+    }
+    return path + ".onnx";
+}
+
+inline bool modelFileExists(const std::string& path) {
+    std::ifstream file(path);
+    return file.good();
+}
+
+#endif // MODEL_PRECISION_H
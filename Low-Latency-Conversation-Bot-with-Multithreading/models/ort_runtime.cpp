@@ -0,0 +1,308 @@
+#include "ort_runtime.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+size_t processResidentBytes() {
+#ifdef __APPLE__
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return info.resident_size;
+    }
+    return 0;
+#else
+    long pages = 0, resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    std::fclose(statm);
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+size_t processPeakResidentBytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);         // Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // Kilobytes on Linux
+#endif
+}
+
+static int64_t steadyMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long envNumber(const char* name, long fallback) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) return fallback;
+    char* end = nullptr;
+    long parsed = std::strtol(value, &end, 10);
+    return (end && *end == '\0') ? parsed : fallback;
+}
+
+OrtMemoryConfig OrtMemoryConfig::fromEnvironment() {
+    OrtMemoryConfig config;
+    config.shared_arena = envNumber("ORT_SHARED_ARENA", config.shared_arena) != 0;
+    config.arena_extend_strategy = static_cast<int>(envNumber("ORT_ARENA_EXTEND_STRATEGY", config.arena_extend_strategy));
+    config.arena_max_bytes = static_cast<size_t>(envNumber("ORT_ARENA_MAX_MB", 0)) * 1024 * 1024;
+    config.enable_cpu_mem_arena = envNumber("ORT_CPU_MEM_ARENA", config.enable_cpu_mem_arena) != 0;
+    config.enable_mem_pattern = envNumber("ORT_MEM_PATTERN", config.enable_mem_pattern) != 0;
+    config.shrink_interval = std::chrono::milliseconds(envNumber("ORT_SHRINK_INTERVAL_MS", config.shrink_interval.count()));
+    config.shrink_rss_threshold_bytes = static_cast<size_t>(envNumber("ORT_SHRINK_RSS_MB", 0)) * 1024 * 1024;
+    config.burst_concurrency = static_cast<int>(envNumber("ORT_BURST_RUNS", config.burst_concurrency));
+    return config;
+}
+
+OrtRuntime::OrtRuntime() 
+    : env{ORT_LOGGING_LEVEL_WARNING, "ConversationBot"}, config(OrtMemoryConfig::fromEnvironment()) {
+    last_shrink_ms = steadyMillis();
+    publishShrinkPolicy();
+}
+
+OrtRuntime& OrtRuntime::instance() {
+    static OrtRuntime runtime;
+    return runtime;
+}
+
+void OrtRuntime::configure(const OrtMemoryConfig& new_config) {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    
+    if (arena_registered) {
+        // Sessions already share the arena; only the shrink policy can change
+        std::cerr << "⚠️ ORT arena already created, applying shrink settings only" << std::endl;
+        config.shrink_interval = new_config.shrink_interval;
+        config.shrink_rss_threshold_bytes = new_config.shrink_rss_threshold_bytes;
+        config.burst_concurrency = new_config.burst_concurrency;
+        publishShrinkPolicy();
+        return;
+    }
+    config = new_config;
+    publishShrinkPolicy();
+}
+
+void OrtRuntime::publishShrinkPolicy() {
+    shrink_arena = config.enable_cpu_mem_arena;
+    shrink_interval_ms = config.shrink_interval.count();
+    shrink_rss_threshold_bytes = config.shrink_rss_threshold_bytes;
+    burst_concurrency = config.burst_concurrency;
+}
+
+OrtMemoryConfig OrtRuntime::getConfig() const {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    return config;
+}
+
+// Caller holds config_mutex
+void OrtRuntime::registerSharedArena() {
+    if (arena_registered) return;
+    arena_registered = true;
+    
+    if (!config.shared_arena || !config.enable_cpu_mem_arena) return;
+    
+    try {
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        Ort::ArenaCfg arena_cfg(config.arena_max_bytes, config.arena_extend_strategy,
+                                config.arena_initial_chunk_bytes, config.arena_max_dead_bytes_per_chunk);
+        env.CreateAndRegisterAllocator(memory_info, arena_cfg);
+        std::cout << "🧠 Shared ORT CPU arena registered (extend strategy " << config.arena_extend_strategy 
+                  << ", max " << (config.arena_max_bytes ? std::to_string(config.arena_max_bytes / (1024 * 1024)) + "MB" : "unlimited") 
+                  << ")" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Failed to register shared ORT arena, using per-session arenas: " << e.what() << std::endl;
+        config.shared_arena = false;
+    }
+}
+
+std::unique_ptr<Ort::Session> OrtRuntime::createSession(const std::string& model_path, const std::string& model_name,
+                                                        size_t& model_id) {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(1);
+    session_options.SetGraphOptimizationLevel(ORT_ENABLE_ALL);  // Fuses QDQ pairs in INT8 models
+    
+    {
+        std::lock_guard<std::mutex> lock(config_mutex);
+        registerSharedArena();
+        
+        if (config.enable_mem_pattern) session_options.EnableMemPattern();
+        else session_options.DisableMemPattern();
+        
+        if (config.enable_cpu_mem_arena) session_options.EnableCpuMemArena();
+        else session_options.DisableCpuMemArena();
+        
+        if (config.shared_arena && config.enable_cpu_mem_arena) {
+            session_options.AddConfigEntry("session.use_env_allocators", "1");
+        }
+    }
+    
+    size_t rss_before = processResidentBytes();
+    auto session = std::make_unique<Ort::Session>(env, model_path.c_str(), session_options);
+    size_t rss_after = processResidentBytes();
+    
+    std::lock_guard<std::mutex> lock(models_mutex);
+    size_t count = model_count.load();
+    size_t slot = count;
+    for (size_t i = 0; i < count; ++i) {
+        if (!models[i].live.load()) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot >= kMaxModels) {
+        std::cerr << "⚠️ ORT memory report is full, not tracking " << model_name << std::endl;
+        model_id = kMaxModels;
+        return session;
+    }
+    
+    ModelEntry& entry = models[slot];
+    entry.name = model_name;
+    entry.path = model_path;
+    entry.load_rss_bytes = rss_after > rss_before ? rss_after - rss_before : 0;
+    std::ifstream file(model_path, std::ios::binary | std::ios::ate);
+    entry.file_bytes = file.good() ? static_cast<size_t>(file.tellg()) : 0;
+    entry.runs = 0;
+    entry.live = true;
+    model_id = slot;
+    if (slot == count) {
+        model_count.store(slot + 1);  // Publishes the entry to readers
+    }
+    
+    return session;
+}
+
+void OrtRuntime::releaseModel(size_t model_id) {
+    std::lock_guard<std::mutex> lock(models_mutex);
+    if (model_id < model_count.load()) {
+        models[model_id].live = false;
+    }
+}
+
+ModelMemoryStats OrtRuntime::getModelStats(size_t model_id) const {
+    ModelMemoryStats stats;
+    std::lock_guard<std::mutex> lock(models_mutex);
+    if (model_id >= model_count.load() || !models[model_id].live.load()) {
+        return stats;
+    }
+    const ModelEntry& entry = models[model_id];
+    stats.name = entry.name;
+    stats.path = entry.path;
+    stats.file_bytes = entry.file_bytes;
+    stats.load_rss_bytes = entry.load_rss_bytes;
+    stats.runs = entry.runs.load();
+    return stats;
+}
+
+bool OrtRuntime::takeShrinkDecision() {
+    if (!shrink_arena.load(std::memory_order_relaxed)) return false;
+    
+    int64_t now = steadyMillis();
+    int64_t last = last_shrink_ms.load();
+    bool due = shrink_requested.load();
+    
+    // Burst over: the peak reached the burst size and this run starts alone
+    int burst = burst_concurrency.load(std::memory_order_relaxed);
+    if (!due && burst > 0 && burst_peak.load() >= burst && in_flight_runs.load() <= 1) {
+        due = true;
+    }
+    
+    int64_t interval = shrink_interval_ms.load(std::memory_order_relaxed);
+    if (!due && interval > 0 && now - last >= interval) {
+        due = true;
+    }
+    
+    // RSS is read at most every 100ms, by the run that moves last_rss_check_ms
+    size_t rss_threshold = shrink_rss_threshold_bytes.load(std::memory_order_relaxed);
+    int64_t last_check = last_rss_check_ms.load();
+    if (!due && rss_threshold > 0 && now - last_check >= 100 &&
+        last_rss_check_ms.compare_exchange_strong(last_check, now)) {
+        due = processResidentBytes() >= rss_threshold;
+    }
+    
+    if (!due) return false;
+    
+    // Only one run carries the shrink: the one that moves last_shrink_ms past
+    // the value it decided on (at most one shrink per millisecond)
+    if (now <= last || !last_shrink_ms.compare_exchange_strong(last, now)) return false;
+    
+    shrink_requested = false;
+    burst_peak = 0;
+    shrinks++;
+    return true;
+}
+
+OrtRuntime::RunScope::RunScope(OrtRuntime& runtime, size_t model_id) 
+    : runtime(runtime), model_id(model_id) {
+    int in_flight = ++runtime.in_flight_runs;
+    
+    int peak = runtime.burst_peak.load();
+    while (in_flight > peak && !runtime.burst_peak.compare_exchange_weak(peak, in_flight)) {}
+    
+    if (runtime.takeShrinkDecision()) {
+        run_options.AddConfigEntry("memory.enable_memory_arena_shrinkage", "cpu:0");
+    }
+}
+
+OrtRuntime::RunScope::~RunScope() {
+    runtime.in_flight_runs--;
+    
+    if (model_id < runtime.model_count.load()) {
+        runtime.models[model_id].runs++;
+    }
+}
+
+void OrtRuntime::requestShrink() {
+    shrink_requested = true;
+}
+
+OrtMemoryReport OrtRuntime::getMemoryReport() const {
+    OrtMemoryReport report;
+    report.rss_bytes = processResidentBytes();
+    report.peak_rss_bytes = processPeakResidentBytes();
+    report.shrinks = shrinks.load();
+    report.in_flight_runs = in_flight_runs.load();
+    report.shared_arena = getConfig().shared_arena;
+    
+    std::lock_guard<std::mutex> lock(models_mutex);
+    size_t count = model_count.load();
+    for (size_t i = 0; i < count; ++i) {
+        const ModelEntry& entry = models[i];
+        if (!entry.live.load()) continue;
+        ModelMemoryStats stats;
+        stats.name = entry.name;
+        stats.path = entry.path;
+        stats.file_bytes = entry.file_bytes;
+        stats.load_rss_bytes = entry.load_rss_bytes;
+        stats.runs = entry.runs.load();
+        report.models.push_back(stats);
+    }
+    return report;
+}
+
+void OrtRuntime::printMemoryReport() const {
+    OrtMemoryReport report = getMemoryReport();
+    const double mb = 1024.0 * 1024.0;
+    
+    std::cout << "\n🧠 ORT Memory Report:" << std::endl;
+    std::cout << "  RSS: " << std::fixed << std::setprecision(1) << report.rss_bytes / mb << "MB"
+              << " (peak " << report.peak_rss_bytes / mb << "MB)" << std::endl;
+    std::cout << "  Arena: " << (report.shared_arena ? "shared" : "per-session") 
+              << ", shrinks: " << report.shrinks << ", in-flight runs: " << report.in_flight_runs << std::endl;
+    
+    for (const auto& model : report.models) {
+        std::cout << "  " << std::left << std::setw(28) << model.name << std::right
+                  << std::setw(8) << model.file_bytes / mb << "MB file"
+                  << std::setw(8) << model.load_rss_bytes / mb << "MB load"
+                  << std::setw(10) << model.runs << " runs" << std::endl;
+    }
+}
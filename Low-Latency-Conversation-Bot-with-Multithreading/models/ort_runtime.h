@@ -0,0 +1,148 @@
+#ifndef ORT_RUNTIME_H
+#define ORT_RUNTIME_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// ONNX Runtime
+#include <onnxruntime/onnxruntime_cxx_api.h>
+
+// Arena / memory-pattern settings for every ORT session in the process.
+// Defaults can be overridden from the environment (see fromEnvironment).
+struct OrtMemoryConfig {
+    // One env-registered CPU arena shared by all sessions instead of one per session
+    bool shared_arena = true;
+    int arena_extend_strategy = 1;              // 0 = next power of two, 1 = same as requested
+    size_t arena_max_bytes = 0;                 // 0 = unlimited
+    int arena_initial_chunk_bytes = -1;         // -1 = ORT default
+    int arena_max_dead_bytes_per_chunk = -1;    // -1 = ORT default
+    bool enable_cpu_mem_arena = true;
+    bool enable_mem_pattern = true;
+    
+    // Arena shrinkage: the next Run() after a trigger releases unused chunks
+    std::chrono::milliseconds shrink_interval{30000};  // Periodic trigger, 0 = off
+    size_t shrink_rss_threshold_bytes = 0;             // RSS trigger, 0 = off
+    int burst_concurrency = 4;                         // In-flight runs that count as a burst, 0 = off
+    
+    // ORT_SHARED_ARENA, ORT_ARENA_EXTEND_STRATEGY, ORT_ARENA_MAX_MB, ORT_CPU_MEM_ARENA,
+    // ORT_MEM_PATTERN, ORT_SHRINK_INTERVAL_MS, ORT_SHRINK_RSS_MB, ORT_BURST_RUNS
+    static OrtMemoryConfig fromEnvironment();
+};
+
+// Memory figures for one loaded model
+struct ModelMemoryStats {
+    std::string name;
+    std::string path;
+    size_t file_bytes = 0;       // Serialized model size
+    size_t load_rss_bytes = 0;   // RSS growth while the session was created
+    uint64_t runs = 0;
+};
+
+// Process-wide ORT memory snapshot
+struct OrtMemoryReport {
+    size_t rss_bytes = 0;
+    size_t peak_rss_bytes = 0;
+    uint64_t shrinks = 0;
+    int in_flight_runs = 0;
+    bool shared_arena = false;
+    std::vector<ModelMemoryStats> models;
+};
+
+// Resident set size of this process (current and peak), in bytes
+size_t processResidentBytes();
+size_t processPeakResidentBytes();
+
+// Single Ort::Env plus the session/run options derived from OrtMemoryConfig
+class OrtRuntime {
+private:
+    struct ModelEntry {
+        std::string name;
+        std::string path;
+        size_t file_bytes = 0;
+        size_t load_rss_bytes = 0;
+        std::atomic<uint64_t> runs{0};
+        std::atomic<bool> live{false};  // Cleared by releaseModel, slot is then reused
+    };
+    
+    Ort::Env env;
+    OrtMemoryConfig config;
+    mutable std::mutex config_mutex;
+    bool arena_registered = false;  // Arena settings are fixed once sessions exist
+    
+    // Fixed slots so RunScope can bump run counters without a lock
+    static constexpr size_t kMaxModels = 64;
+    std::array<ModelEntry, kMaxModels> models;
+    std::atomic<size_t> model_count{0};
+    mutable std::mutex models_mutex;  // Guards slot contents; RunScope only touches atomics
+    
+    // Shrink policy, copied out of config so Run() reads it without config_mutex
+    std::atomic<bool> shrink_arena{true};
+    std::atomic<int64_t> shrink_interval_ms{0};
+    std::atomic<size_t> shrink_rss_threshold_bytes{0};
+    std::atomic<int> burst_concurrency{0};
+    
+    // Shrink bookkeeping
+    std::atomic<int> in_flight_runs{0};
+    std::atomic<int> burst_peak{0};
+    std::atomic<bool> shrink_requested{false};
+    std::atomic<uint64_t> shrinks{0};
+    std::atomic<int64_t> last_shrink_ms{0};
+    std::atomic<int64_t> last_rss_check_ms{0};
+    
+    OrtRuntime();
+    
+    void registerSharedArena();
+    void publishShrinkPolicy();  // Caller holds config_mutex
+    bool takeShrinkDecision();
+    
+public:
+    static OrtRuntime& instance();
+    
+    OrtRuntime(const OrtRuntime&) = delete;
+    OrtRuntime& operator=(const OrtRuntime&) = delete;
+    
+    // Arena settings only apply before the first session is created;
+    // shrink settings can be changed at any time
+    void configure(const OrtMemoryConfig& new_config);
+    OrtMemoryConfig getConfig() const;
+    
+    Ort::Env& getEnv() { return env; }
+    
+    // Create a session with the configured options and record its memory
+    std::unique_ptr<Ort::Session> createSession(const std::string& model_path, const std::string& model_name,
+                                                size_t& model_id);
+    
+    // Called from the model wrapper's destructor
+    void releaseModel(size_t model_id);
+    ModelMemoryStats getModelStats(size_t model_id) const;
+    
+    // Wraps one Run(): tracks in-flight runs and carries the shrink request
+    class RunScope {
+    private:
+        OrtRuntime& runtime;
+        size_t model_id;
+        Ort::RunOptions run_options;
+        
+    public:
+        RunScope(OrtRuntime& runtime, size_t model_id);
+        ~RunScope();
+        RunScope(const RunScope&) = delete;
+        RunScope& operator=(const RunScope&) = delete;
+        
+        const Ort::RunOptions& options() const { return run_options; }
+    };
+    
+    // Ask the next Run() to shrink the arena (e.g. from a maintenance loop)
+    void requestShrink();
+    
+    OrtMemoryReport getMemoryReport() const;
+    void printMemoryReport() const;
+};
+
+#endif // ORT_RUNTIME_H
@@ -0,0 +1,182 @@
+#include "prompt_builder.h"
+#include "composer.h"
+#include "closer.h"
+#include <algorithm>
+#include <chrono>
+
+PromptBuilder::PromptBuilder(const std::string& business_context) : business_context(business_context) {
+    std::string header = "You are the booking assistant for: " + business_context + ".\n";
+    
+    question_prefix.text = header +
+        "Write exactly one short, friendly question that asks the caller for the details listed under \"Ask for\".\n"
+        "Ask for at most two details and never for details that are already collected.\n"
+        "Reply with the question only.\n\n"
+        "Conversation so far:\n";
+    question_prefix.id = hashPrefix(question_prefix.text);
+    
+    closing_prefix.text = header +
+        "The caller has given every detail needed for the booking.\n"
+        "Write a short, warm closing message that reads the booking details back to them.\n"
+        "Reply with the closing message only.\n\n"
+        "Conversation:\n";
+    closing_prefix.id = hashPrefix(closing_prefix.text);
+    
+    entity_fragments["caller_name"] = "- the caller's name\n";
+    entity_fragments["phone_number"] = "- a callback phone number\n";
+    entity_fragments["day_preference"] = "- the day they would like to come in\n";
+    entity_fragments["time_preference"] = "- the time of day they prefer\n";
+    entity_fragments["service_type"] = "- the service they want (haircut, color, styling, ...)\n";
+}
+
+uint64_t PromptBuilder::hashPrefix(std::string_view text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t PromptBuilder::sessionPrefixId(uint64_t instructions_id, uint64_t session_key) {
+    if (session_key == 0) return instructions_id;
+    uint64_t hash = instructions_id;
+    for (int shift = 0; shift < 64; shift += 8) {
+        hash ^= (session_key >> shift) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t PromptBuilder::newSessionKey(std::string_view session_id) {
+    static std::atomic<uint64_t> next_session{1};
+    static const uint64_t process_salt = static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    
+    uint64_t key = hashPrefix(session_id) ^ (process_salt * 0x9E3779B97F4A7C15ULL);
+    key ^= next_session.fetch_add(1) * 0xC2B2AE3D27D4EB4FULL;
+    return key == 0 ? 1 : key;  // 0 means "no session"
+}
+
+// The context split at history_length: history goes into a session's
+// prefix, the rest (this turn's lines) into the delta. Without a session
+// key everything is delta.
+static void splitContext(std::string_view context, uint64_t session_key, size_t history_length,
+                         std::string_view& history, std::string_view& latest) {
+    size_t split = session_key == 0 ? 0 : std::min(history_length, context.size());
+    history = context.substr(0, split);
+    latest = context.substr(split);
+}
+
+void PromptBuilder::appendEntityFragment(std::string& out, const std::string& entity) const {
+    auto it = entity_fragments.find(entity);
+    if (it != entity_fragments.end()) {
+        out += it->second;
+        return;
+    }
+    out += "- ";
+    out += entity;
+    out += '\n';
+}
+
+// Sorted by name so the same entities always render the same bytes
+void PromptBuilder::appendKnownEntities(std::string& out, const std::unordered_map<std::string, std::string>& entities) {
+    std::vector<const std::pair<const std::string, std::string>*> sorted;
+    sorted.reserve(entities.size());
+    for (const auto& entry : entities) {
+        if (!entry.second.empty()) sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+    
+    for (const auto* entry : sorted) {
+        out += "- ";
+        out += entry->first;
+        out += ": ";
+        out += entry->second;
+        out += '\n';
+    }
+}
+
+void PromptBuilder::record(const LLMPrompt& prompt, uint64_t elapsed_ns) {
+    prompts_built++;
+    prefix_bytes_reused += prompt.prefixLength();
+    delta_bytes += prompt.delta.size();
+    build_ns += elapsed_ns;
+}
+
+LLMPrompt PromptBuilder::buildQuestion(const CompositionRequest& request) {
+    auto start = std::chrono::steady_clock::now();
+    
+    LLMPrompt prompt;
+    prompt.kind = PromptKind::QUESTION;
+    prompt.instructions = question_prefix.text;
+    prompt.prefix_id = sessionPrefixId(question_prefix.id, request.session_key);
+    prompt.request = &request;
+    
+    std::string_view latest;
+    splitContext(request.context(), request.session_key, request.history_length, prompt.history, latest);
+    
+    std::string& delta = prompt.delta;
+    delta.reserve(128 + latest.size() + 48 * (request.known_entities.size() + request.missing_entities.size()));
+    
+    if (!latest.empty()) {
+        delta.append(latest);
+        if (delta.back() != '\n') delta += '\n';
+    }
+    if (!request.known_entities.empty()) {
+        delta += "Already collected:\n";
+        appendKnownEntities(delta, request.known_entities);
+    }
+    delta += "Ask for:\n";
+    for (const auto& entity : request.missing_entities) {
+        appendEntityFragment(delta, entity);
+    }
+    delta += "Question:";
+    
+    record(prompt, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    return prompt;
+}
+
+LLMPrompt PromptBuilder::buildClosing(const ClosingRequest& request, const CompositionRequest& as_composition) {
+    auto start = std::chrono::steady_clock::now();
+    
+    LLMPrompt prompt;
+    prompt.kind = PromptKind::CLOSING;
+    prompt.instructions = closing_prefix.text;
+    prompt.prefix_id = sessionPrefixId(closing_prefix.id, request.session_key);
+    prompt.request = &as_composition;
+    
+    std::string_view latest;
+    splitContext(request.summary(), request.session_key, request.history_length, prompt.history, latest);
+    
+    std::string& delta = prompt.delta;
+    delta.reserve(128 + latest.size() + 48 * request.complete_entities.size());
+    
+    if (!latest.empty()) {
+        delta.append(latest);
+        if (delta.back() != '\n') delta += '\n';
+    }
+    if (!request.business_context.empty() && request.business_context != business_context) {
+        delta += "Booking type: ";
+        delta += request.business_context;
+        delta += '\n';
+    }
+    delta += "Booking details:\n";
+    appendKnownEntities(delta, request.complete_entities);
+    delta += "Closing:";
+    
+    record(prompt, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    return prompt;
+}
+
+uint64_t PromptBuilder::getPrefixId(PromptKind kind) const {
+    return kind == PromptKind::CLOSING ? closing_prefix.id : question_prefix.id;
+}
+
+PromptBuilderStats PromptBuilder::getStats() const {
+    PromptBuilderStats stats;
+    stats.prompts_built = prompts_built.load();
+    stats.prefix_bytes_reused = prefix_bytes_reused.load();
+    stats.delta_bytes = delta_bytes.load();
+    stats.build_ns = build_ns.load();
+    return stats;
+}
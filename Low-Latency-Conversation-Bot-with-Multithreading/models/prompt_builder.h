@@ -0,0 +1,110 @@
+#ifndef PROMPT_BUILDER_H
+#define PROMPT_BUILDER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+
+struct CompositionRequest;
+struct ClosingRequest;
+
+enum class PromptKind {
+    QUESTION,  // Ask for missing entities
+    CLOSING    // Confirm a complete booking
+};
+
+// A prompt split into a stable prefix and the per-turn delta.
+// The prefix is the builder's instructions followed by the session's
+// history: every transcript line sent in an earlier prompt. prefix_id is the
+// same on every turn of a session, and each turn's prefix extends the
+// previous one (unless the transcript ring dropped old lines), so a local
+// backend can keep the session's KV cache and only prefill the delta.
+// Prompts without a session key have the instructions as their prefix and
+// share the instructions' id.
+struct LLMPrompt {
+    PromptKind kind = PromptKind::QUESTION;
+    std::string_view instructions;  // Pre-rendered, owned by the PromptBuilder
+    std::string_view history;       // Earlier lines, owned by the request's transcript snapshot
+    uint64_t prefix_id = 0;         // Per session (or FNV-1a of the instructions without one)
+    std::string delta;              // This turn's new lines, known entities, what to ask
+    const CompositionRequest* request = nullptr;  // For backends that still build their own prompt
+
+    size_t prefixLength() const { return instructions.size() + history.size(); }
+
+    std::string text() const {
+        std::string full;
+        full.reserve(prefixLength() + delta.size());
+        full.append(instructions);
+        full.append(history);
+        full.append(delta);
+        return full;
+    }
+};
+
+// Prompt construction counters
+struct PromptBuilderStats {
+    uint64_t prompts_built = 0;
+    uint64_t prefix_bytes_reused = 0;  // Prefix bytes (instructions + history) a caching backend can skip
+    uint64_t delta_bytes = 0;
+    uint64_t build_ns = 0;
+
+    double avgBuildMicros() const {
+        return prompts_built == 0 ? 0.0 : build_ns / 1000.0 / prompts_built;
+    }
+};
+
+// Renders instructions and per-entity fragments once; each prompt then only
+// appends the turn's delta to a reserved buffer
+class PromptBuilder {
+private:
+    struct Prefix {
+        std::string text;
+        uint64_t id = 0;
+    };
+
+    std::string business_context;
+    Prefix question_prefix;
+    Prefix closing_prefix;
+    std::unordered_map<std::string, std::string> entity_fragments;  // Crew entity -> "- ...\n"
+
+    std::atomic<uint64_t> prompts_built{0};
+    std::atomic<uint64_t> prefix_bytes_reused{0};
+    std::atomic<uint64_t> delta_bytes{0};
+    std::atomic<uint64_t> build_ns{0};
+
+    void appendEntityFragment(std::string& out, const std::string& entity) const;
+    static void appendKnownEntities(std::string& out, const std::unordered_map<std::string, std::string>& entities);
+    void record(const LLMPrompt& prompt, uint64_t elapsed_ns);
+
+public:
+    explicit PromptBuilder(const std::string& business_context = "Hair salon appointment");
+
+    PromptBuilder(const PromptBuilder&) = delete;
+    PromptBuilder& operator=(const PromptBuilder&) = delete;
+
+    // `request` must outlive the returned prompt (it is referenced, not copied)
+    LLMPrompt buildQuestion(const CompositionRequest& request);
+
+    // `as_composition` is the closer's single CompositionRequest view of the
+    // booking, kept for quality assessment and legacy backends
+    LLMPrompt buildClosing(const ClosingRequest& request, const CompositionRequest& as_composition);
+
+    uint64_t getPrefixId(PromptKind kind) const;  // Of the instructions alone
+    const std::string& getBusinessContext() const { return business_context; }
+    PromptBuilderStats getStats() const;
+
+    static uint64_t hashPrefix(std::string_view text);
+
+    // Prefix id of `session_key`'s prompts over the instructions `instructions_id`
+    static uint64_t sessionPrefixId(uint64_t instructions_id, uint64_t session_key);
+
+    // A key for a new conversation: unique within the process, and mixed
+    // with the session id so a restarted process does not hand out the
+    // same keys again for different sessions
+    static uint64_t newSessionKey(std::string_view session_id);
+};
+
+#endif // PROMPT_BUILDER_H
@@ -0,0 +1,272 @@
+#include "question_scorer.h"
+#include "composer.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <cstdlib>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+static const char* kFeatureNames[QF_COUNT] = {
+    "coverage", "asks_known", "question_form", "multi_question",
+    "length_ok", "too_long", "polite", "addresses_you", "artifact"
+};
+
+const char* QuestionQualityScorer::featureName(size_t feature) {
+    return feature < QF_COUNT ? kFeatureNames[feature] : "unknown";
+}
+
+QualityScorerWeights QualityScorerWeights::fromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open quality scorer weights: " + path);
+    }
+
+    json document = json::parse(file);
+    QualityScorerWeights loaded;
+    loaded.bias = document.value("bias", loaded.bias);
+    if (document.contains("weights")) {
+        for (size_t i = 0; i < QF_COUNT; ++i) {
+            loaded.weights[i] = document["weights"].value(kFeatureNames[i], loaded.weights[i]);
+        }
+    }
+    return loaded;
+}
+
+void QualityScorerWeights::save(const std::string& path) const {
+    json named;
+    for (size_t i = 0; i < QF_COUNT; ++i) {
+        named[kFeatureNames[i]] = weights[i];
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write quality scorer weights: " + path);
+    }
+    file << json{{"bias", bias}, {"weights", named}}.dump(2) << std::endl;
+}
+
+QuestionQualityScorer::QuestionQualityScorer() {
+    std::vector<std::string> name = {"name", "who am i", "call you"};
+    std::vector<std::string> phone = {"phone", "number", "reach you", "contact"};
+    std::vector<std::string> day = {"day", "date", "when", "week", "tomorrow"};
+    std::vector<std::string> time = {"time", "when", "morning", "afternoon", "evening", "o'clock"};
+    std::vector<std::string> service = {"service", "haircut", "cut", "color", "colour", "style", "trim",
+                                        "treatment", "looking for", "done"};
+
+    entity_cues["caller_name"] = name;
+    entity_cues["name"] = name;
+    entity_cues["phone_number"] = phone;
+    entity_cues["phone"] = phone;
+    entity_cues["day_preference"] = day;
+    entity_cues["day"] = day;
+    entity_cues["time_preference"] = time;
+    entity_cues["time"] = time;
+    entity_cues["service_type"] = service;
+    entity_cues["service"] = service;
+    entity_cues["stylist"] = {"stylist", "who would you like", "anyone in particular"};
+    entity_cues["email"] = {"email", "e-mail"};
+}
+
+bool QuestionQualityScorer::mentions(std::string_view lowered, const std::string& entity) const {
+    auto it = entity_cues.find(entity);
+    if (it == entity_cues.end()) {
+        // Unknown entity: look for its own name with '_' as ' '
+        std::string spoken = entity;
+        std::replace(spoken.begin(), spoken.end(), '_', ' ');
+        return lowered.find(spoken) != std::string_view::npos;
+    }
+    for (const auto& cue : it->second) {
+        if (lowered.find(cue) != std::string_view::npos) return true;
+    }
+    return false;
+}
+
+QualityFeatures QuestionQualityScorer::extractFeatures(const std::string& question,
+                                                       const CompositionRequest& request) const {
+    QualityFeatures features{};
+
+    std::string lowered(question.size(), '\0');
+    std::transform(question.begin(), question.end(), lowered.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // One pass for words, question marks and newlines
+    int words = 0;
+    int question_marks = 0;
+    bool newline = false;
+    bool in_word = false;
+    for (char c : lowered) {
+        bool space = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        if (!space && !in_word) words++;
+        in_word = !space;
+        if (c == '?') question_marks++;
+        if (c == '\n') newline = true;
+    }
+
+    if (!request.missing_entities.empty()) {
+        int covered = 0;
+        for (const auto& entity : request.missing_entities) {
+            if (mentions(lowered, entity)) covered++;
+        }
+        features[QF_COVERAGE] = static_cast<float>(covered) / request.missing_entities.size();
+    } else {
+        features[QF_COVERAGE] = 1.0f;
+    }
+
+    if (!request.known_entities.empty()) {
+        int repeated = 0;
+        for (const auto& [entity, value] : request.known_entities) {
+            bool also_missing = std::find(request.missing_entities.begin(), request.missing_entities.end(), entity) !=
+                                request.missing_entities.end();
+            if (!also_missing && mentions(lowered, entity)) repeated++;
+        }
+        features[QF_ASKS_KNOWN] = static_cast<float>(repeated) / request.known_entities.size();
+    }
+
+    size_t last = lowered.find_last_not_of(" \t\r\n\"'");
+    features[QF_QUESTION_FORM] = (last != std::string::npos && lowered[last] == '?') ? 1.0f : 0.0f;
+    features[QF_MULTI_QUESTION] = question_marks > 1 ? 1.0f : 0.0f;
+    features[QF_LENGTH_OK] = (words >= 5 && words <= 30) ? 1.0f : 0.0f;
+    features[QF_TOO_LONG] = words > 40 ? 1.0f : 0.0f;
+
+    features[QF_POLITE] = (lowered.find("please") != std::string::npos || lowered.find("could") != std::string::npos ||
+                           lowered.find("would") != std::string::npos || lowered.find("may ") != std::string::npos)
+                              ? 1.0f : 0.0f;
+    features[QF_ADDRESSES_YOU] = lowered.find("you") != std::string::npos ? 1.0f : 0.0f;
+
+    features[QF_ARTIFACT] = (newline || lowered.find("question:") != std::string::npos ||
+                             lowered.find("ask for") != std::string::npos || lowered.find("caller:") != std::string::npos ||
+                             lowered.find("bot:") != std::string::npos)
+                                ? 1.0f : 0.0f;
+
+    return features;
+}
+
+float QuestionQualityScorer::scoreFeatures(const QualityFeatures& features) const {
+    float z = weights.bias;
+    for (size_t i = 0; i < QF_COUNT; ++i) {
+        z += weights.weights[i] * features[i];
+    }
+    return 1.0f / (1.0f + std::exp(-z));
+}
+
+float QuestionQualityScorer::score(const std::string& question, const CompositionRequest& request) {
+    auto start = std::chrono::steady_clock::now();
+    float quality = scoreFeatures(extractFeatures(question, request));
+
+    scored.fetch_add(1, std::memory_order_relaxed);
+    scoring_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+    return quality;
+}
+
+float QuestionQualityScorer::scoreClosing(const std::string& closing, const CompositionRequest& booking) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::string lowered(closing.size(), '\0');
+    std::transform(closing.begin(), closing.end(), lowered.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    int words = 0;
+    bool in_word = false;
+    for (char c : lowered) {
+        bool space = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        if (!space && !in_word) words++;
+        in_word = !space;
+    }
+
+    // Share of the booking read back, by value or by the entity's cue words
+    float read_back = 1.0f;
+    if (!booking.known_entities.empty()) {
+        int mentioned = 0;
+        for (const auto& [entity, value] : booking.known_entities) {
+            std::string lowered_value(value.size(), '\0');
+            std::transform(value.begin(), value.end(), lowered_value.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if ((!lowered_value.empty() && lowered.find(lowered_value) != std::string::npos) ||
+                mentions(lowered, entity)) {
+                mentioned++;
+            }
+        }
+        read_back = static_cast<float>(mentioned) / booking.known_entities.size();
+    }
+
+    bool artifact = lowered.find("closing:") != std::string::npos || lowered.find("booking details:") != std::string::npos ||
+                    lowered.find("caller:") != std::string::npos || lowered.find("bot:") != std::string::npos;
+    float quality = read_back * (artifact ? 0.3f : 1.0f) * (words >= 5 && words <= 80 ? 1.0f : 0.5f);
+
+    scored.fetch_add(1, std::memory_order_relaxed);
+    scoring_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+    return quality;
+}
+
+bool QuestionQualityScorer::startRecording(const std::string& path) {
+    std::lock_guard<std::mutex> lock(recording_mutex);
+    recording.open(path, std::ios::app);
+    if (!recording.is_open()) {
+        std::cerr << "⚠️ Cannot open quality recording: " << path << std::endl;
+        return false;
+    }
+    std::cout << "📝 Recording LLM quality scores to " << path << std::endl;
+    return true;
+}
+
+void QuestionQualityScorer::record(const std::string& question, const CompositionRequest& request, float llm_score) {
+    json line = {
+        {"question", question},
+        {"missing_entities", request.missing_entities},
+        {"known_entities", request.known_entities},
+        {"llm_score", llm_score}
+    };
+
+    std::lock_guard<std::mutex> lock(recording_mutex);
+    if (!recording.is_open()) return;
+    recording << line.dump() << '\n';
+    recording.flush();
+    recorded++;
+}
+
+QualityScorerStats QuestionQualityScorer::getStats() const {
+    QualityScorerStats stats;
+    stats.scored = scored.load();
+    stats.recorded = recorded.load();
+    if (stats.scored > 0) {
+        stats.avg_micros = scoring_ns.load() / 1000.0 / stats.scored;
+    }
+    return stats;
+}
+
+QualityAssessment QualityAssessment::fromEnvironment() {
+    QualityAssessment quality;
+    quality.scorer = std::make_shared<QuestionQualityScorer>();
+
+    if (const char* assessor = std::getenv("QUALITY_ASSESSOR")) {
+        std::string mode = assessor;
+        if (mode == "llm") {
+            quality.assessor = QualityAssessor::LLM;
+        } else if (mode == "shadow") {
+            const char* path = std::getenv("QUALITY_RECORDING");
+            if (quality.scorer->startRecording(path ? path : "quality_recording.jsonl")) {
+                quality.assessor = QualityAssessor::SHADOW;
+            }
+        }
+    }
+    if (const char* weights_path = std::getenv("QUALITY_WEIGHTS")) {
+        try {
+            quality.scorer->setWeights(QualityScorerWeights::fromFile(weights_path));
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️ Keeping default quality weights: " << e.what() << std::endl;
+        }
+    }
+    return quality;
+}
+
+const QualityAssessment& QualityAssessment::shared() {
+    static const QualityAssessment quality = fromEnvironment();
+    return quality;
+}
@@ -0,0 +1,125 @@
+#ifndef QUESTION_SCORER_H
+#define QUESTION_SCORER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+struct CompositionRequest;
+
+// Inputs of the linear quality model, each in [0, 1]
+enum QualityFeature : size_t {
+    QF_COVERAGE,        // Share of the missing entities the question asks about
+    QF_ASKS_KNOWN,      // Share of the already-known entities it asks about again
+    QF_QUESTION_FORM,   // Ends with '?'
+    QF_MULTI_QUESTION,  // More than one '?'
+    QF_LENGTH_OK,       // 5..30 words
+    QF_TOO_LONG,        // Over 40 words
+    QF_POLITE,          // please / could / would / may
+    QF_ADDRESSES_YOU,   // you / your
+    QF_ARTIFACT,        // Prompt leakage: "Question:", "Ask for", "Caller:", newlines
+    QF_COUNT
+};
+
+using QualityFeatures = std::array<float, QF_COUNT>;
+
+// score = sigmoid(bias + weights . features)
+struct QualityScorerWeights {
+    float bias = -2.5f;
+    QualityFeatures weights = {
+        2.5f,   // coverage
+        -1.2f,  // asks_known
+        1.2f,   // question_form
+        -0.6f,  // multi_question
+        0.6f,   // length_ok
+        -1.0f,  // too_long
+        0.4f,   // polite
+        0.3f,   // addresses_you
+        -2.0f   // artifact
+    };
+
+    // {"bias": -2.5, "weights": {"coverage": 2.5, ...}}; missing names keep their defaults
+    static QualityScorerWeights fromFile(const std::string& path);
+    void save(const std::string& path) const;
+};
+
+struct QualityScorerStats {
+    uint64_t scored = 0;
+    double avg_micros = 0.0;
+    uint64_t recorded = 0;  // Shadow records written
+};
+
+// In-process replacement for LLMInterface::assessQuestionQuality: a handful
+// of lexical features and a linear model, scored in microseconds instead of
+// a second LLM round trip per generated question. Thread-safe for score();
+// setWeights() is meant for startup.
+class QuestionQualityScorer {
+private:
+    QualityScorerWeights weights;
+
+    // Lower-case cue words per entity (crew and controller names both map)
+    std::unordered_map<std::string, std::vector<std::string>> entity_cues;
+
+    std::atomic<uint64_t> scored{0};
+    std::atomic<uint64_t> scoring_ns{0};
+
+    // Shadow recording for tools/quality_agreement_report
+    std::mutex recording_mutex;
+    std::ofstream recording;
+    std::atomic<uint64_t> recorded{0};
+
+    bool mentions(std::string_view lowered, const std::string& entity) const;
+
+public:
+    QuestionQualityScorer();
+
+    QualityFeatures extractFeatures(const std::string& question, const CompositionRequest& request) const;
+    float scoreFeatures(const QualityFeatures& features) const;
+    float score(const std::string& question, const CompositionRequest& request);
+
+    // A closing is scored on what it is for: reading the booking
+    // (booking.known_entities) back, without leaked prompt text or rambling
+    float scoreClosing(const std::string& closing, const CompositionRequest& booking);
+
+    void setWeights(const QualityScorerWeights& new_weights) { weights = new_weights; }
+    const QualityScorerWeights& getWeights() const { return weights; }
+
+    // Append {question, missing_entities, known_entities, llm_score} lines to
+    // `path`, building a recorded set to check agreement or fit weights on
+    bool startRecording(const std::string& path);
+    void record(const std::string& question, const CompositionRequest& request, float llm_score);
+
+    QualityScorerStats getStats() const;
+
+    static const char* featureName(size_t feature);
+};
+
+// Who scores LLM-generated text against a crew's threshold
+enum class QualityAssessor {
+    LOCAL,   // QuestionQualityScorer in-process (default, no extra LLM call)
+    LLM,     // LLMInterface::assessQuestionQuality, a second round trip
+    SHADOW   // LLM decides, and each question score is recorded for the agreement report
+};
+
+// Quality assessment shared by every composer and closer in the process:
+// one scorer (weights, shadow recording) and the assessor to use with it
+struct QualityAssessment {
+    QualityAssessor assessor = QualityAssessor::LOCAL;
+    std::shared_ptr<QuestionQualityScorer> scorer;
+
+    // QUALITY_ASSESSOR=local|llm|shadow, QUALITY_WEIGHTS=<fitted.json>,
+    // QUALITY_RECORDING=<shadow log> (default quality_recording.jsonl)
+    static QualityAssessment fromEnvironment();
+
+    // fromEnvironment(), read once on first use
+    static const QualityAssessment& shared();
+};
+
+#endif // QUESTION_SCORER_H
@@ -0,0 +1,180 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include "memory_accounting.h"
+#include "text_normalizer.h"
+
+// Cache statistics snapshot
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+
+    float hitRate() const {
+        uint64_t lookups = hits + misses;
+        return lookups == 0 ? 0.0f : static_cast<float>(hits) / lookups;
+    }
+};
+
+// Canonical cache key for an utterance: the shared normalizer's joined
+// tokens (Unicode whitespace collapsed, optionally lowercased). Returns false
+// for utterances too long to be worth caching.
+inline bool normalizeUtteranceKey(const std::string& text, bool fold_case, std::string& key,
+                                  size_t max_length = 256) {
+    key.clear();
+    if (text.size() > max_length * 2) {
+        return false;
+    }
+
+    NormalizerOptions options;
+    options.fold_case = fold_case;
+    TextNormalizer::normalizeText(text, options, key);
+    return key.size() <= max_length;
+}
+
+// FNV-1a over the key, seeded with the model version so a reload never
+// hits entries computed by the previous models
+inline uint64_t hashUtteranceKey(const std::string& key, uint64_t model_version) {
+    uint64_t hash = 14695981039346656037ULL ^ (model_version * 0x9E3779B97F4A7C15ULL);
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    // Final avalanche so short keys still spread across shards (high bits)
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// Bounded LRU cache split into independently locked shards
+template <typename Value>
+class ShardedResultCache {
+private:
+    struct Entry {
+        uint64_t hash;
+        std::string key;  // Kept to rule out hash collisions
+        Value value;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;  // Most recently used at the front
+        std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t capacity_per_shard;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+    std::atomic<uint64_t> invalidations{0};
+
+    Shard& shardFor(uint64_t hash) const {
+        return *shards[(hash >> 32) % shards.size()];
+    }
+
+public:
+    ShardedResultCache(size_t num_shards = 16, size_t capacity_per_shard = 1024)
+        : capacity_per_shard(capacity_per_shard == 0 ? 1 : capacity_per_shard) {
+        if (num_shards == 0) num_shards = 1;
+        for (size_t i = 0; i < num_shards; ++i) {
+            shards.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    bool get(uint64_t hash, const std::string& key, Value& out) {
+        Shard& shard = shardFor(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(hash);
+        if (it == shard.index.end() || it->second->key != key) {
+            misses++;
+            return false;
+        }
+
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        out = it->second->value;
+        hits++;
+        return true;
+    }
+
+    void put(uint64_t hash, const std::string& key, const Value& value) {
+        Shard& shard = shardFor(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(hash);
+        if (it != shard.index.end()) {
+            it->second->key = key;
+            it->second->value = value;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return;
+        }
+
+        shard.lru.push_front(Entry{hash, key, value});
+        shard.index[hash] = shard.lru.begin();
+
+        if (shard.lru.size() > capacity_per_shard) {
+            shard.index.erase(shard.lru.back().hash);
+            shard.lru.pop_back();
+            evictions++;
+        }
+    }
+
+    void clear() {
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->lru.clear();
+            shard->index.clear();
+        }
+        invalidations++;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->lru.size();
+        }
+        return total;
+    }
+
+    // Estimated bytes held by entries, keys, values and the shard indexes
+    size_t memoryBytes() const {
+        size_t bytes = shards.size() * sizeof(Shard);
+        for (const auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            bytes += shard->lru.size() * (sizeof(Entry) + 2 * sizeof(void*));
+            bytes += shard->index.bucket_count() * sizeof(void*) +
+                     shard->index.size() * (sizeof(typename decltype(shard->index)::value_type) + 2 * sizeof(void*));
+            for (const auto& entry : shard->lru) {
+                bytes += heapBytes(entry.key) + heapBytes(entry.value);
+            }
+        }
+        return bytes;
+    }
+
+    CacheStats stats() const {
+        CacheStats s;
+        s.hits = hits.load();
+        s.misses = misses.load();
+        s.evictions = evictions.load();
+        s.invalidations = invalidations.load();
+        s.entries = size();
+        return s;
+    }
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,511 @@
+#include "text_normalizer.h"
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+enum class CharClass { WORD, SPACE, PUNCT };
+
+struct CodePointRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+// Unicode P* outside ASCII, generated from unicodedata for the blocks listed in the header
+static constexpr CodePointRange kPunctuation[] = {
+    {0x00A1, 0x00A1}, {0x00A7, 0x00A7}, {0x00AB, 0x00AB}, {0x00B6, 0x00B7}, {0x00BB, 0x00BB}, {0x00BF, 0x00BF},
+    {0x037E, 0x037E}, {0x0387, 0x0387}, {0x055A, 0x055F}, {0x0589, 0x058A},
+    {0x2010, 0x2027}, {0x2030, 0x2043}, {0x2045, 0x2051}, {0x2053, 0x205E},
+    {0x3001, 0x3003}, {0x3008, 0x3011}, {0x3014, 0x301F}, {0x3030, 0x3030}, {0x303D, 0x303D},
+    {0xFE30, 0xFE52}, {0xFE54, 0xFE61}, {0xFE63, 0xFE63}, {0xFE68, 0xFE68}, {0xFE6A, 0xFE6B},
+    {0xFF01, 0xFF03}, {0xFF05, 0xFF0A}, {0xFF0C, 0xFF0F}, {0xFF1A, 0xFF1B}, {0xFF1F, 0xFF20},
+    {0xFF3B, 0xFF3D}, {0xFF3F, 0xFF3F}, {0xFF5B, 0xFF5B}, {0xFF5D, 0xFF5D}, {0xFF5F, 0xFF65}
+};
+
+// Uppercase letters in Latin Extended-B and Greek that the pair rules below miss
+static constexpr uint16_t kIrregularLower[][2] = {
+    {0x181, 0x253}, {0x182, 0x183}, {0x184, 0x185}, {0x186, 0x254}, {0x187, 0x188}, {0x189, 0x256}, {0x18A, 0x257},
+    {0x18B, 0x18C}, {0x18E, 0x1DD}, {0x18F, 0x259}, {0x190, 0x25B}, {0x191, 0x192}, {0x193, 0x260}, {0x194, 0x263},
+    {0x196, 0x269}, {0x197, 0x268}, {0x198, 0x199}, {0x19C, 0x26F}, {0x19D, 0x272}, {0x19F, 0x275}, {0x1A0, 0x1A1},
+    {0x1A2, 0x1A3}, {0x1A4, 0x1A5}, {0x1A6, 0x280}, {0x1A7, 0x1A8}, {0x1A9, 0x283}, {0x1AC, 0x1AD}, {0x1AE, 0x288},
+    {0x1AF, 0x1B0}, {0x1B1, 0x28A}, {0x1B2, 0x28B}, {0x1B3, 0x1B4}, {0x1B5, 0x1B6}, {0x1B7, 0x292}, {0x1B8, 0x1B9},
+    {0x1BC, 0x1BD}, {0x1C4, 0x1C6}, {0x1C5, 0x1C6}, {0x1C7, 0x1C9}, {0x1C8, 0x1C9}, {0x1CA, 0x1CC}, {0x1CB, 0x1CC},
+    {0x1F1, 0x1F3}, {0x1F2, 0x1F3}, {0x1F4, 0x1F5}, {0x1F6, 0x195}, {0x1F7, 0x1BF}, {0x220, 0x19E}, {0x23A, 0x2C65},
+    {0x23B, 0x23C}, {0x23D, 0x19A}, {0x23E, 0x2C66}, {0x241, 0x242}, {0x243, 0x180}, {0x244, 0x289}, {0x245, 0x28C},
+    {0x370, 0x371}, {0x372, 0x373}, {0x376, 0x377}, {0x37F, 0x3F3}, {0x3CF, 0x3D7}, {0x3F4, 0x3B8}, {0x3F7, 0x3F8},
+    {0x3F9, 0x3F2}, {0x3FA, 0x3FB}, {0x3FD, 0x37B}, {0x3FE, 0x37C}, {0x3FF, 0x37D}
+};
+
+// Same byte classes as the vector kernels
+static inline bool isAsciiSpace(unsigned char c) {
+    return c == ' ' || (c >= 0x09 && c <= 0x0D) || (c >= 0x1C && c <= 0x1F);
+}
+
+static inline bool isAsciiPunct(unsigned char c) {
+    return (c >= 0x21 && c <= 0x2F) || (c >= 0x3A && c <= 0x40) || (c >= 0x5B && c <= 0x60) ||
+           (c >= 0x7B && c <= 0x7E);
+}
+
+static CharClass classify(uint32_t code_point) {
+    if (code_point < 0x80) {
+        unsigned char c = static_cast<unsigned char>(code_point);
+        if (isAsciiSpace(c)) return CharClass::SPACE;
+        return isAsciiPunct(c) ? CharClass::PUNCT : CharClass::WORD;
+    }
+    if (code_point == 0x85 || code_point == 0xA0 || code_point == 0x1680 ||
+        (code_point >= 0x2000 && code_point <= 0x200A) || code_point == 0x2028 || code_point == 0x2029 ||
+        code_point == 0x202F || code_point == 0x205F || code_point == 0x3000) {
+        return CharClass::SPACE;
+    }
+    for (const auto& range : kPunctuation) {
+        if (code_point < range.first) break;
+        if (code_point <= range.last) return CharClass::PUNCT;
+    }
+    return CharClass::WORD;
+}
+
+// Decodes one code point at data[0]; returns its byte length, or 0 for an invalid sequence
+static size_t decodeUtf8(const unsigned char* data, size_t available, uint32_t& code_point) {
+    unsigned char lead = data[0];
+    size_t length;
+    uint32_t minimum;
+    if (lead < 0x80) {
+        code_point = lead;
+        return 1;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        minimum = 0x80;
+        code_point = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        minimum = 0x800;
+        code_point = lead & 0x0F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        minimum = 0x10000;
+        code_point = lead & 0x07;
+    } else {
+        return 0;
+    }
+    if (available < length) return 0;
+    for (size_t k = 1; k < length; k++) {
+        if ((data[k] & 0xC0) != 0x80) return 0;
+        code_point = (code_point << 6) | (data[k] & 0x3F);
+    }
+    // Overlong forms, surrogates and values past U+10FFFF
+    if (code_point < minimum || (code_point >= 0xD800 && code_point <= 0xDFFF) || code_point > 0x10FFFF) {
+        return 0;
+    }
+    return length;
+}
+
+static char* encodeUtf8(uint32_t code_point, char* out) {
+    if (code_point < 0x80) {
+        *out++ = static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (code_point >> 6));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (code_point >> 12));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (code_point >> 18));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    return out;
+}
+
+// Case_Ignorable and Cased, as used by the Final_Sigma rule (exact for
+// Latin, Greek, Cyrillic and Armenian; other scripts count as uncased)
+static bool isCaseIgnorable(uint32_t cp) {
+    if (cp < 0x80) return cp == '\'' || cp == '.' || cp == ':' || cp == '^' || cp == '`';
+    return cp == 0xA8 || cp == 0xAD || cp == 0xAF || cp == 0xB4 || cp == 0xB7 || cp == 0xB8 ||
+           (cp >= 0x2B0 && cp <= 0x36F) || cp == 0x374 || cp == 0x375 || cp == 0x37A || cp == 0x384 ||
+           cp == 0x385 || cp == 0x387 || (cp >= 0x483 && cp <= 0x489) || cp == 0x559 || cp == 0x55F ||
+           (cp >= 0x200B && cp <= 0x200F) || cp == 0x2018 || cp == 0x2019 || cp == 0x2024 || cp == 0x2027 ||
+           (cp >= 0x202A && cp <= 0x202E) || (cp >= 0x2060 && cp <= 0x206F) || (cp >= 0x20D0 && cp <= 0x20F0) ||
+           (cp >= 0xFE00 && cp <= 0xFE0F);
+}
+
+static bool isCased(uint32_t cp) {
+    if (cp < 0x80) return (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z');
+    if (cp < 0x2B0) {
+        return cp == 0xAA || cp == 0xB5 || cp == 0xBA ||
+               (cp >= 0xC0 && cp != 0xD7 && cp != 0xF7 && cp != 0x1BB && (cp < 0x1C0 || cp > 0x1C3) && cp != 0x294);
+    }
+    if (cp >= 0x370 && cp <= 0x3FF) {
+        return cp <= 0x373 || cp == 0x376 || cp == 0x377 || (cp >= 0x37B && cp <= 0x37D) || cp == 0x37F ||
+               cp == 0x386 || (cp >= 0x388 && cp != 0x38B && cp != 0x38D && cp != 0x3A2 && cp != 0x3F6);
+    }
+    if (cp >= 0x400 && cp <= 0x52F) return cp <= 0x481 || cp >= 0x48A;
+    if (cp >= 0x531 && cp <= 0x588) return cp <= 0x556 || cp >= 0x560;
+    return (cp >= 0x1E00 && cp <= 0x1EFF) || (cp >= 0xFF21 && cp <= 0xFF3A) || (cp >= 0xFF41 && cp <= 0xFF5A);
+}
+
+// Σ at data[position] lowers to ς when a cased letter precedes it and none
+// follows, looking past case-ignorable characters (Python's str.lower())
+static bool isFinalSigma(const unsigned char* data, size_t size, size_t position, size_t length) {
+    uint32_t code_point;
+    size_t j = position;
+    bool cased_before = false;
+    while (j > 0) {
+        size_t start = j - 1;
+        while (start > 0 && j - start < 4 && (data[start] & 0xC0) == 0x80) start--;
+        if (decodeUtf8(data + start, j - start, code_point) != j - start) break;
+        if (!isCaseIgnorable(code_point)) {
+            cased_before = isCased(code_point);
+            break;
+        }
+        j = start;
+    }
+    if (!cased_before) return false;
+
+    j = position + length;
+    while (j < size) {
+        size_t next = decodeUtf8(data + j, size - j, code_point);
+        if (next == 0) return true;
+        if (!isCaseIgnorable(code_point)) return !isCased(code_point);
+        j += next;
+    }
+    return true;
+}
+
+#if defined(__ARM_NEON)
+// NEON has no movemask: weight each lane by its bit and add up the halves
+static inline uint32_t movemask(uint8x16_t mask) {
+    static const uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vandq_u8(mask, vld1q_u8(kBits));
+    return vaddv_u8(vget_low_u8(bits)) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+#endif
+
+// Masks for one 16-byte block; `lowered` receives the block with A-Z folded
+// and every whitespace byte turned into ' '. Returns false (nothing
+// written) when the block holds a non-ASCII byte.
+static inline bool scanAsciiBlock(const char* data, bool fold_case, bool split_punctuation, char* lowered,
+                                  uint32_t& space_mask, uint32_t& punct_mask) {
+#if defined(__SSE2__)
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    if (_mm_movemask_epi8(v) != 0) return false;
+
+    // All bytes are below 0x80 here, so signed compares are plain range checks
+    auto in_range = [&](char first, char last) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(first - 1))),
+                             _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(last + 1))));
+    };
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                 _mm_or_si128(in_range(0x09, 0x0D), in_range(0x1C, 0x1F)));
+    space_mask = static_cast<uint32_t>(_mm_movemask_epi8(space));
+    punct_mask = 0;
+    if (split_punctuation) {
+        __m128i punct = _mm_or_si128(_mm_or_si128(in_range(0x21, 0x2F), in_range(0x3A, 0x40)),
+                                     _mm_or_si128(in_range(0x5B, 0x60), in_range(0x7B, 0x7E)));
+        punct_mask = static_cast<uint32_t>(_mm_movemask_epi8(punct));
+    }
+
+    if (fold_case) {
+        v = _mm_add_epi8(v, _mm_and_si128(in_range('A', 'Z'), _mm_set1_epi8(0x20)));
+    }
+    v = _mm_or_si128(_mm_andnot_si128(space, v), _mm_and_si128(space, _mm_set1_epi8(' ')));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lowered), v);
+    return true;
+#elif defined(__ARM_NEON)
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(data));
+    if (vmaxvq_u8(v) >= 0x80) return false;
+
+    auto in_range = [&](uint8_t first, uint8_t last) {
+        return vandq_u8(vcgeq_u8(v, vdupq_n_u8(first)), vcleq_u8(v, vdupq_n_u8(last)));
+    };
+    uint8x16_t space = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vorrq_u8(in_range(0x09, 0x0D), in_range(0x1C, 0x1F)));
+    space_mask = movemask(space);
+    punct_mask = 0;
+    if (split_punctuation) {
+        uint8x16_t punct = vorrq_u8(vorrq_u8(in_range(0x21, 0x2F), in_range(0x3A, 0x40)),
+                                    vorrq_u8(in_range(0x5B, 0x60), in_range(0x7B, 0x7E)));
+        punct_mask = movemask(punct);
+    }
+
+    if (fold_case) {
+        v = vaddq_u8(v, vandq_u8(in_range('A', 'Z'), vdupq_n_u8(0x20)));
+    }
+    v = vbslq_u8(space, vdupq_n_u8(' '), v);
+    vst1q_u8(reinterpret_cast<uint8_t*>(lowered), v);
+    return true;
+#else
+    (void)data;
+    (void)fold_case;
+    (void)split_punctuation;
+    (void)lowered;
+    (void)space_mask;
+    (void)punct_mask;
+    return false;
+#endif
+}
+
+// One pass over the input. Output bytes go straight into `out`, which is
+// sized for the worst case up front (every input byte becomes at most two:
+// a punctuation token and its separator, or İ's three bytes for two) and
+// trimmed at the end.
+template <bool kTokens>
+static void run(std::string_view input, const NormalizerOptions& options, std::string& out,
+         std::vector<TextToken>* tokens) {
+    out.resize(2 * input.size() + 32);
+    char* const base = &out[0];
+    char* w = base;
+
+    const auto* data = reinterpret_cast<const unsigned char*>(input.data());
+    const size_t size = input.size();
+
+    // Open-token state kept in scalars so the byte stores through `w` do not alias it
+    bool in_token = false;
+    uint32_t token_begin = 0;
+    uint32_t token_source_begin = 0;
+    TextToken* token_out = nullptr;
+    TextToken* token_end = nullptr;
+    if (kTokens) {
+        if (tokens->size() < 16) tokens->resize(16);
+        tokens->resize(tokens->capacity());
+        token_out = tokens->data();
+        token_end = token_out + tokens->size();
+    }
+
+    auto begin_token = [&](size_t source_offset) {
+        if (w != base) *w++ = ' ';
+        in_token = true;
+        token_begin = static_cast<uint32_t>(w - base);
+        token_source_begin = static_cast<uint32_t>(source_offset);
+    };
+    auto end_token = [&](size_t source_end) {
+        in_token = false;
+        if (kTokens) {
+            if (token_out == token_end) {
+                size_t used = tokens->size();
+                tokens->resize(used * 2);
+                token_out = tokens->data() + used;
+                token_end = tokens->data() + tokens->size();
+            }
+            *token_out++ = TextToken{token_begin, static_cast<uint32_t>((w - base) - token_begin),
+                                     token_source_begin, static_cast<uint32_t>(source_end - token_source_begin)};
+        }
+    };
+    // A one-character token (split punctuation)
+    auto single_token = [&](size_t offset, const unsigned char* bytes, size_t length) {
+        if (in_token) end_token(offset);
+        begin_token(offset);
+        std::memcpy(w, bytes, length);
+        w += length;
+        end_token(offset + length);
+    };
+
+    size_t i = 0;
+    alignas(16) char lowered[16];
+
+    while (i < size) {
+        uint32_t space_mask = 0;
+        uint32_t punct_mask = 0;
+        if (i + 16 <= size &&
+            scanAsciiBlock(input.data() + i, options.fold_case, options.split_punctuation, lowered,
+                           space_mask, punct_mask)) {
+            // Words split by single separators are already normalized: store
+            // the whole block and read the token boundaries off the mask
+            if (punct_mask == 0 && (space_mask & (space_mask >> 1)) == 0 &&
+                (in_token || (space_mask & 1) == 0)) {
+                if (!in_token) begin_token(i);
+                char* block_out = w;
+                std::memcpy(block_out, lowered, 16);
+                if (kTokens) {
+                    for (uint32_t spaces = space_mask; spaces != 0; spaces &= spaces - 1) {
+                        uint32_t k = static_cast<uint32_t>(__builtin_ctz(spaces));
+                        w = block_out + k;
+                        end_token(i + k);
+                        if (k < 15) {
+                            in_token = true;
+                            token_begin = static_cast<uint32_t>(block_out + k + 1 - base);
+                            token_source_begin = static_cast<uint32_t>(i + k + 1);
+                        }
+                    }
+                }
+                // A trailing space is left for the next token to write
+                in_token = (space_mask >> 15) == 0;
+                w = block_out + (in_token ? 16 : 15);
+                i += 16;
+                continue;
+            }
+
+            uint32_t special = space_mask | punct_mask;
+
+            // Walk the separators; the bytes between them are word runs
+            size_t position = 0;
+            while (position < 16) {
+                size_t next = special ? static_cast<size_t>(__builtin_ctz(special)) : 16;
+                if (next > position) {
+                    if (!in_token) begin_token(i + position);
+                    std::memcpy(w, lowered + position, next - position);
+                    w += next - position;
+                }
+                if (next == 16) break;
+
+                if (space_mask & (1u << next)) {
+                    if (in_token) end_token(i + next);
+                } else {
+                    single_token(i + next, reinterpret_cast<const unsigned char*>(lowered + next), 1);
+                }
+                special &= special - 1;
+                position = next + 1;
+            }
+            i += 16;
+            continue;
+        }
+
+        // Scalar: the tail, a non-ASCII block, or no vector unit
+        size_t block_end = i + 16 < size ? i + 16 : size;
+        while (i < block_end) {
+            unsigned char c = data[i];
+            if (c < 0x80) {
+                if (isAsciiSpace(c)) {
+                    if (in_token) end_token(i);
+                } else if (options.split_punctuation && isAsciiPunct(c)) {
+                    single_token(i, data + i, 1);
+                } else {
+                    if (!in_token) begin_token(i);
+                    *w++ = static_cast<char>(options.fold_case && c >= 'A' && c <= 'Z' ? c + 0x20 : c);
+                }
+                i++;
+                continue;
+            }
+
+            uint32_t code_point;
+            size_t length = decodeUtf8(data + i, size - i, code_point);
+            if (length == 0) {
+                // Invalid byte: keep it as part of a word
+                if (!in_token) begin_token(i);
+                *w++ = static_cast<char>(data[i]);
+                i++;
+                continue;
+            }
+
+            CharClass char_class = classify(code_point);
+            if (char_class == CharClass::SPACE) {
+                if (in_token) end_token(i);
+            } else if (char_class == CharClass::PUNCT && options.split_punctuation) {
+                single_token(i, data + i, length);
+            } else {
+                if (!in_token) begin_token(i);
+                if (!options.fold_case) {
+                    std::memcpy(w, data + i, length);
+                    w += length;
+                } else if (code_point == 0x130) {
+                    // İ lowers to i + combining dot above
+                    *w++ = 'i';
+                    w = encodeUtf8(0x307, w);
+                } else if (code_point == 0x3A3) {
+                    w = encodeUtf8(isFinalSigma(data, size, i, length) ? 0x3C2 : 0x3C3, w);
+                } else {
+                    w = encodeUtf8(TextNormalizer::lowerCodePoint(code_point), w);
+                }
+            }
+            i += length;
+        }
+    }
+
+    if (in_token) end_token(size);
+    out.resize(static_cast<size_t>(w - base));
+    if (kTokens) tokens->resize(static_cast<size_t>(token_out - tokens->data()));
+}
+
+uint32_t TextNormalizer::lowerCodePoint(uint32_t cp) {
+    if (cp < 0x80) return (cp >= 'A' && cp <= 'Z') ? cp + 0x20 : cp;
+
+    if (cp >= 0x181 && cp <= 0x3FF) {
+        auto it = std::lower_bound(std::begin(kIrregularLower), std::end(kIrregularLower), cp,
+                                   [](const uint16_t (&pair)[2], uint32_t value) { return pair[0] < value; });
+        if (it != std::end(kIrregularLower) && (*it)[0] == cp) return (*it)[1];
+    }
+
+    // Latin-1 Supplement and Latin Extended-A/B
+    if (cp < 0x250) {
+        if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;
+        if (cp >= 0x100 && cp <= 0x12F) return cp | 1;
+        if (cp >= 0x132 && cp <= 0x137) return cp | 1;
+        if (cp >= 0x139 && cp <= 0x148) return (cp & 1) ? cp + 1 : cp;
+        if (cp >= 0x14A && cp <= 0x177) return cp | 1;
+        if (cp == 0x178) return 0xFF;
+        if (cp >= 0x179 && cp <= 0x17E) return (cp & 1) ? cp + 1 : cp;
+        if (cp >= 0x1CD && cp <= 0x1DC) return (cp & 1) ? cp + 1 : cp;
+        if (cp >= 0x1DE && cp <= 0x1EF) return cp | 1;
+        if (cp >= 0x1F8 && cp <= 0x21F) return cp | 1;
+        if (cp >= 0x222 && cp <= 0x233) return cp | 1;
+        if (cp >= 0x246 && cp <= 0x24F) return cp | 1;
+        return cp;
+    }
+
+    // Greek
+    if (cp >= 0x370 && cp < 0x400) {
+        if (cp == 0x386) return 0x3AC;
+        if (cp >= 0x388 && cp <= 0x38A) return cp + 37;
+        if (cp == 0x38C) return 0x3CC;
+        if (cp == 0x38E || cp == 0x38F) return cp + 63;
+        if ((cp >= 0x391 && cp <= 0x3A1) || (cp >= 0x3A3 && cp <= 0x3AB)) return cp + 0x20;
+        if (cp >= 0x3D8 && cp <= 0x3EF) return cp | 1;
+        return cp;
+    }
+
+    // Cyrillic and Cyrillic Supplement
+    if (cp >= 0x400 && cp < 0x530) {
+        if (cp <= 0x40F) return cp + 0x50;
+        if (cp <= 0x42F) return cp + 0x20;
+        if (cp >= 0x460 && cp <= 0x481) return cp | 1;
+        if (cp >= 0x48A && cp <= 0x4BF) return cp | 1;
+        if (cp == 0x4C0) return 0x4CF;
+        if (cp >= 0x4C1 && cp <= 0x4CE) return (cp & 1) ? cp + 1 : cp;
+        if (cp >= 0x4D0 && cp <= 0x52F) return cp | 1;
+        return cp;
+    }
+
+    // Armenian
+    if (cp >= 0x531 && cp <= 0x556) return cp + 0x30;
+
+    // Latin Extended Additional
+    if (cp >= 0x1E00 && cp <= 0x1EFF) {
+        if (cp == 0x1E9E) return 0xDF;
+        if (cp <= 0x1E95 || cp >= 0x1EA0) return cp | 1;
+        return cp;
+    }
+
+    // Letterlike symbols that lower into Latin/Greek letters
+    if (cp == 0x2126) return 0x3C9;
+    if (cp == 0x212A) return 'k';
+    if (cp == 0x212B) return 0xE5;
+
+    // Fullwidth Latin
+    if (cp >= 0xFF21 && cp <= 0xFF3A) return cp + 0x20;
+
+    return cp;
+}
+
+void TextNormalizer::normalize(std::string_view input, const NormalizerOptions& options, NormalizedText& out) {
+    out.tokens.clear();
+    run<true>(input, options, out.text, &out.tokens);
+}
+
+void TextNormalizer::normalizeText(std::string_view input, const NormalizerOptions& options, std::string& out) {
+    run<false>(input, options, out, nullptr);
+}
+
+const char* TextNormalizer::kernelName() {
+#if defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,63 @@
+#ifndef TEXT_NORMALIZER_H
+#define TEXT_NORMALIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// How an utterance is cut into model tokens. The defaults reproduce the
+// training pipeline's `sentence.lower().split()`; NER metadata can override
+// them with a "tokenizer" block ({"lowercase": true, "split_punctuation": true}).
+struct NormalizerOptions {
+    bool fold_case = true;           // Unicode lowercase, as Python's str.lower()
+    bool split_punctuation = false;  // Each punctuation character becomes its own token
+};
+
+// One token, located both in the normalized text and in the input
+struct TextToken {
+    uint32_t begin;
+    uint32_t length;
+    uint32_t source_begin;
+    uint32_t source_length;
+};
+
+struct NormalizedText {
+    std::string text;               // Tokens joined by single spaces
+    std::vector<TextToken> tokens;
+
+    std::string_view token(size_t i) const {
+        return std::string_view(text).substr(tokens[i].begin, tokens[i].length);
+    }
+    void clear() {
+        text.clear();
+        tokens.clear();
+    }
+};
+
+// Shared utterance normalizer for the SVM inputs, NER tokens and cache keys.
+// Runs of ASCII are lowered and split 16 bytes at a time (SSE2/NEON, scalar
+// fallback); other bytes are decoded as UTF-8 one code point at a time.
+//
+// - Whitespace is Python's str.split() set, including NBSP and the U+2000 block.
+// - Case folding matches str.lower() for Latin, monotonic Greek (final sigma
+//   included), Cyrillic, Armenian and fullwidth Latin; other scripts pass through.
+// - Punctuation is ASCII non-alphanumeric printables plus Unicode P* in the
+//   Latin-1, Greek, Armenian, General Punctuation, CJK and fullwidth blocks.
+// - Invalid UTF-8 bytes are copied through as word characters.
+class TextNormalizer {
+public:
+    // Tokens and their spans; `out` is cleared first
+    static void normalize(std::string_view input, const NormalizerOptions& options, NormalizedText& out);
+
+    // Only the joined text (SVM inputs, cache keys); `out` is cleared first
+    static void normalizeText(std::string_view input, const NormalizerOptions& options, std::string& out);
+
+    // Lowercase of one code point (itself when it has no single-code-point lowercase)
+    static uint32_t lowerCodePoint(uint32_t code_point);
+
+    // "sse2", "neon" or "scalar"
+    static const char* kernelName();
+};
+
+#endif // TEXT_NORMALIZER_H
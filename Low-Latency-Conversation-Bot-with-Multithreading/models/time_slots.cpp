@@ -0,0 +1,481 @@
+#include "time_slots.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <cstdio>
+
+enum class WordKind : uint8_t {
+    DAY,           // value: 0 = Monday .. 6 = Sunday
+    RELATIVE_DAY,  // value: days after the reference day
+    TONIGHT,       // Today, evening
+    HOUR,          // Spoken hour 1-12
+    MINUTES,       // Spoken minutes after an hour ("two thirty")
+    MERIDIEM,      // value: 0 for AM, 12 for PM
+    PERIOD,        // value: index into kPeriods
+    MODIFIER,      // value: 1 = early (first half), 2 = late (second half)
+    FIXED,         // value: minute of day (noon, midnight)
+    FRACTION,      // value: minutes of "half" / "quarter"
+    PAST,          // "half past two"
+    TO,            // "quarter to three", or a range join
+    RANGE_JOIN,    // "2 and 4", "10 until noon", "2-4"
+    OCLOCK
+};
+
+struct TimeWord {
+    std::string_view word;
+    WordKind kind;
+    int16_t value;
+};
+
+static constexpr TimeWord kTimeWords[] = {
+    {"-", WordKind::RANGE_JOIN, 0},
+    {"a.m", WordKind::MERIDIEM, 0},
+    {"after", WordKind::PAST, 0},
+    {"afternoon", WordKind::PERIOD, 1},
+    {"afternoons", WordKind::PERIOD, 1},
+    {"am", WordKind::MERIDIEM, 0},
+    {"and", WordKind::RANGE_JOIN, 0},
+    {"early", WordKind::MODIFIER, 1},
+    {"eight", WordKind::HOUR, 8},
+    {"eleven", WordKind::HOUR, 11},
+    {"evening", WordKind::PERIOD, 2},
+    {"evenings", WordKind::PERIOD, 2},
+    {"fifteen", WordKind::MINUTES, 15},
+    {"fifty", WordKind::MINUTES, 50},
+    {"five", WordKind::HOUR, 5},
+    {"forty", WordKind::MINUTES, 40},
+    {"fortyfive", WordKind::MINUTES, 45},
+    {"four", WordKind::HOUR, 4},
+    {"fri", WordKind::DAY, 4},
+    {"friday", WordKind::DAY, 4},
+    {"fridays", WordKind::DAY, 4},
+    {"half", WordKind::FRACTION, 30},
+    {"late", WordKind::MODIFIER, 2},
+    {"lunch", WordKind::PERIOD, 3},
+    {"lunchtime", WordKind::PERIOD, 3},
+    {"midday", WordKind::FIXED, 720},
+    {"midnight", WordKind::FIXED, 0},
+    {"mon", WordKind::DAY, 0},
+    {"monday", WordKind::DAY, 0},
+    {"mondays", WordKind::DAY, 0},
+    {"morning", WordKind::PERIOD, 0},
+    {"mornings", WordKind::PERIOD, 0},
+    {"night", WordKind::PERIOD, 2},
+    {"nine", WordKind::HOUR, 9},
+    {"noon", WordKind::FIXED, 720},
+    {"o'clock", WordKind::OCLOCK, 0},
+    {"oclock", WordKind::OCLOCK, 0},
+    {"one", WordKind::HOUR, 1},
+    {"p.m", WordKind::MERIDIEM, 12},
+    {"past", WordKind::PAST, 0},
+    {"pm", WordKind::MERIDIEM, 12},
+    {"quarter", WordKind::FRACTION, 15},
+    {"sat", WordKind::DAY, 5},
+    {"saturday", WordKind::DAY, 5},
+    {"saturdays", WordKind::DAY, 5},
+    {"seven", WordKind::HOUR, 7},
+    {"six", WordKind::HOUR, 6},
+    {"sun", WordKind::DAY, 6},
+    {"sunday", WordKind::DAY, 6},
+    {"sundays", WordKind::DAY, 6},
+    {"ten", WordKind::HOUR, 10},
+    {"thirty", WordKind::MINUTES, 30},
+    {"three", WordKind::HOUR, 3},
+    {"thu", WordKind::DAY, 3},
+    {"thur", WordKind::DAY, 3},
+    {"thurs", WordKind::DAY, 3},
+    {"thursday", WordKind::DAY, 3},
+    {"thursdays", WordKind::DAY, 3},
+    {"til", WordKind::RANGE_JOIN, 0},
+    {"till", WordKind::RANGE_JOIN, 0},
+    {"tmrw", WordKind::RELATIVE_DAY, 1},
+    {"to", WordKind::TO, 0},
+    {"today", WordKind::RELATIVE_DAY, 0},
+    {"tomorrow", WordKind::RELATIVE_DAY, 1},
+    {"tonight", WordKind::TONIGHT, 0},
+    {"tue", WordKind::DAY, 1},
+    {"tues", WordKind::DAY, 1},
+    {"tuesday", WordKind::DAY, 1},
+    {"tuesdays", WordKind::DAY, 1},
+    {"twelve", WordKind::HOUR, 12},
+    {"twenty", WordKind::MINUTES, 20},
+    {"two", WordKind::HOUR, 2},
+    {"until", WordKind::RANGE_JOIN, 0},
+    {"wed", WordKind::DAY, 2},
+    {"wednesday", WordKind::DAY, 2},
+    {"wednesdays", WordKind::DAY, 2},
+    {"weds", WordKind::DAY, 2},
+};
+
+// Minute-of-day ranges of the PERIOD words
+static constexpr int16_t kPeriods[][2] = {
+    {9 * 60, 12 * 60},   // morning
+    {12 * 60, 17 * 60},  // afternoon
+    {17 * 60, 20 * 60},  // evening / night
+    {12 * 60, 14 * 60}   // lunchtime
+};
+
+static constexpr const char* kDayNames[] = {
+    "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"
+};
+
+// Length in the top byte, then the first 7 bytes: one integer compare per
+// probe, and unique for every word in the table
+static constexpr uint64_t wordKey(std::string_view word) {
+    uint64_t key = static_cast<uint64_t>(word.size()) << 56;
+    for (size_t i = 0; i < word.size() && i < 7; i++) {
+        key |= static_cast<uint64_t>(static_cast<unsigned char>(word[i])) << (8 * i);
+    }
+    return key;
+}
+
+struct WordIndexEntry {
+    uint64_t key;
+    uint8_t word;  // Position in kTimeWords
+};
+
+constexpr size_t kTimeWordCount = sizeof(kTimeWords) / sizeof(kTimeWords[0]);
+
+// kTimeWords sorted by key, built at compile time
+static constexpr std::array<WordIndexEntry, kTimeWordCount> buildWordIndex() {
+    std::array<WordIndexEntry, kTimeWordCount> index{};
+    for (size_t i = 0; i < kTimeWordCount; i++) {
+        WordIndexEntry entry{wordKey(kTimeWords[i].word), static_cast<uint8_t>(i)};
+        size_t j = i;
+        for (; j > 0 && index[j - 1].key > entry.key; j--) index[j] = index[j - 1];
+        index[j] = entry;
+    }
+    return index;
+}
+
+static constexpr auto kWordIndex = buildWordIndex();
+
+static constexpr bool uniqueKeys() {
+    for (size_t i = 1; i < kTimeWordCount; i++) {
+        if (kWordIndex[i - 1].key == kWordIndex[i].key) return false;
+    }
+    return true;
+}
+static_assert(uniqueKeys(), "Two time words share a length and 7-byte prefix");
+
+static const TimeWord* lookupWord(std::string_view token) {
+    uint64_t key = wordKey(token);
+    auto it = std::lower_bound(kWordIndex.begin(), kWordIndex.end(), key,
+                               [](const WordIndexEntry& entry, uint64_t value) { return entry.key < value; });
+    if (it == kWordIndex.end() || it->key != key) return nullptr;
+    const TimeWord& word = kTimeWords[it->word];
+    return (token.size() <= 7 || word.word == token) ? &word : nullptr;
+}
+
+// Calls fn(token) for each lowercase ASCII token (letters, digits, ' : and
+// inner .); '-' is a token of its own. Over-long tokens are skipped.
+template <typename Fn>
+static void forEachToken(std::string_view text, Fn&& fn) {
+    char token[16];
+    size_t length = 0;
+    bool overflow = false;
+
+    auto flush = [&]() {
+        while (length > 0 && token[length - 1] == '.') length--;  // "p.m."
+        if (length > 0 && !overflow) fn(std::string_view(token, length));
+        length = 0;
+        overflow = false;
+    };
+
+    for (char raw : text) {
+        unsigned char c = static_cast<unsigned char>(raw);
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool digit = c >= '0' && c <= '9';
+
+        if (alpha || digit || c == '\'' || ((c == '.' || c == ':') && length > 0)) {
+            if (length < sizeof(token)) {
+                token[length++] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : static_cast<char>(c);
+            } else {
+                overflow = true;
+            }
+        } else {
+            flush();
+            if (c == '-') fn(std::string_view("-"));
+        }
+    }
+    flush();
+}
+
+// A clock time as written, before AM/PM is resolved
+struct Clock {
+    int hour = -1;
+    int minute = 0;
+    int meridiem = -1;   // 0 = AM, 12 = PM, -1 = not said
+    bool fixed = false;  // noon / midnight
+};
+
+// "2", "2pm", "2:30", "2:30p.m", "14.30", "1430"; false for dates ("15th") and other words
+static bool parseClockToken(std::string_view token, Clock& clock) {
+    size_t i = 0;
+    int number = 0;
+    while (i < token.size() && token[i] >= '0' && token[i] <= '9') {
+        if (i == 4) return false;
+        number = number * 10 + (token[i] - '0');
+        i++;
+    }
+    if (i == 0) return false;
+
+    clock.hour = number;
+    clock.minute = 0;
+    if (i >= 3) {
+        clock.hour = number / 100;  // "1430", "230"
+        clock.minute = number % 100;
+    } else if (i < token.size() && (token[i] == ':' || token[i] == '.')) {
+        if (i + 2 >= token.size()) return false;
+        char tens = token[i + 1];
+        char ones = token[i + 2];
+        if (tens < '0' || tens > '5' || ones < '0' || ones > '9') return false;
+        clock.minute = (tens - '0') * 10 + (ones - '0');
+        i += 3;
+    }
+
+    std::string_view suffix = token.substr(i);
+    if (suffix.empty()) {
+        clock.meridiem = -1;
+        return true;
+    }
+    if (suffix == "am" || suffix == "a.m") {
+        clock.meridiem = 0;
+        return true;
+    }
+    if (suffix == "pm" || suffix == "p.m") {
+        clock.meridiem = 12;
+        return true;
+    }
+    return false;
+}
+
+// Minute of day, or -1; an unsaid AM/PM falls back to `meridiem`, then salon hours
+static int resolveClock(const Clock& clock, int meridiem) {
+    if (clock.fixed) return clock.hour * 60 + clock.minute;
+
+    int hour = clock.hour;
+    if (clock.meridiem >= 0) meridiem = clock.meridiem;
+    if (hour > 12) {
+        if (clock.meridiem == 0) return -1;  // "14am"
+    } else if (meridiem >= 0) {
+        hour = hour % 12 + meridiem;
+    } else if (hour >= 1 && hour <= 7) {
+        hour += 12;
+    }
+
+    if (hour < 0 || hour > 23 || clock.minute < 0 || clock.minute > 59) return -1;
+    return hour * 60 + clock.minute;
+}
+
+int TimeSlotParser::parseDay(std::string_view text, int reference_day) {
+    int day = -1;
+    forEachToken(text, [&](std::string_view token) {
+        if (day >= 0) return;
+        const TimeWord* word = lookupWord(token);
+        if (!word) return;
+        if (word->kind == WordKind::DAY) {
+            day = word->value;
+        } else if ((word->kind == WordKind::RELATIVE_DAY || word->kind == WordKind::TONIGHT) && reference_day >= 0) {
+            day = (reference_day + word->value) % 7;
+        }
+    });
+    return day;
+}
+
+TimeOfDay TimeSlotParser::parseTime(std::string_view text) {
+    Clock clocks[2];
+    int count = 0;
+    bool joined = false;        // A range join after the first clock
+    bool minutes_open = false;  // The last token was a clock without minutes
+    bool tens_open = false;     // "forty" may take "five"
+    int period = -1;
+    int modifier = 0;
+    int fraction = 0;
+    int fraction_sign = 0;
+
+    auto addClock = [&](const Clock& clock) {
+        if (count == 2 || (count == 1 && !joined)) return false;
+        Clock& added = clocks[count++];
+        added = clock;
+        if (fraction_sign > 0) {
+            added.minute = fraction;
+        } else if (fraction_sign < 0) {
+            added.hour = added.hour - 1 == 0 ? 12 : added.hour - 1;
+            added.minute = 60 - fraction;
+        }
+        fraction = 0;
+        fraction_sign = 0;
+        return true;
+    };
+
+    forEachToken(text, [&](std::string_view token) {
+        bool was_minutes_open = minutes_open;
+        bool was_tens_open = tens_open;
+        minutes_open = false;
+        tens_open = false;
+
+        Clock clock;
+        if (token[0] >= '0' && token[0] <= '9') {
+            if (parseClockToken(token, clock)) {
+                bool has_minutes = token.find_first_of(":.") != std::string_view::npos || token.size() >= 3;
+                minutes_open = addClock(clock) && !has_minutes;
+            }
+            return;
+        }
+
+        const TimeWord* word = lookupWord(token);
+        if (!word) return;
+
+        switch (word->kind) {
+            case WordKind::HOUR:
+                if (was_tens_open && word->value <= 9) {
+                    clocks[count - 1].minute += word->value;  // "two forty five"
+                } else {
+                    clock.hour = word->value;
+                    minutes_open = addClock(clock);
+                }
+                break;
+            case WordKind::MINUTES:
+                if (was_minutes_open) {
+                    clocks[count - 1].minute = word->value;  // "two thirty"
+                    tens_open = word->value >= 20 && word->value % 10 == 0;
+                } else {
+                    fraction = word->value;  // "fifteen past"
+                }
+                break;
+            case WordKind::MERIDIEM:
+                if (count > 0 && clocks[count - 1].meridiem < 0 && !clocks[count - 1].fixed) {
+                    clocks[count - 1].meridiem = word->value;
+                }
+                break;
+            case WordKind::PERIOD:
+                period = word->value;
+                break;
+            case WordKind::TONIGHT:
+                period = 2;
+                break;
+            case WordKind::MODIFIER:
+                modifier = word->value;
+                break;
+            case WordKind::FIXED:
+                clock.hour = word->value / 60;
+                clock.fixed = true;
+                addClock(clock);
+                break;
+            case WordKind::FRACTION:
+                fraction = word->value;
+                break;
+            case WordKind::PAST:
+                if (fraction > 0) fraction_sign = 1;
+                break;
+            case WordKind::TO:
+                if (fraction > 0) {
+                    fraction_sign = -1;
+                } else if (count == 1) {
+                    joined = true;
+                }
+                break;
+            case WordKind::RANGE_JOIN:
+                if (count == 1) joined = true;
+                break;
+            case WordKind::OCLOCK:
+                minutes_open = was_minutes_open;
+                break;
+            case WordKind::DAY:
+            case WordKind::RELATIVE_DAY:
+                break;
+        }
+    });
+
+    // "in the morning" says AM, "afternoon"/"evening"/"lunchtime" PM
+    int period_meridiem = period < 0 ? -1 : (period == 0 ? 0 : 12);
+    TimeOfDay result;
+
+    if (count == 2) {
+        int end = resolveClock(clocks[1], period_meridiem);
+        int begin = resolveClock(clocks[0], clocks[1].meridiem >= 0 ? clocks[1].meridiem : period_meridiem);
+        if (begin >= end && clocks[0].meridiem < 0) begin = resolveClock(clocks[0], -1);  // "11 to 2pm"
+        if (begin >= 0 && end > begin) {
+            result.begin = static_cast<int16_t>(begin);
+            result.end = static_cast<int16_t>(end);
+            return result;
+        }
+    }
+
+    if (count >= 1) {
+        int begin = resolveClock(clocks[0], period_meridiem);
+        if (begin >= 0) {
+            result.begin = static_cast<int16_t>(begin);
+            result.end = static_cast<int16_t>(std::min(begin + kDefaultAppointmentMinutes, kMinutesPerDay));
+            result.exact = true;
+            return result;
+        }
+    }
+
+    if (period >= 0) {
+        int begin = kPeriods[period][0];
+        int end = kPeriods[period][1];
+        int middle = (begin + end) / 2;
+        if (modifier == 1) end = middle;
+        if (modifier == 2) begin = middle;
+        result.begin = static_cast<int16_t>(begin);
+        result.end = static_cast<int16_t>(end);
+    }
+    return result;
+}
+
+SlotRange TimeSlotParser::parse(std::string_view day_text, std::string_view time_text, int reference_day) {
+    // Either field may hold both parts ("Friday afternoon")
+    int day = parseDay(day_text, reference_day);
+    if (day < 0) day = parseDay(time_text, reference_day);
+
+    TimeOfDay time = parseTime(time_text);
+    if (!time.valid()) time = parseTime(day_text);
+
+    SlotRange range;
+    if (day < 0) return range;
+
+    if (time.valid()) {
+        range.begin = slotId(day, time.begin);
+        range.end = slotId(day, time.end);
+        range.exact = time.exact;
+    } else {
+        range.begin = slotId(day, 0);
+        range.end = slotId(day, kMinutesPerDay);
+    }
+    return range;
+}
+
+const char* TimeSlotParser::dayName(int day) {
+    return (day >= 0 && day < 7) ? kDayNames[day] : "Unknown";
+}
+
+static int formatClock(char* out, size_t size, int minute_of_day) {
+    int hour = minute_of_day / 60 % 24;
+    int display = hour % 12 == 0 ? 12 : hour % 12;
+    return std::snprintf(out, size, "%d:%02d %s", display, minute_of_day % 60, hour < 12 ? "AM" : "PM");
+}
+
+std::string TimeSlotParser::formatSlot(int32_t slot_id) {
+    if (slot_id < 0) return "Unknown";
+    char buffer[32];
+    formatClock(buffer, sizeof(buffer), slot_id % kMinutesPerDay);
+    return std::string(dayName(slot_id / kMinutesPerDay % 7)) + " " + buffer;
+}
+
+std::string TimeSlotParser::formatRange(const SlotRange& range) {
+    if (!range.valid()) return "Unknown";
+    if (range.exact) return formatSlot(range.begin);
+
+    int begin = range.begin % kMinutesPerDay;
+    int length = range.end - range.begin;
+    std::string text = dayName(range.day());
+    if (begin == 0 && length >= kMinutesPerDay) return text;
+
+    char buffer[48];
+    int written = formatClock(buffer, sizeof(buffer), begin);
+    buffer[written++] = '-';
+    formatClock(buffer + written, sizeof(buffer) - written, begin + length);
+    return text + " " + buffer;
+}
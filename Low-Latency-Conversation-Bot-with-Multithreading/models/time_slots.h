@@ -0,0 +1,67 @@
+#ifndef TIME_SLOTS_H
+#define TIME_SLOTS_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+// Slot ids are minutes since Monday 00:00
+constexpr int32_t kMinutesPerDay = 24 * 60;
+constexpr int32_t kMinutesPerWeek = 7 * kMinutesPerDay;
+constexpr int32_t kDefaultAppointmentMinutes = 60;  // Footprint of a booking at an exact time
+
+// Time of day from a time_preference value, in minutes since midnight
+struct TimeOfDay {
+    int16_t begin = -1;
+    int16_t end = -1;    // Exclusive; begin + kDefaultAppointmentMinutes for an exact time
+    bool exact = false;  // "2:30 PM" vs "afternoon" or "between 2 and 4"
+
+    bool valid() const { return begin >= 0; }
+};
+
+// Half-open [begin, end) range of minute-of-week slot ids
+struct SlotRange {
+    int32_t begin = -1;
+    int32_t end = -1;
+    bool exact = false;  // Day and start minute both known
+
+    bool valid() const { return begin >= 0 && end > begin; }
+    int day() const { return valid() ? begin / kMinutesPerDay : -1; }
+    bool overlaps(const SlotRange& other) const {
+        return valid() && other.valid() && begin < other.end && other.begin < end;
+    }
+};
+
+// Deterministic parser for extracted day_preference / time_preference text.
+// Lowercase ASCII tokens are matched against static tables; nothing is
+// allocated and unknown words are skipped.
+//
+// - Days: weekday names, abbreviations and plurals; "today"/"tonight"/
+//   "tomorrow" only when a reference weekday is given.
+// - Times: "2 PM", "2:30pm", "14:00", "14.30", "two thirty", "half past
+//   two", "quarter to 3", "noon", "midnight", "3 o'clock".
+// - Periods: morning 9-12, afternoon 12-17, evening 17-20, lunchtime 12-14,
+//   narrowed to the first or second half by "early" / "late".
+// - Ranges: "between 2 and 4 PM", "2-4pm", "from 10 until noon".
+// - An hour without AM/PM is read as salon hours: 1-7 PM, 8-11 AM.
+class TimeSlotParser {
+public:
+    // 0 = Monday .. 6 = Sunday, or -1; reference_day resolves today/tomorrow
+    static int parseDay(std::string_view text, int reference_day = -1);
+
+    static TimeOfDay parseTime(std::string_view text);
+
+    // Exact time -> one appointment footprint, period -> its range, no time
+    // -> the whole day; invalid when the day is unknown
+    static SlotRange parse(std::string_view day_text, std::string_view time_text, int reference_day = -1);
+
+    static int32_t slotId(int day, int minute_of_day) { return day * kMinutesPerDay + minute_of_day; }
+
+    // "Friday 2:30 PM" for a slot id, "Friday afternoon"-style ranges as "Friday 12:00 PM-5:00 PM"
+    static std::string formatSlot(int32_t slot_id);
+    static std::string formatRange(const SlotRange& range);
+
+    static const char* dayName(int day);
+};
+
+#endif // TIME_SLOTS_H
@@ -0,0 +1,180 @@
+#ifndef TRANSCRIPT_RING_H
+#define TRANSCRIPT_RING_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <array>
+#include <initializer_list>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// What a transcript line records
+enum class TranscriptKind : uint8_t {
+    CALLER,  // "Caller: <sentence>"
+    BOT,     // "Bot: <question or closing>"
+    ENTITY   // "Entity: <entity>=<value>"
+};
+
+// Bounded per-session transcript of recent turns and entity events.
+//
+// Lines are stored back to back in a fixed inline buffer that lives inside
+// the session state, so a session's history never allocates. When a new line
+// does not fit, the oldest lines are dropped and the rest are moved to the
+// front, which keeps every window contiguous: window() hands out a
+// string_view over the most recent lines without copying them.
+//
+// Not thread-safe; the owning session's turn serialization guards it. A
+// window stays valid until the next append()/clear() on the same ring; work
+// that may outlive that (composer/closer tasks) gets a TranscriptSnapshot.
+template <size_t Capacity = 2048, size_t MaxLines = 32>
+class TranscriptRing {
+private:
+    struct Line {
+        uint32_t offset;
+        uint32_t length;  // Including the trailing '\n'
+        TranscriptKind kind;
+    };
+
+    std::array<char, Capacity> buffer;
+    std::array<Line, MaxLines> lines;  // Circular: lines[first] is the oldest
+    size_t first = 0;
+    size_t count = 0;
+    size_t used = 0;
+    uint64_t appended = 0;
+    uint64_t dropped = 0;
+
+    static std::string_view prefixFor(TranscriptKind kind) {
+        switch (kind) {
+            case TranscriptKind::CALLER: return "Caller: ";
+            case TranscriptKind::BOT:    return "Bot: ";
+            case TranscriptKind::ENTITY: return "Entity: ";
+        }
+        return "";
+    }
+
+    const Line& line(size_t index) const {
+        return lines[(first + index) % MaxLines];
+    }
+
+    // Drop oldest lines until `length` more bytes and one more line fit
+    void makeRoom(size_t length) {
+        size_t drop_bytes = 0;
+        while (count > 0 && (used - drop_bytes + length > Capacity || count == MaxLines)) {
+            drop_bytes += lines[first].length;
+            first = (first + 1) % MaxLines;
+            count--;
+            dropped++;
+        }
+        if (drop_bytes == 0) return;
+
+        used -= drop_bytes;
+        std::memmove(buffer.data(), buffer.data() + drop_bytes, used);
+        for (size_t i = 0; i < count; ++i) {
+            lines[(first + i) % MaxLines].offset -= static_cast<uint32_t>(drop_bytes);
+        }
+    }
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Append one line made of the kind's prefix plus `parts`; an oversized
+    // line is cut to fit the whole buffer
+    void append(TranscriptKind kind, std::initializer_list<std::string_view> parts) {
+        std::string_view prefix = prefixFor(kind);
+        size_t length = prefix.size() + 1;
+        for (std::string_view part : parts) length += part.size();
+        if (length > Capacity) length = Capacity;
+
+        makeRoom(length);
+
+        char* out = buffer.data() + used;
+        size_t room = length - 1;  // Keep the last byte for '\n'
+        auto write = [&](std::string_view text) {
+            size_t n = text.size() < room ? text.size() : room;
+            std::memcpy(out, text.data(), n);
+            out += n;
+            room -= n;
+        };
+        write(prefix);
+        for (std::string_view part : parts) write(part);
+        *out = '\n';
+
+        lines[(first + count) % MaxLines] = Line{static_cast<uint32_t>(used), static_cast<uint32_t>(length), kind};
+        count++;
+        used += length;
+        appended++;
+    }
+
+    void appendTurn(std::string_view sentence) { append(TranscriptKind::CALLER, {sentence}); }
+    void appendReply(std::string_view reply) { append(TranscriptKind::BOT, {reply}); }
+    void appendEntity(std::string_view entity, std::string_view value) {
+        append(TranscriptKind::ENTITY, {entity, "=", value});
+    }
+
+    // The last `max_lines` lines, oldest first
+    std::string_view window(size_t max_lines) const {
+        if (max_lines == 0 || count == 0) return {};
+        size_t start = max_lines >= count ? 0 : line(count - max_lines).offset;
+        return std::string_view(buffer.data() + start, used - start);
+    }
+
+    // The most recent whole lines that fit in `max_bytes`
+    std::string_view windowBytes(size_t max_bytes) const {
+        size_t start = used;
+        for (size_t i = count; i > 0; --i) {
+            const Line& candidate = line(i - 1);
+            if (used - candidate.offset > max_bytes) break;
+            start = candidate.offset;
+        }
+        return std::string_view(buffer.data() + start, used - start);
+    }
+
+    std::string_view all() const { return std::string_view(buffer.data(), used); }
+
+    // Lines from the `line_number`-th append on (a linesAppended() value taken
+    // before them), or every retained line if some of those were dropped
+    std::string_view since(uint64_t line_number) const {
+        uint64_t oldest = appended - count;
+        if (line_number >= appended) return std::string_view(buffer.data() + used, 0);
+        size_t start = line_number <= oldest ? 0 : line(static_cast<size_t>(line_number - oldest)).offset;
+        return std::string_view(buffer.data() + start, used - start);
+    }
+
+    // Text of the newest line of `kind` without its prefix ("" if none left)
+    std::string_view latest(TranscriptKind kind) const {
+        for (size_t i = count; i > 0; --i) {
+            const Line& candidate = line(i - 1);
+            if (candidate.kind != kind) continue;
+            size_t skip = prefixFor(kind).size();
+            return std::string_view(buffer.data() + candidate.offset + skip, candidate.length - skip - 1);
+        }
+        return {};
+    }
+
+    void clear() {
+        first = 0;
+        count = 0;
+        used = 0;
+    }
+
+    size_t lineCount() const { return count; }
+    size_t bytesUsed() const { return used; }
+    uint64_t linesAppended() const { return appended; }
+    uint64_t linesDropped() const { return dropped; }
+};
+
+// Default sizing for a conversation: ~2KB, the last 32 lines
+using SessionTranscript = TranscriptRing<>;
+
+// Owned, immutable copy of a window. Requests carry one of these rather than
+// a view, so a task still queued or running after the turn moves on never
+// reads lines that were overwritten; copies of a request share the text.
+using TranscriptSnapshot = std::shared_ptr<const std::string>;
+
+inline TranscriptSnapshot snapshotOf(std::string_view window) {
+    return std::make_shared<const std::string>(window);
+}
+
+#endif // TRANSCRIPT_RING_H
@@ -0,0 +1,214 @@
+#include "../models/prompt_builder.h"
+#include "../models/composer.h"
+#include "../models/http_llm_client.h"
+#include "../models/transcript_ring.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Per-session prompt prefixes: a session's prompts share one prefix_id, each
+// turn's prefix extends the previous one with the session's history, and
+// the delta carries only the new turn. The second half replays a session
+// through HttpLLMClient against tools/llm_stub_server and checks that the
+// stub's prompt cache served every earlier prefix.
+//
+//   ./session_prefix_test [http://127.0.0.1:8080/v1/completions]   (or LLM_ENDPOINT)
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "  ✅ " : "  ❌ ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+static bool startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// One turn as the controllers build it: the caller line is new, everything
+// before it is history
+struct Turn {
+    CompositionRequest request;
+    LLMPrompt prompt;
+};
+
+static void runTurn(PromptBuilder& builder, SessionTranscript& transcript, uint64_t session_key,
+                    const std::string& sentence, Turn& turn) {
+    uint64_t turn_start = transcript.linesAppended();
+    transcript.appendTurn(sentence);
+    TranscriptSnapshot context = snapshotOf(transcript.all());
+
+    turn.request = CompositionRequest({"phone_number"}, {{"caller_name", "Sam"}}, context);
+    turn.request.session_key = session_key;
+    turn.request.history_length = context->size() - transcript.since(turn_start).size();
+    turn.prompt = builder.buildQuestion(turn.request);
+}
+
+static const std::vector<std::string> kSentences = {
+    "Hi, I'd like a haircut",
+    "My name is Sam",
+    "Thursday afternoon if possible",
+};
+
+static void testTranscriptSince() {
+    std::cout << "TranscriptRing::since" << std::endl;
+    TranscriptRing<64, 4> ring;
+    ring.appendTurn("one");
+    uint64_t mark = ring.linesAppended();
+    ring.appendReply("two");
+    ring.appendTurn("three");
+    check(ring.since(mark) == "Bot: two\nCaller: three\n", "lines after the mark");
+    check(ring.since(ring.linesAppended()).empty(), "nothing after the last line");
+    for (int i = 0; i < 4; i++) ring.appendTurn("filler");
+    check(ring.since(mark) == ring.all(), "dropped lines fall back to everything retained");
+}
+
+static void testPromptShape() {
+    std::cout << "PromptBuilder session prefixes" << std::endl;
+    PromptBuilder builder;
+    SessionTranscript transcript;
+    uint64_t key = PromptBuilder::newSessionKey("session-a");
+    transcript.appendReply("What can I do for you?");
+
+    std::vector<Turn> turns(kSentences.size());
+    for (size_t i = 0; i < kSentences.size(); i++) {
+        runTurn(builder, transcript, key, kSentences[i], turns[i]);
+        transcript.appendReply(builder.getBusinessContext() + " question " + std::to_string(i));
+    }
+
+    bool same_id = true;
+    bool extends = true;
+    bool delta_only_new = true;
+    for (size_t i = 0; i < turns.size(); i++) {
+        const LLMPrompt& prompt = turns[i].prompt;
+        std::string prefix = prompt.text().substr(0, prompt.prefixLength());
+        same_id = same_id && prompt.prefix_id == turns[0].prompt.prefix_id;
+        if (i > 0) {
+            const LLMPrompt& previous = turns[i - 1].prompt;
+            extends = extends && startsWith(prefix, previous.text().substr(0, previous.prefixLength()));
+        }
+        delta_only_new = delta_only_new && startsWith(prompt.delta, "Caller: " + kSentences[i] + "\n");
+        for (size_t earlier = 0; earlier < i; earlier++) {
+            delta_only_new = delta_only_new && prompt.delta.find(kSentences[earlier]) == std::string::npos;
+            extends = extends && prefix.find(kSentences[earlier]) != std::string::npos;
+        }
+    }
+    check(same_id, "prefix_id is the same on every turn of the session");
+    check(turns[0].prompt.prefix_id != builder.getPrefixId(PromptKind::QUESTION), "prefix_id is not the global one");
+    check(extends, "each prefix extends the previous one with the session's history");
+    check(delta_only_new, "the delta carries only the new turn");
+
+    SessionTranscript other_transcript;
+    Turn other;
+    runTurn(builder, other_transcript, PromptBuilder::newSessionKey("session-b"), kSentences[0], other);
+    check(other.prompt.prefix_id != turns[0].prompt.prefix_id, "another session gets another prefix_id");
+    check(PromptBuilder::newSessionKey("session-a") != key, "a reused session id gets a new key");
+
+    CompositionRequest legacy({"phone_number"}, {}, snapshotOf("Caller: hello\n"));
+    LLMPrompt legacy_prompt = builder.buildQuestion(legacy);
+    check(legacy_prompt.prefix_id == builder.getPrefixId(PromptKind::QUESTION) && legacy_prompt.history.empty() &&
+              startsWith(legacy_prompt.delta, "Caller: hello\n"),
+          "without a session key the context stays in the delta");
+}
+
+// GET /stats from the stub (one request, Connection: close)
+static json stubStats(const LLMEndpointConfig& config) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(config.port));
+    inet_pton(AF_INET, config.host == "localhost" ? "127.0.0.1" : config.host.c_str(), &address.sin_addr);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("cannot reach the stub at " + config.host + ":" + std::to_string(config.port));
+    }
+
+    std::string request = "GET /stats HTTP/1.1\r\nHost: " + config.host + "\r\nConnection: close\r\n\r\n";
+    ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string response;
+    char chunk[4096];
+    ssize_t n;
+    while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) response.append(chunk, static_cast<size_t>(n));
+    ::close(fd);
+
+    size_t body = response.find("\r\n\r\n");
+    if (body == std::string::npos) throw std::runtime_error("bad /stats response");
+    return json::parse(response.substr(body + 4));
+}
+
+static void testAgainstStub(const std::string& url) {
+    std::cout << "Session replay against " << url << std::endl;
+    LLMEndpointConfig config = LLMEndpointConfig::fromUrl(url);
+    config.prewarm_connections = 0;
+    HttpLLMClient client(config);
+
+    PromptBuilder builder;
+    SessionTranscript transcript;
+    uint64_t key = PromptBuilder::newSessionKey("stub-session");
+    transcript.appendReply("What can I do for you?");
+
+    json before = stubStats(config);
+    uint64_t expected_cached = 0;
+    size_t previous_prefix = 0;
+    std::vector<Turn> turns(kSentences.size());
+    for (size_t i = 0; i < kSentences.size(); i++) {
+        runTurn(builder, transcript, key, kSentences[i], turns[i]);
+        std::string reply = client.complete(turns[i].prompt);
+        check(!reply.empty(), "turn " + std::to_string(i + 1) + " answered");
+        transcript.appendEntity("caller_name", "Sam");
+        transcript.appendReply(reply);
+
+        // The previous turn's prefix is all this one shares with what the stub cached
+        expected_cached += previous_prefix;
+        previous_prefix = turns[i].prompt.prefixLength();
+    }
+    json after = stubStats(config);
+
+    uint64_t requests = after["requests"].get<uint64_t>() - before["requests"].get<uint64_t>();
+    uint64_t cached = after["cached_bytes"].get<uint64_t>() - before["cached_bytes"].get<uint64_t>();
+    uint64_t sent = after["prompt_bytes"].get<uint64_t>() - before["prompt_bytes"].get<uint64_t>();
+    check(requests == kSentences.size(), "one completion per turn");
+    check(cached == expected_cached, "stub served every earlier prefix from its cache (" + std::to_string(cached) +
+                                         " of " + std::to_string(sent) + " bytes)");
+}
+
+int main(int argc, char** argv) {
+    testTranscriptSince();
+    testPromptShape();
+
+    const char* endpoint = argc > 1 ? argv[1] : std::getenv("LLM_ENDPOINT");
+    if (endpoint && *endpoint) {
+        try {
+            testAgainstStub(endpoint);
+        } catch (const std::exception& e) {
+            check(false, std::string("stub replay: ") + e.what());
+        }
+    } else {
+        std::cout << "Session replay skipped (no endpoint; start tools/llm_stub_server and pass its URL)" << std::endl;
+    }
+
+    std::cout << (failures == 0 ? "✅ All checks passed" : "❌ " + std::to_string(failures) + " checks failed")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tests/session_prefix_test.cpp models/prompt_builder.cpp models/http_llm_client.cpp -pthread -o session_prefix_test
+
+USAGE:
+======
+./llm_stub_server 8080 &
+./session_prefix_test http://127.0.0.1:8080/v1/completions
+*/
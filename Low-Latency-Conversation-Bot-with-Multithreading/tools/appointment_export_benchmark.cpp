@@ -0,0 +1,120 @@
+#include "../models/appointment_export.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+// Booking latency while a large export runs, against the old export path
+// (copy the vector, then toJSON() per row through a stringstream):
+//
+//   ./appointment_export_benchmark [rows] [output.csv] [--gzip]
+
+static const char* kServices[] = {"haircut", "balayage", "cut and colour", "beard trim", "blow dry", "highlights"};
+static const char* kStylists[] = {"Sam", "Alex", "Priya", "Jordan", "Mei"};
+
+static AppointmentSummary makeAppointment(size_t i) {
+    AppointmentSummary apt;
+    apt.customer_name = "Customer " + std::to_string(i);
+    apt.customer_phone = "07700 9" + std::to_string(10000 + i % 90000);
+    apt.service_requested = kServices[i % 6];
+    apt.stylist = kStylists[i % 5];
+    int32_t begin = TimeSlotParser::slotId(static_cast<int>(i % 6), 9 * 60 + 15 * static_cast<int>(i % 40));
+    apt.slot = SlotRange{begin, begin + 60, true};
+    apt.preferred_day = TimeSlotParser::dayName(apt.slot.day());
+    apt.preferred_time = TimeSlotParser::formatSlot(begin);
+    apt.booking_timestamp = "2026-10-17 09:30:00";
+    apt.status = i % 17 == 0 ? "pending" : "confirmed";
+    if (i % 101 == 0) apt.customer_name += ", \"VIP\"";  // Exercises CSV quoting
+    return apt;
+}
+
+// Appends `count` rows (the writer is serialized, as under appointments_mutex)
+// and returns the latency of each append in microseconds
+static std::vector<double> book(AppointmentStore& store, size_t first, size_t count) {
+    std::vector<double> latencies;
+    latencies.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        AppointmentSummary apt = makeAppointment(first + i);
+        auto start = std::chrono::steady_clock::now();
+        store.append(apt);
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(50));  // Bookings trickle in
+    }
+    return latencies;
+}
+
+static void printLatencies(const char* label, std::vector<double> latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) { return latencies[static_cast<size_t>(q * (latencies.size() - 1))]; };
+    std::cout << "📊 " << label << ": p50 " << at(0.5) << " µs, p99 " << at(0.99)
+              << " µs, max " << latencies.back() << " µs" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = 2000000;
+    std::string path = "/tmp/appointments.csv";
+    ExportOptions options;
+    for (int i = 1, positional = 0; i < argc; i++) {
+        if (std::strcmp(argv[i], "--gzip") == 0) options.gzip = true;
+        else if (positional++ == 0) rows = std::strtoul(argv[i], nullptr, 10);
+        else path = argv[i];
+    }
+
+    AppointmentStore store;
+    for (size_t i = 0; i < rows; i++) store.append(makeAppointment(i));
+    std::cout << "💾 " << rows << " appointments stored" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    printLatencies("booking, idle", book(store, rows, 2000));
+
+    // Bookings continue while the snapshot streams out
+    std::atomic<bool> exporting{true};
+    ExportResult result;
+    std::thread exporter([&] {
+        result = AppointmentExporter::writeCsv(store.snapshot(), path, options);
+        exporting = false;
+    });
+    std::vector<double> during;
+    size_t next = rows + 2000;
+    while (exporting) {
+        auto batch = book(store, next, 100);
+        next += batch.size();
+        during.insert(during.end(), batch.begin(), batch.end());
+    }
+    exporter.join();
+    if (!result.ok) return 1;
+    printLatencies("booking, during export", during);
+    std::cout << "📊 Export: " << result.rows << " rows, " << result.bytes / result.seconds / 1e6
+              << " MB/s of CSV, " << during.size() << " bookings made meanwhile" << std::endl;
+
+    // Old path, on a slice (it holds the store mutex for the whole copy)
+    size_t slice = std::min<size_t>(rows, 200000);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<AppointmentSummary> copy = store.snapshot().toVector();
+    copy.resize(slice);
+    std::stringstream out;
+    for (const auto& apt : copy) out << apt.toJSON() << "\n";
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "📊 Copy + toJSON (" << slice << " rows): " << out.str().size() / seconds / 1e6 << " MB/s" << std::endl;
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/appointment_export_benchmark.cpp models/appointment_export.cpp models/appointment_store.cpp models/time_slots.cpp -pthread -o appointment_export_benchmark
+# With gzip output
+g++ -std=c++17 -O2 -DHAVE_ZLIB tools/appointment_export_benchmark.cpp models/appointment_export.cpp models/appointment_store.cpp models/time_slots.cpp -pthread -lz -o appointment_export_benchmark
+
+USAGE:
+======
+./appointment_export_benchmark
+./appointment_export_benchmark 5000000 /tmp/appointments.csv.gz --gzip
+*/
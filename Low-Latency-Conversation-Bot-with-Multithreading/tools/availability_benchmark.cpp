@@ -0,0 +1,113 @@
+#include "../models/availability_index.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+// Availability queries against a busy salon chain: ~100k bookings across
+// ~2000 stylists, timed through AvailabilityIndex and through the linear
+// scan over stored appointments that AppointmentManager used to do.
+//
+//   ./availability_benchmark [stylists] [bookings]
+
+// What the old conflict check walked: one record of strings per appointment
+struct StoredAppointment {
+    std::string day;
+    std::string time;
+    std::string stylist;
+};
+
+template <typename Fn>
+static double microsecondsPerCall(size_t calls, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; i++) fn(i);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e6 / calls;
+}
+
+int main(int argc, char** argv) {
+    int stylists = argc > 1 ? std::atoi(argv[1]) : 2000;
+    size_t bookings = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+    AvailabilityConfig config;
+    for (int i = 0; i < stylists; i++) config.stylists.push_back("Stylist " + std::to_string(i));
+    AvailabilityIndex index(config);
+
+    // Random 30-120 minute bookings on quarter hours within opening hours
+    std::mt19937 rng(42);
+    std::vector<StoredAppointment> stored;
+    stored.reserve(bookings);
+    size_t attempts = 0;
+    while (stored.size() < bookings && attempts < bookings * 20) {
+        attempts++;
+        int stylist = static_cast<int>(rng() % stylists);
+        int day = static_cast<int>(rng() % 6);
+        int minutes = 30 * static_cast<int>(1 + rng() % 4);
+        int start = config.open_minute + 15 * static_cast<int>(rng() % ((config.close_minute - config.open_minute - minutes) / 15 + 1));
+        int32_t begin = TimeSlotParser::slotId(day, start);
+        if (!index.book(stylist, SlotRange{begin, begin + minutes, true})) continue;
+        stored.push_back({TimeSlotParser::dayName(day), TimeSlotParser::formatSlot(begin), index.stylistName(stylist)});
+    }
+
+    std::cout << "💇 " << stylists << " stylists, " << stored.size() << " bookings ("
+              << index.memoryBytes() / 1024 << " KB of bitmaps)" << std::endl;
+
+    // Query mix: a random stylist and an hour-long slot at a random quarter hour
+    const size_t queries = 20000;
+    std::vector<std::pair<int, int32_t>> probes(queries);
+    for (auto& probe : probes) {
+        probe.first = static_cast<int>(rng() % stylists);
+        probe.second = TimeSlotParser::slotId(static_cast<int>(rng() % 7), 15 * static_cast<int>(rng() % 96));
+    }
+
+    size_t sink = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    double is_free = microsecondsPerCall(queries, [&](size_t i) {
+        sink += index.isFree(probes[i].first, SlotRange{probes[i].second, probes[i].second + 60, true});
+    });
+    double any_free = microsecondsPerCall(queries, [&](size_t i) {
+        sink += index.anyFree(SlotRange{probes[i].second, probes[i].second + 60, true}) + 1;
+    });
+    double next_one = microsecondsPerCall(queries, [&](size_t i) {
+        sink += index.nextFree(probes[i].first, probes[i].second, 90, 3).size();
+    });
+    double next_any = microsecondsPerCall(queries / 10, [&](size_t i) {
+        sink += index.nextFree(-1, probes[i].second, 90, 3).size();
+    });
+
+    // The scan only compares strings, so it cannot even see overlaps
+    const size_t scan_queries = 200;
+    double scan = microsecondsPerCall(scan_queries, [&](size_t i) {
+        std::string day = TimeSlotParser::dayName(probes[i].second / kMinutesPerDay);
+        std::string time = TimeSlotParser::formatSlot(probes[i].second);
+        const std::string& stylist = index.stylistName(probes[i].first);
+        for (const auto& apt : stored) {
+            if (apt.day == day && apt.time == time && apt.stylist == stylist) {
+                sink++;
+                break;
+            }
+        }
+    });
+
+    std::cout << "📊 isFree (one stylist):        " << is_free << " µs" << std::endl;
+    std::cout << "📊 anyFree (whole roster):      " << any_free << " µs" << std::endl;
+    std::cout << "📊 nextFree x3 (one stylist):   " << next_one << " µs" << std::endl;
+    std::cout << "📊 nextFree x3 (any stylist):   " << next_any << " µs" << std::endl;
+    std::cout << "📊 linear scan of appointments: " << scan << " µs" << std::endl;
+    if (sink == 0) std::cout << std::endl;  // Keeps the loops alive
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/availability_benchmark.cpp models/availability_index.cpp models/time_slots.cpp -o availability_benchmark
+
+USAGE:
+======
+./availability_benchmark
+./availability_benchmark 50 2000
+*/
@@ -0,0 +1,396 @@
+#include "../models/classifier.h"
+#include "../models/extractor.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Offline bulk transcript processing.
+//
+// Replays archived conversations through the classification/extraction
+// crews without going through /update_session. Input files are JSONL, one
+// conversation per line:
+//   {"conversation_id": "c-1", "turns": ["Hi I'm John", "Friday at 2 PM"]}
+//   {"conversation_id": "c-2", "turns": [{"speaker": "customer", "text": "..."}]}
+//
+// Files are mmap'ed and indexed by line. Worker threads claim batches of
+// conversations and replay them turn by turn: turn t of every conversation
+// in the batch goes through one batched forward pass per model. Turns
+// within a conversation stay in order, conversations run in parallel.
+//
+// Output is one TSV line per conversation:
+//   conversation_id  turns  caller_name  phone_number  day_preference  time_preference  service_type  failed_turns
+// failed_turns lists (comma separated, 0-based) the turns a model run failed
+// on; their entities may be missing, so they are worth re-running.
+
+static const std::vector<std::string> kEntityTypes = {
+    "caller_name", "phone_number", "day_preference",
+    "time_preference", "service_type"
+};
+
+// Read-only mapping of one input file
+class MappedFile {
+private:
+    int fd = -1;
+    const char* data = nullptr;
+    size_t size = 0;
+
+public:
+    explicit MappedFile(const std::string& path) {
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open transcript file: " + path);
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot stat transcript file: " + path);
+        }
+
+        size = static_cast<size_t>(st.st_size);
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot mmap transcript file: " + path);
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapped);
+        }
+    }
+
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Split into non-empty lines without copying
+    void indexLines(std::vector<std::string_view>& lines) const {
+        size_t start = 0;
+        while (start < size) {
+            const void* newline = std::memchr(data + start, '\n', size - start);
+            size_t end = newline ? static_cast<const char*>(newline) - data : size;
+            if (end > start) {
+                lines.emplace_back(data + start, end - start);
+            }
+            start = end + 1;
+        }
+    }
+};
+
+// One conversation being replayed
+struct Conversation {
+    std::string id;
+    std::vector<std::string> turns;
+    std::unordered_map<std::string, std::string> entities;
+    std::vector<size_t> failed_turns;
+    bool valid = false;
+};
+
+static Conversation parseConversation(std::string_view line) {
+    Conversation conversation;
+
+    try {
+        json record = json::parse(line.begin(), line.end());
+        conversation.id = record.value("conversation_id", std::string());
+
+        for (const auto& turn : record.at("turns")) {
+            if (turn.is_string()) {
+                conversation.turns.push_back(turn.get<std::string>());
+            } else if (turn.is_object()) {
+                // Only customer turns carry entities
+                std::string speaker = turn.value("speaker", std::string("customer"));
+                if (speaker == "customer" || speaker == "caller" || speaker == "user") {
+                    conversation.turns.push_back(turn.value("text", std::string()));
+                }
+            }
+        }
+        conversation.valid = true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "⚠️ Skipping malformed conversation: " << e.what() << std::endl;
+    }
+
+    return conversation;
+}
+
+static void appendTSVField(std::string& out, const std::string& value) {
+    out.push_back('\t');
+    for (char c : value) {
+        out.push_back((c == '\t' || c == '\n' || c == '\r') ? ' ' : c);
+    }
+}
+
+class BatchProcessor {
+private:
+    ClassificationCrew& classifier;
+    ExtractionCrew& extractor;
+    const std::vector<std::string_view>& lines;
+    FILE* output;
+    size_t batch_size;
+
+    std::atomic<size_t> next_line{0};
+    std::atomic<size_t> turns_processed{0};
+    std::atomic<size_t> conversations_processed{0};
+    std::atomic<size_t> turns_failed{0};
+    std::mutex output_mutex;
+
+public:
+    BatchProcessor(ClassificationCrew& classifier, ExtractionCrew& extractor,
+                   const std::vector<std::string_view>& lines, FILE* output, size_t batch_size)
+        : classifier(classifier), extractor(extractor), lines(lines),
+          output(output), batch_size(batch_size) {}
+
+    size_t getTurnsProcessed() const { return turns_processed.load(); }
+    size_t getConversationsProcessed() const { return conversations_processed.load(); }
+    size_t getTurnsFailed() const { return turns_failed.load(); }
+
+    void run(int num_threads) {
+        std::vector<std::thread> workers;
+        for (int i = 0; i < num_threads; ++i) {
+            workers.emplace_back(&BatchProcessor::workerLoop, this);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+private:
+    void workerLoop() {
+        std::string buffer;
+        buffer.reserve(1 << 20);
+
+        while (true) {
+            size_t begin = next_line.fetch_add(batch_size);
+            if (begin >= lines.size()) break;
+            size_t end = std::min(begin + batch_size, lines.size());
+
+            std::vector<Conversation> batch;
+            batch.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                Conversation conversation = parseConversation(lines[i]);
+                if (conversation.valid) {
+                    batch.push_back(std::move(conversation));
+                }
+            }
+
+            replayBatch(batch);
+
+            for (const auto& conversation : batch) {
+                buffer += conversation.id;
+                appendTSVField(buffer, std::to_string(conversation.turns.size()));
+                for (const auto& entity : kEntityTypes) {
+                    auto it = conversation.entities.find(entity);
+                    appendTSVField(buffer, it != conversation.entities.end() ? it->second : "");
+                }
+                std::string failed_turns;
+                for (size_t turn : conversation.failed_turns) {
+                    if (!failed_turns.empty()) failed_turns.push_back(',');
+                    failed_turns += std::to_string(turn);
+                }
+                appendTSVField(buffer, failed_turns);
+                buffer.push_back('\n');
+            }
+            conversations_processed += batch.size();
+
+            if (buffer.size() >= (1 << 20)) {
+                flush(buffer);
+            }
+        }
+
+        flush(buffer);
+    }
+
+    void flush(std::string& buffer) {
+        if (buffer.empty()) return;
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::fwrite(buffer.data(), 1, buffer.size(), output);
+        buffer.clear();
+    }
+
+    // Replay turn t of every conversation together, in turn order
+    void replayBatch(std::vector<Conversation>& batch) {
+        size_t max_turns = 0;
+        for (const auto& conversation : batch) {
+            max_turns = std::max(max_turns, conversation.turns.size());
+        }
+
+        for (size_t turn = 0; turn < max_turns; ++turn) {
+            std::vector<Conversation*> active;
+            std::vector<std::string> sentences;
+            for (auto& conversation : batch) {
+                if (turn < conversation.turns.size()) {
+                    active.push_back(&conversation);
+                    sentences.push_back(conversation.turns[turn]);
+                }
+            }
+
+            auto classification_results = classifier.classifyBatch(sentences);
+
+            // Same rule as SessionController::update_session: only extract
+            // entities that were detected and are still missing
+            std::vector<size_t> targets;
+            std::vector<std::string> target_sentences;
+            std::vector<std::vector<std::string>> target_entities;
+            
+            std::vector<bool> failed(active.size(), false);
+            for (size_t i = 0; i < active.size(); ++i) {
+                std::vector<std::string> entities;
+                for (const auto& result : classification_results[i]) {
+                    if (result.failed) failed[i] = true;
+                    if (result.detected && active[i]->entities.count(result.entity_name) == 0) {
+                        entities.push_back(result.entity_name);
+                    }
+                }
+                if (!entities.empty()) {
+                    targets.push_back(i);
+                    target_sentences.push_back(sentences[i]);
+                    target_entities.push_back(std::move(entities));
+                }
+            }
+            
+            // One pass for the joint model, one per entity model otherwise
+            if (!targets.empty()) {
+                auto extraction_results = extractor.extractEntitiesBatch(target_sentences, target_entities);
+                for (size_t k = 0; k < targets.size(); ++k) {
+                    for (const auto& extracted : extraction_results[k]) {
+                        if (extracted.failed) failed[targets[k]] = true;
+                        if (extracted.found && !extracted.extracted_value.empty()) {
+                            active[targets[k]]->entities[extracted.entity_name] = extracted.extracted_value;
+                        }
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < active.size(); ++i) {
+                if (failed[i]) {
+                    active[i]->failed_turns.push_back(turn);
+                    turns_failed++;
+                }
+            }
+            turns_processed += active.size();
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <svm_models_dir> <ner_models_dir> <output.tsv> <transcripts.jsonl>... "
+                  << "[--threads N] [--batch N] [--threshold T] [--ner-threshold T]" << std::endl;
+        return 1;
+    }
+
+    std::string svm_dir = argv[1];
+    std::string ner_dir = argv[2];
+    std::string output_path = argv[3];
+    std::vector<std::string> input_paths;
+    int num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    size_t batch_size = 32;
+    float threshold = 0.5f;      // SVM presence
+    float ner_threshold = 0.5f;  // NER span confidence
+
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            num_threads = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch_size = static_cast<size_t>(std::max(1, std::stoi(argv[++i])));
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = std::stof(argv[++i]);
+        } else if (arg == "--ner-threshold" && i + 1 < argc) {
+            ner_threshold = std::stof(argv[++i]);
+        } else {
+            input_paths.push_back(arg);
+        }
+    }
+
+    try {
+        ClassificationCrew classifier(svm_dir, threshold);
+        ExtractionCrew extractor(ner_dir, ner_threshold);
+
+        // Map every input and index conversations by line
+        std::vector<std::unique_ptr<MappedFile>> files;
+        std::vector<std::string_view> lines;
+        for (const auto& path : input_paths) {
+            files.push_back(std::make_unique<MappedFile>(path));
+            files.back()->indexLines(lines);
+        }
+
+        FILE* output = std::fopen(output_path.c_str(), "w");
+        if (!output) {
+            throw std::runtime_error("Cannot open output file: " + output_path);
+        }
+
+        std::cout << "🚀 Replaying " << lines.size() << " conversations from " << input_paths.size()
+                  << " file(s) on " << num_threads << " threads (batch " << batch_size << ")" << std::endl;
+
+        BatchProcessor processor(classifier, extractor, lines, output, batch_size);
+        auto start_time = std::chrono::steady_clock::now();
+
+        std::atomic<bool> done{false};
+        std::thread progress([&]() {
+            while (!done) {
+                std::this_thread::sleep_for(std::chrono::seconds(5));
+                if (done) break;
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+                std::cout << "  ⏱️ " << processor.getConversationsProcessed() << "/" << lines.size()
+                          << " conversations, " << std::fixed << std::setprecision(0)
+                          << processor.getTurnsProcessed() / elapsed << " turns/s" << std::endl;
+            }
+        });
+
+        processor.run(num_threads);
+        done = true;
+        progress.join();
+        std::fclose(output);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << "\n📊 Batch Results:" << std::endl;
+        std::cout << "  Conversations: " << processor.getConversationsProcessed() << std::endl;
+        std::cout << "  Turns: " << processor.getTurnsProcessed() << std::endl;
+        if (processor.getTurnsFailed() > 0) {
+            std::cout << "  ⚠️ Failed turns: " << processor.getTurnsFailed() << " (see the failed_turns column)" << std::endl;
+        }
+        std::cout << "  Elapsed: " << std::fixed << std::setprecision(2) << elapsed << "s" << std::endl;
+        std::cout << "  Throughput: " << std::setprecision(1)
+                  << (elapsed > 0 ? processor.getTurnsProcessed() / elapsed : 0.0) << " turns/s" << std::endl;
+        std::cout << "  Output: " << output_path << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/batch_processor.cpp models/classifier.cpp models/lexical_prefilter.cpp models/text_normalizer.cpp models/ort_runtime.cpp models/busy_poll.cpp models/extractor.cpp \
+    -I/opt/homebrew/Cellar/onnxruntime/1.22.1/include \
+    -L/opt/homebrew/Cellar/onnxruntime/1.22.1/lib \
+    -lonnxruntime \
+    -pthread \
+    -o batch_processor
+
+USAGE:
+======
+./batch_processor ./models/svm ./models/ner results.tsv archive/calls-2024.jsonl archive/calls-2025.jsonl --threads 16 --batch 64
+*/
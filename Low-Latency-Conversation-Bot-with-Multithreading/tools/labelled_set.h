@@ -0,0 +1,54 @@
+#ifndef LABELLED_SET_H
+#define LABELLED_SET_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+// One labelled utterance. Entities not listed are absent from the sentence.
+//   {"text": "Hi I'm John", "entities": {"caller_name": "John"}}
+struct LabelledUtterance {
+    std::string text;
+    std::unordered_map<std::string, std::string> entities;
+    
+    bool hasEntity(const std::string& entity_type) const {
+        return entities.count(entity_type) > 0;
+    }
+};
+
+// Load a JSONL labelled set, skipping malformed lines
+inline std::vector<LabelledUtterance> loadLabelledSet(const std::string& path) {
+    std::vector<LabelledUtterance> utterances;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open labelled set: " + path);
+    }
+    
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.empty()) continue;
+        
+        try {
+            json record = json::parse(line);
+            LabelledUtterance utterance;
+            utterance.text = record.at("text").get<std::string>();
+            if (record.contains("entities")) {
+                utterance.entities = record["entities"].get<std::unordered_map<std::string, std::string>>();
+            }
+            utterances.push_back(std::move(utterance));
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️ Skipping line " << line_number << " of " << path << ": " << e.what() << std::endl;
+        }
+    }
+    
+    return utterances;
+}
+
+#endif // LABELLED_SET_H
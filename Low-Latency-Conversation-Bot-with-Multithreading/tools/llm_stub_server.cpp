@@ -0,0 +1,219 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Stand-in completion endpoint for exercising HttpLLMClient.
+//
+// Accepts HTTP/1.1 keep-alive connections (one thread per connection) and
+// answers every POST with {"text": "..."} after an optional simulated
+// generation delay. Like a backend with a prompt cache, it keeps the first
+// prefix_length bytes of the last prompt of each prefix_id and charges a
+// "prefill" delay only for the bytes past what it already had. GET /stats
+// reports the counters. Prints how many requests each connection carried
+// when it closes, which shows whether the client is actually reusing its pool.
+
+static std::atomic<uint64_t> total_requests{0};
+static std::atomic<uint64_t> total_connections{0};
+
+// Prompt cache model, shared by all connections
+static std::mutex cache_mutex;
+static std::unordered_map<uint64_t, std::string> cached_prefixes;  // prefix_id -> prefix bytes
+static uint64_t prompt_bytes = 0;  // Guarded by cache_mutex
+static uint64_t cached_bytes = 0;  // Prompt bytes served from cached prefixes
+static constexpr size_t kMaxCachedPrefixes = 4096;
+
+// Bytes of `prompt` already cached; the prompt's prefix replaces the cached one
+static size_t cachePrompt(uint64_t prefix_id, const std::string& prompt, size_t prefix_length) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (cached_prefixes.size() >= kMaxCachedPrefixes && !cached_prefixes.count(prefix_id)) {
+        cached_prefixes.clear();  // Crude eviction; a stub only needs to stay bounded
+    }
+    std::string& kept = cached_prefixes[prefix_id];
+    size_t cached = 0;
+    while (cached < kept.size() && cached < prompt.size() && kept[cached] == prompt[cached]) cached++;
+    kept.assign(prompt, 0, std::min(prefix_length, prompt.size()));
+
+    prompt_bytes += prompt.size();
+    cached_bytes += cached;
+    return cached;
+}
+
+static json statsJson() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return {{"requests", total_requests.load()}, {"prompt_bytes", prompt_bytes},
+            {"cached_bytes", cached_bytes}, {"prefixes", cached_prefixes.size()}};
+}
+
+static bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static std::string replyFor(const json& request) {
+    std::string prompt = request.value("prompt", "");
+    if (prompt.size() >= 6 && prompt.compare(prompt.size() - 6, 6, "Score:") == 0) {
+        return prompt.find('?') != std::string::npos ? "0.85" : "0.4";  // Quality rating
+    }
+    // PromptBuilder ends closing prompts with "Closing:" and questions with "Question:"
+    if (prompt.size() >= 8 && prompt.compare(prompt.size() - 8, 8, "Closing:") == 0) {
+        return "Thanks, you're all booked. See you soon!";
+    }
+    return "Could you tell me a bit more so I can finish your booking?";
+}
+
+static void serveConnection(int fd, int delay_ms, int prefill_ms) {
+    uint64_t served = 0;
+    std::string buffer;
+    char chunk[4096];
+
+    while (true) {
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) goto done;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+
+        {
+            std::string headers = buffer.substr(0, header_end);
+            std::transform(headers.begin(), headers.end(), headers.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+            size_t content_length = 0;
+            size_t pos = headers.find("content-length:");
+            if (pos != std::string::npos) {
+                content_length = std::strtoul(headers.c_str() + pos + 15, nullptr, 10);
+            }
+            bool close_after = headers.find("connection: close") != std::string::npos;
+
+            while (buffer.size() < header_end + 4 + content_length) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) goto done;
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            std::string body = buffer.substr(header_end + 4, content_length);
+            bool get_stats = buffer.compare(0, 11, "GET /stats ") == 0;
+            buffer.erase(0, header_end + 4 + content_length);
+
+            int status = 200;
+            json reply;
+            if (get_stats) {
+                reply = statsJson();
+            } else {
+                try {
+                    json request = json::parse(body);
+
+                    std::string prompt = request.value("prompt", "");
+                    size_t cached = cachePrompt(request.value("prefix_id", uint64_t{0}), prompt,
+                                                request.value("prefix_length", size_t{0}));
+
+                    // prefill_ms per KB the cache did not cover
+                    long wait_us = delay_ms * 1000L + static_cast<long>(prefill_ms) * 1000L *
+                                   static_cast<long>(prompt.size() - cached) / 1024;
+                    if (wait_us > 0) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+                    }
+                    reply = {{"text", replyFor(request)}};
+                    total_requests++;  // Before the reply, so a client reading /stats next sees it
+                } catch (const std::exception& e) {
+                    status = 400;
+                    reply = {{"error", e.what()}};
+                }
+            }
+
+            std::string payload = reply.dump();
+            std::string response = "HTTP/1.1 " + std::to_string(status) + (status == 200 ? " OK" : " Bad Request") +
+                                   "\r\nContent-Type: application/json\r\nContent-Length: " +
+                                   std::to_string(payload.size()) +
+                                   (close_after ? "\r\nConnection: close" : "\r\nConnection: keep-alive") +
+                                   "\r\n\r\n" + payload;
+            if (!sendAll(fd, response)) goto done;
+
+            served++;
+            if (close_after) goto done;
+        }
+    }
+
+done:
+    ::close(fd);
+    std::cout << "🔌 Connection closed after " << served << " requests (" << total_requests.load()
+              << " total over " << total_connections.load() << " connections)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 8080;
+    int delay_ms = argc > 2 ? std::atoi(argv[2]) : 0;
+    int prefill_ms = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::cerr << "❌ socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 128) < 0) {
+        std::cerr << "❌ Cannot listen on 127.0.0.1:" << port << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::cout << "🤖 LLM stub listening on http://127.0.0.1:" << port << "/v1/completions"
+              << " (delay " << delay_ms << "ms, prefill " << prefill_ms << "ms per uncached KB)" << std::endl;
+
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "⚠️ accept: " << std::strerror(errno) << std::endl;
+            continue;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        total_connections++;
+        std::thread(serveConnection, fd, delay_ms, prefill_ms).detach();
+    }
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/llm_stub_server.cpp -pthread -o llm_stub_server
+
+USAGE:
+======
+./llm_stub_server 8080 40 250          # port, per-request delay ms, prefill ms per uncached KB
+curl -s http://127.0.0.1:8080/stats    # {"requests", "prompt_bytes", "cached_bytes", "prefixes"}
+LLM_ENDPOINT=http://127.0.0.1:8080/v1/completions ./advanced_controller
+*/
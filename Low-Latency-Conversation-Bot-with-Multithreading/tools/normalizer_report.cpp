@@ -0,0 +1,124 @@
+#include "../models/text_normalizer.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+// Throughput of the shared utterance normalizer against the old
+// std::transform(::tolower) + istringstream split, or the tokens of each
+// stdin line for diffing against the training pipeline:
+//
+//   ./normalizer_report
+//   ./normalizer_report --tokens [--split-punctuation] < utterances.txt
+
+static const char* kUtterances[] = {
+    "Hi, my name is Maria Gonzalez and I'd like to book a balayage",
+    "Could I come in on Friday afternoon, around 3?",
+    "MY NUMBER IS 07700 900123",
+    "José here — is Sam free next Tuesday morning?",
+    "Can you do a cut and colour for ZOË on the 14th?",
+    "email me at maria.gonzalez@example.com please",
+    "ok thanks   see you then",
+    "ΟΔΥΣΣΕΑΣ wants a beard trim"
+};
+
+template <typename Fn>
+static double gigabytesPerSecond(const std::vector<std::string>& inputs, size_t total_bytes, Fn&& fn) {
+    size_t rounds = std::max<size_t>(1, (256u << 20) / total_bytes);  // ~256 MB per measurement
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; round++) {
+        for (const auto& input : inputs) fn(input);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return rounds * total_bytes / seconds / 1e9;
+}
+
+static void report() {
+    size_t sink = 0;
+
+    auto legacy = [&](const std::string& text) {
+        std::string lower = text;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        std::istringstream iss(lower);
+        std::string word;
+        while (iss >> word) sink += word.size();
+    };
+
+    NormalizerOptions options;
+    NormalizedText normalized;
+    auto tokens = [&](const std::string& text) {
+        TextNormalizer::normalize(text, options, normalized);
+        sink += normalized.tokens.size();
+    };
+    std::string key;
+    auto text_only = [&](const std::string& text) {
+        TextNormalizer::normalizeText(text, options, key);
+        sink += key.size();
+    };
+
+    // Short turns as they arrive, and one long transcript (bulk processing)
+    std::vector<std::string> turns(std::begin(kUtterances), std::end(kUtterances));
+    size_t turn_bytes = 0;
+    for (const auto& turn : turns) turn_bytes += turn.size();
+
+    // Mixed-script turns take the scalar path for every block they touch
+    std::vector<std::string> transcript(1);
+    std::vector<std::string> ascii_transcript(1);
+    while (transcript[0].size() < (1u << 20)) {
+        for (const auto& turn : turns) {
+            transcript[0] += turn + "\n";
+            bool ascii = std::all_of(turn.begin(), turn.end(), [](char c) { return (c & 0x80) == 0; });
+            if (ascii) ascii_transcript[0] += turn + "\n";
+        }
+    }
+
+    std::cout << "🔤 Kernel: " << TextNormalizer::kernelName() << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    auto measure = [&](const char* label, const std::vector<std::string>& inputs, size_t bytes) {
+        std::cout << "📊 " << label << ": tolower+istringstream " << gigabytesPerSecond(inputs, bytes, legacy)
+                  << " GB/s, normalize " << gigabytesPerSecond(inputs, bytes, tokens)
+                  << " GB/s, normalizeText " << gigabytesPerSecond(inputs, bytes, text_only) << " GB/s" << std::endl;
+    };
+    measure("turns", turns, turn_bytes);
+    measure("1 MB transcript", transcript, transcript[0].size());
+    measure("ASCII-only transcript", ascii_transcript, ascii_transcript[0].size());
+    if (sink == 0) std::cout << std::endl;  // Keeps the loops alive
+}
+
+int main(int argc, char** argv) {
+    bool print_tokens = false;
+    NormalizerOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tokens") == 0) print_tokens = true;
+        else if (std::strcmp(argv[i], "--split-punctuation") == 0) options.split_punctuation = true;
+        else if (std::strcmp(argv[i], "--keep-case") == 0) options.fold_case = false;
+    }
+
+    if (!print_tokens) {
+        report();
+        return 0;
+    }
+
+    // One line of space-joined tokens per input line, like ' '.join(line.lower().split())
+    std::string line;
+    NormalizedText normalized;
+    while (std::getline(std::cin, line)) {
+        TextNormalizer::normalize(line, options, normalized);
+        std::cout << normalized.text << "\n";
+    }
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/normalizer_report.cpp models/text_normalizer.cpp -o normalizer_report
+
+USAGE:
+======
+./normalizer_report
+./normalizer_report --tokens < data/utterances.txt | diff - <(python3 -c "import sys; [print(' '.join(l.lower().split())) for l in sys.stdin]" < data/utterances.txt)
+*/
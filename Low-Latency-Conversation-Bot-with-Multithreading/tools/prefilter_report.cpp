@@ -0,0 +1,138 @@
+#include "../models/lexical_prefilter.h"
+#include "labelled_set.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+// Runs a labelled utterance set through the lexical pre-filter alone (no
+// models needed) and reports, per entity, how often the SVM head would be
+// skipped and how many labelled positives a skip would have lost.
+//
+//   ./prefilter_report ./data/labelled.jsonl [--disable <entity>]...
+
+static const std::vector<std::string> kEntityTypes = {
+    "caller_name", "phone_number", "day_preference",
+    "time_preference", "service_type"
+};
+
+struct EntityReport {
+    size_t positives = 0;
+    size_t skipped = 0;
+    size_t skipped_positives = 0;  // Recall loss: head skipped but entity present
+    std::vector<std::string> lost_examples;
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <labelled.jsonl> [--disable <entity>]..." << std::endl;
+        return 1;
+    }
+
+    LexicalPrefilter prefilter;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--disable" && i + 1 < argc) {
+            std::string entity = argv[++i];
+            if (!prefilter.setGateEnabled(entity, false)) {
+                std::cerr << "⚠️ Unknown entity: " << entity << std::endl;
+            }
+        }
+    }
+
+    try {
+        auto utterances = loadLabelledSet(argv[1]);
+        std::cout << "🔎 Pre-filter report over " << utterances.size() << " labelled utterances" << std::endl;
+
+        std::unordered_map<std::string, EntityReport> reports;
+        size_t heads_invoked = 0;
+        size_t turns_under_half = 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (const auto& utterance : utterances) {
+            LexicalFeatures features = LexicalPrefilter::scan(utterance.text);
+            size_t invoked = 0;
+
+            for (const auto& entity : kEntityTypes) {
+                EntityReport& report = reports[entity];
+                bool positive = utterance.hasEntity(entity);
+                if (positive) report.positives++;
+
+                if (prefilter.admit(features, entity)) {
+                    invoked++;
+                    continue;
+                }
+
+                report.skipped++;
+                if (positive) {
+                    report.skipped_positives++;
+                    if (report.lost_examples.size() < 3) {
+                        report.lost_examples.push_back(utterance.text);
+                    }
+                }
+            }
+
+            heads_invoked += invoked;
+            if (invoked * 2 < kEntityTypes.size()) {
+                turns_under_half++;
+            }
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        double scan_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+        std::cout << "\n" << std::left << std::setw(18) << "  entity"
+                  << std::right << std::setw(8) << "gate" << std::setw(11) << "skip rate"
+                  << std::setw(11) << "positives" << std::setw(13) << "recall loss" << std::endl;
+
+        for (const auto& entity : kEntityTypes) {
+            const EntityReport& report = reports[entity];
+            float skip_rate = utterances.empty() ? 0.0f : static_cast<float>(report.skipped) / utterances.size();
+            float recall_loss = report.positives == 0 ? 0.0f :
+                static_cast<float>(report.skipped_positives) / report.positives;
+
+            std::cout << std::left << std::setw(18) << ("  " + entity)
+                      << std::right << std::setw(8) << (prefilter.getGate(entity).enabled ? "on" : "off")
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(10) << skip_rate * 100.0f << "%"
+                      << std::setw(11) << report.positives
+                      << std::setw(12) << recall_loss * 100.0f << "%";
+            if (report.skipped_positives > 0) {
+                std::cout << "  ⚠️ " << report.skipped_positives << " lost";
+            }
+            std::cout << std::endl;
+
+            for (const auto& example : report.lost_examples) {
+                std::cout << "      missed: \"" << example << "\"" << std::endl;
+            }
+        }
+
+        if (!utterances.empty()) {
+            std::cout << "\n📊 Cascade Summary:" << std::endl;
+            std::cout << "  Avg SVM heads per turn: " << std::setprecision(2)
+                      << static_cast<double>(heads_invoked) / utterances.size()
+                      << " of " << kEntityTypes.size() << std::endl;
+            std::cout << "  Turns under half the heads: " << std::setprecision(1)
+                      << 100.0 * turns_under_half / utterances.size() << "%" << std::endl;
+            std::cout << "  Scan cost: " << std::setprecision(2)
+                      << scan_us / utterances.size() << "us per turn" << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/prefilter_report.cpp models/lexical_prefilter.cpp -o prefilter_report
+
+USAGE:
+======
+./prefilter_report ./data/labelled.jsonl
+./prefilter_report ./data/labelled.jsonl --disable time_preference
+*/
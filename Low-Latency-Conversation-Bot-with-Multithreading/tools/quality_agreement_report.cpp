@@ -0,0 +1,231 @@
+#include "../models/question_scorer.h"
+#include "../models/composer.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+// Compares the local question-quality scorer with LLM scores on a recorded
+// set and, optionally, fits the scorer's weights to those scores.
+//
+// Records are what ComposerCrew writes with QUALITY_ASSESSOR=shadow:
+//   {"question": "...", "missing_entities": ["caller_name"], "known_entities": {...}, "llm_score": 0.82}
+//
+//   ./quality_agreement_report quality_recording.jsonl [--threshold 0.7] [--weights w.json] [--fit out.json]
+
+struct RecordedScore {
+    std::string question;
+    CompositionRequest request;
+    float llm_score = 0.0f;
+};
+
+struct Agreement {
+    size_t both_accept = 0;
+    size_t both_reject = 0;
+    size_t llm_only = 0;    // LLM accepts, local rejects: needless template fallbacks
+    size_t local_only = 0;  // Local accepts, LLM rejects: questions the LLM would retry
+    double mae = 0.0;
+    double pearson = 0.0;
+    double avg_micros = 0.0;
+
+    double rate() const {
+        size_t total = both_accept + both_reject + llm_only + local_only;
+        return total == 0 ? 0.0 : 100.0 * (both_accept + both_reject) / total;
+    }
+};
+
+static std::vector<RecordedScore> loadRecording(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open recording: " + path);
+    }
+
+    std::vector<RecordedScore> records;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        if (line.empty()) continue;
+
+        try {
+            json entry = json::parse(line);
+            RecordedScore record;
+            record.question = entry.at("question").get<std::string>();
+            record.llm_score = entry.at("llm_score").get<float>();
+            record.request.missing_entities = entry.value("missing_entities", std::vector<std::string>{});
+            record.request.known_entities =
+                entry.value("known_entities", std::unordered_map<std::string, std::string>{});
+            records.push_back(std::move(record));
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️ Skipping line " << line_number << " of " << path << ": " << e.what() << std::endl;
+        }
+    }
+    return records;
+}
+
+static Agreement measure(QuestionQualityScorer& scorer, const std::vector<RecordedScore>& records, float threshold,
+                         std::vector<std::pair<float, size_t>>* worst) {
+    Agreement agreement;
+    std::vector<float> local(records.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < records.size(); ++i) {
+        local[i] = scorer.score(records[i].question, records[i].request);
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    agreement.avg_micros = records.empty() ? 0.0 : micros / records.size();
+
+    double sum_l = 0, sum_m = 0, sum_ll = 0, sum_mm = 0, sum_lm = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        double l = records[i].llm_score;
+        double m = local[i];
+        bool llm_accepts = l >= threshold;
+        bool local_accepts = m >= threshold;
+
+        if (llm_accepts && local_accepts) agreement.both_accept++;
+        else if (!llm_accepts && !local_accepts) agreement.both_reject++;
+        else if (llm_accepts) agreement.llm_only++;
+        else agreement.local_only++;
+
+        agreement.mae += std::fabs(l - m);
+        sum_l += l; sum_m += m;
+        sum_ll += l * l; sum_mm += m * m; sum_lm += l * m;
+        if (worst) worst->push_back({static_cast<float>(std::fabs(l - m)), i});
+    }
+
+    double n = static_cast<double>(records.size());
+    if (n > 0) {
+        agreement.mae /= n;
+        double cov = sum_lm - sum_l * sum_m / n;
+        double var_l = sum_ll - sum_l * sum_l / n;
+        double var_m = sum_mm - sum_m * sum_m / n;
+        if (var_l > 0 && var_m > 0) agreement.pearson = cov / std::sqrt(var_l * var_m);
+    }
+    return agreement;
+}
+
+static void printAgreement(const char* label, const Agreement& agreement) {
+    std::cout << "\n📊 " << label << std::endl;
+    std::cout << "  Decision agreement: " << std::fixed << std::setprecision(1) << agreement.rate() << "%" << std::endl;
+    std::cout << "    both accept " << agreement.both_accept << ", both reject " << agreement.both_reject
+              << ", LLM-only accept " << agreement.llm_only << ", local-only accept " << agreement.local_only << std::endl;
+    std::cout << "  Score MAE: " << std::setprecision(3) << agreement.mae
+              << ", Pearson r: " << agreement.pearson << std::endl;
+    std::cout << "  Local scoring: " << std::setprecision(2) << agreement.avg_micros << " µs/question" << std::endl;
+}
+
+// Logistic regression on the LLM scores as soft labels (cross-entropy, batch gradient descent)
+static QualityScorerWeights fitWeights(QuestionQualityScorer& scorer, const std::vector<RecordedScore>& records) {
+    std::vector<QualityFeatures> features;
+    features.reserve(records.size());
+    for (const auto& record : records) {
+        features.push_back(scorer.extractFeatures(record.question, record.request));
+    }
+
+    QualityScorerWeights fitted = scorer.getWeights();
+    const double learning_rate = 0.5;
+    const double l2 = 1e-3;
+    const double n = static_cast<double>(records.size());
+
+    for (int epoch = 0; epoch < 3000; ++epoch) {
+        double grad_bias = 0.0;
+        std::array<double, QF_COUNT> grad{};
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            double z = fitted.bias;
+            for (size_t f = 0; f < QF_COUNT; ++f) z += fitted.weights[f] * features[i][f];
+            double error = 1.0 / (1.0 + std::exp(-z)) - records[i].llm_score;
+            grad_bias += error;
+            for (size_t f = 0; f < QF_COUNT; ++f) grad[f] += error * features[i][f];
+        }
+
+        fitted.bias -= static_cast<float>(learning_rate * grad_bias / n);
+        for (size_t f = 0; f < QF_COUNT; ++f) {
+            fitted.weights[f] -= static_cast<float>(learning_rate * (grad[f] / n + l2 * fitted.weights[f]));
+        }
+    }
+    return fitted;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <recording.jsonl> [--threshold 0.7] [--weights w.json] [--fit out.json]" << std::endl;
+        return 1;
+    }
+
+    float threshold = 0.7f;  // ComposerCrew's default quality_threshold
+    std::string weights_path;
+    std::string fit_path;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc) threshold = std::stof(argv[++i]);
+        else if (arg == "--weights" && i + 1 < argc) weights_path = argv[++i];
+        else if (arg == "--fit" && i + 1 < argc) fit_path = argv[++i];
+    }
+
+    try {
+        auto records = loadRecording(argv[1]);
+        if (records.empty()) {
+            std::cerr << "❌ No usable records in " << argv[1] << std::endl;
+            return 1;
+        }
+        std::cout << "🔎 Quality agreement over " << records.size() << " recorded LLM scores (threshold "
+                  << threshold << ")" << std::endl;
+
+        QuestionQualityScorer scorer;
+        if (!weights_path.empty()) {
+            scorer.setWeights(QualityScorerWeights::fromFile(weights_path));
+        }
+
+        std::vector<std::pair<float, size_t>> worst;
+        printAgreement(weights_path.empty() ? "Default weights" : "Loaded weights",
+                       measure(scorer, records, threshold, &worst));
+
+        std::sort(worst.begin(), worst.end(), std::greater<>());
+        std::cout << "\n  Largest disagreements:" << std::endl;
+        for (size_t i = 0; i < std::min<size_t>(5, worst.size()); ++i) {
+            const auto& record = records[worst[i].second];
+            std::cout << "    LLM " << std::setprecision(2) << record.llm_score << " vs local "
+                      << scorer.scoreFeatures(scorer.extractFeatures(record.question, record.request))
+                      << ": \"" << record.question << "\"" << std::endl;
+        }
+
+        if (!fit_path.empty()) {
+            QualityScorerWeights fitted = fitWeights(scorer, records);
+            scorer.setWeights(fitted);
+            printAgreement("Fitted weights (in-sample)", measure(scorer, records, threshold, nullptr));
+
+            std::cout << "\n  bias " << std::setprecision(3) << fitted.bias << std::endl;
+            for (size_t f = 0; f < QF_COUNT; ++f) {
+                std::cout << "  " << std::left << std::setw(16) << QuestionQualityScorer::featureName(f)
+                          << std::right << fitted.weights[f] << std::endl;
+            }
+            fitted.save(fit_path);
+            std::cout << "💾 Wrote " << fit_path << " (use with QUALITY_WEIGHTS=" << fit_path << ")" << std::endl;
+        }
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 tools/quality_agreement_report.cpp models/question_scorer.cpp -pthread -o quality_agreement_report
+
+USAGE:
+======
+QUALITY_ASSESSOR=shadow QUALITY_RECORDING=quality_recording.jsonl ./advanced_controller
+./quality_agreement_report quality_recording.jsonl --fit quality_weights.json
+QUALITY_WEIGHTS=quality_weights.json ./advanced_controller
+*/
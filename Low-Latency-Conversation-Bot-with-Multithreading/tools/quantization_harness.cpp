@@ -0,0 +1,215 @@
+#include "../models/classifier.h"
+#include "../models/extractor.h"
+#include "labelled_set.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+
+// Runs a labelled utterance set through the FP32 and INT8 variants of every
+// SVM/NER model and reports per-entity accuracy deltas next to latency and
+// memory, so we can decide per entity whether the quantized model ships.
+
+static const std::vector<std::string> kEntityTypes = {
+    "caller_name", "phone_number", "day_preference",
+    "time_preference", "service_type"
+};
+
+static const std::vector<ModelPrecision> kPrecisions = {
+    ModelPrecision::FP32, ModelPrecision::INT8_DYNAMIC, ModelPrecision::INT8_STATIC
+};
+
+static std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+struct LatencyStats {
+    std::vector<double> samples_us;
+
+    void add(std::chrono::high_resolution_clock::duration d) {
+        samples_us.push_back(std::chrono::duration<double, std::micro>(d).count());
+    }
+
+    double percentile(double p) {
+        if (samples_us.empty()) return 0.0;
+        std::sort(samples_us.begin(), samples_us.end());
+        size_t index = static_cast<size_t>(p * (samples_us.size() - 1));
+        return samples_us[index];
+    }
+};
+
+struct VariantReport {
+    ModelPrecision precision = ModelPrecision::FP32;
+    bool available = false;
+    float classification_accuracy = 0.0f;
+    float extraction_accuracy = 0.0f;
+    double svm_p50_us = 0.0, svm_p99_us = 0.0;
+    double ner_p50_us = 0.0, ner_p99_us = 0.0;
+    double rss_delta_mb = 0.0;
+};
+
+static VariantReport evaluateVariant(const std::string& svm_dir, const std::string& ner_dir,
+                                     const std::string& entity, ModelPrecision precision,
+                                     const std::vector<LabelledUtterance>& utterances,
+                                     float threshold) {
+    VariantReport report;
+    report.precision = precision;
+
+    std::string svm_path = modelVariantPath(svm_dir, entity, "svm", precision);
+    std::string ner_path = modelVariantPath(ner_dir, entity, "ner", precision);
+    std::string metadata_path = ner_dir + "/" + entity + "_metadata.json";
+    if (!modelFileExists(svm_path) || !modelFileExists(ner_path)) {
+        return report;
+    }
+
+    size_t rss_before = processResidentBytes();
+    SVMModel svm(svm_path);
+    NERModel ner(ner_path, metadata_path);
+
+    // Warm up so arena growth is not attributed to the first timed call
+    if (!utterances.empty()) {
+        svm.predict(utterances[0].text);
+        ner.extract(utterances[0].text);
+    }
+
+    LatencyStats svm_latency, ner_latency;
+    int classification_correct = 0;
+    int extraction_total = 0, extraction_correct = 0;
+
+    for (const auto& utterance : utterances) {
+        bool expected = utterance.hasEntity(entity);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        float confidence = svm.predict(utterance.text);
+        svm_latency.add(std::chrono::high_resolution_clock::now() - start);
+
+        if ((confidence >= threshold) == expected) {
+            classification_correct++;
+        }
+
+        if (expected) {
+            start = std::chrono::high_resolution_clock::now();
+            std::string extracted = ner.extract(utterance.text);
+            ner_latency.add(std::chrono::high_resolution_clock::now() - start);
+
+            extraction_total++;
+            if (toLower(extracted) == toLower(utterance.entities.at(entity))) {
+                extraction_correct++;
+            }
+        }
+    }
+
+    size_t rss_after = processResidentBytes();
+
+    report.available = true;
+    report.classification_accuracy = utterances.empty() ? 0.0f :
+        static_cast<float>(classification_correct) / utterances.size();
+    report.extraction_accuracy = extraction_total == 0 ? 0.0f :
+        static_cast<float>(extraction_correct) / extraction_total;
+    report.svm_p50_us = svm_latency.percentile(0.50);
+    report.svm_p99_us = svm_latency.percentile(0.99);
+    report.ner_p50_us = ner_latency.percentile(0.50);
+    report.ner_p99_us = ner_latency.percentile(0.99);
+    report.rss_delta_mb = rss_after > rss_before ? (rss_after - rss_before) / (1024.0 * 1024.0) : 0.0;
+
+    return report;
+}
+
+static void printReport(const std::string& entity, const std::vector<VariantReport>& reports) {
+    const VariantReport& baseline = reports[0];
+
+    std::cout << "\n📦 " << entity << std::endl;
+    std::cout << std::left << std::setw(14) << "  variant"
+              << std::right << std::setw(10) << "cls acc" << std::setw(9) << "Δ"
+              << std::setw(10) << "ext acc" << std::setw(9) << "Δ"
+              << std::setw(11) << "svm p50" << std::setw(11) << "svm p99"
+              << std::setw(11) << "ner p50" << std::setw(11) << "ner p99"
+              << std::setw(10) << "RSS MB" << std::endl;
+
+    for (const auto& report : reports) {
+        std::cout << std::left << std::setw(14) << (std::string("  ") + modelPrecisionName(report.precision));
+        if (!report.available) {
+            std::cout << "  (not on disk)" << std::endl;
+            continue;
+        }
+
+        std::cout << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << report.classification_accuracy
+                  << std::setw(9) << std::showpos << (report.classification_accuracy - baseline.classification_accuracy) << std::noshowpos
+                  << std::setw(10) << report.extraction_accuracy
+                  << std::setw(9) << std::showpos << (report.extraction_accuracy - baseline.extraction_accuracy) << std::noshowpos
+                  << std::setprecision(1)
+                  << std::setw(9) << report.svm_p50_us << "us"
+                  << std::setw(9) << report.svm_p99_us << "us"
+                  << std::setw(9) << report.ner_p50_us << "us"
+                  << std::setw(9) << report.ner_p99_us << "us"
+                  << std::setw(10) << report.rss_delta_mb;
+
+        if (isQuantized(report.precision) && baseline.available && report.svm_p50_us > 0.0) {
+            std::cout << "  (svm " << std::setprecision(2) << baseline.svm_p50_us / report.svm_p50_us << "x";
+            if (report.ner_p50_us > 0.0) {
+                std::cout << ", ner " << baseline.ner_p50_us / report.ner_p50_us << "x";
+            }
+            std::cout << ")";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <svm_models_dir> <ner_models_dir> <labelled.jsonl> [threshold]" << std::endl;
+        return 1;
+    }
+
+    std::string svm_dir = argv[1];
+    std::string ner_dir = argv[2];
+    float threshold = argc > 4 ? std::stof(argv[4]) : 0.5f;
+
+    try {
+        auto utterances = loadLabelledSet(argv[3]);
+        std::cout << "🎯 Quantization comparison over " << utterances.size() << " labelled utterances" << std::endl;
+        std::cout << "   (RSS MB = resident growth while the variant was loaded and run)" << std::endl;
+
+        for (const auto& entity : kEntityTypes) {
+            std::vector<VariantReport> reports;
+            for (ModelPrecision precision : kPrecisions) {
+                try {
+                    reports.push_back(evaluateVariant(svm_dir, ner_dir, entity, precision, utterances, threshold));
+                } catch (const std::exception& e) {
+                    std::cerr << "❌ " << entity << " " << modelPrecisionName(precision) << ": " << e.what() << std::endl;
+                    VariantReport failed;
+                    failed.precision = precision;
+                    reports.push_back(failed);
+                }
+            }
+            printReport(entity, reports);
+        }
+
+        OrtRuntime::instance().printMemoryReport();
+
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 tools/quantization_harness.cpp models/classifier.cpp models/lexical_prefilter.cpp models/text_normalizer.cpp models/ort_runtime.cpp models/busy_poll.cpp models/extractor.cpp \
+    -I/opt/homebrew/Cellar/onnxruntime/1.22.1/include \
+    -L/opt/homebrew/Cellar/onnxruntime/1.22.1/lib \
+    -lonnxruntime \
+    -pthread \
+    -o quantization_harness
+
+USAGE:
+======
+./quantization_harness ./models/svm ./models/ner ./data/labelled.jsonl 0.5
+*/
@@ -0,0 +1,215 @@
+#include "../views/APIs/wire-format.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+// Compares the turn-wire encoding with the JSON bodies on a typical turn,
+// or drives a running WireServer:
+//
+//   ./turn_wire_report
+//   ./turn_wire_report --connect unix:/tmp/bot.sock [--turns 1000]
+
+static EntitiesModel sampleTurn() {
+    EntitiesModel model;
+    model.response = "Thanks Maria, I have you down for a balayage.";
+    model.question = "What day would suit you best?";
+    model.session_active = true;
+    model.entities.name = "Maria";
+    model.entities.phone = "07700 900123";
+    model.entities.service = "balayage";
+    model.entities.stylist = "Sam";
+    return model;
+}
+
+// Same shape as SessionApi::entities_model_to_json
+static std::string toJson(const EntitiesModel& model) {
+    return json{
+        {"response", model.response},
+        {"question", model.question},
+        {"session_active", model.session_active},
+        {"entities", {
+            {"name", model.entities.name}, {"phone", model.entities.phone}, {"email", model.entities.email},
+            {"service", model.entities.service}, {"day", model.entities.day}, {"time", model.entities.time},
+            {"stylist", model.entities.stylist}, {"notes", model.entities.notes}
+        }}
+    }.dump();
+}
+
+template <typename Fn>
+static double nanosPer(int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+static void report() {
+    EntitiesModel model = sampleTurn();
+    const int iterations = 200000;
+    size_t sink = 0;
+
+    std::string json_reply = toJson(model);
+    std::string wire_reply;
+    TurnWire::encode_entities(model, 200, wire_reply);
+
+    std::string sentence = "Could I come in on Friday afternoon, around 3?";
+    std::string json_request = json{{"sentence", sentence}}.dump();
+    std::string wire_request;
+    TurnWire::encode_dialogue_input(sentence, wire_request);
+
+    double json_encode = nanosPer(iterations, [&] { sink += toJson(model).size(); });
+    double wire_encode = nanosPer(iterations, [&] {
+        std::string out;
+        TurnWire::encode_entities(model, 200, out);
+        sink += out.size();
+    });
+    double json_decode = nanosPer(iterations, [&] {
+        json parsed = json::parse(json_reply);
+        sink += parsed["entities"]["name"].get_ref<const std::string&>().size();
+    });
+    double wire_decode = nanosPer(iterations, [&] {
+        WireEntities entities;
+        TurnWire::decode_entities(wire_reply, entities);
+        sink += entities.name.size();
+    });
+
+    std::cout << "📦 Turn reply (EntitiesModel)" << std::endl;
+    std::cout << "  JSON " << json_reply.size() << " bytes, turn-wire " << wire_reply.size() << " bytes ("
+              << std::fixed << std::setprecision(1) << double(json_reply.size()) / wire_reply.size() << "x smaller)"
+              << std::endl;
+    std::cout << "  encode: JSON " << json_encode << " ns, turn-wire " << wire_encode << " ns" << std::endl;
+    std::cout << "  decode: JSON " << json_decode << " ns, turn-wire " << wire_decode << " ns" << std::endl;
+    std::cout << "📦 Turn request (DialogueInput): JSON " << json_request.size() << " bytes, turn-wire "
+              << wire_request.size() << " bytes" << std::endl;
+    if (sink == 0) std::cout << std::endl;  // Keeps the loops alive
+}
+
+static int connectTo(const std::string& address) {
+    if (address.rfind("unix:", 0) == 0) {
+        sockaddr_un remote{};
+        remote.sun_family = AF_UNIX;
+        std::string path = address.substr(5);
+        std::strncpy(remote.sun_path, path.c_str(), sizeof(remote.sun_path) - 1);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == 0) return fd;
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+
+    size_t colon = address.rfind(':');
+    addrinfo hints{};
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (colon == std::string::npos ||
+        getaddrinfo(address.substr(0, colon).c_str(), address.substr(colon + 1).c_str(), &hints, &result) != 0) {
+        return -1;
+    }
+    int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd >= 0 && connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    return fd;
+}
+
+// Send one frame and read one whole reply frame
+static bool roundTrip(int fd, const std::string& frame, std::string& reply) {
+    if (send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(frame.size())) return false;
+
+    reply.clear();
+    char chunk[16 * 1024];
+    WireHeader header;
+    while (reply.size() < TurnWire::kHeaderBytes ||
+           (TurnWire::decode_header(reply, header) && reply.size() < TurnWire::kHeaderBytes + header.length)) {
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return false;
+        reply.append(chunk, static_cast<size_t>(received));
+    }
+    return TurnWire::decode_header(reply, header);
+}
+
+static int drive(const std::string& address, int turns) {
+    int fd = connectTo(address);
+    if (fd < 0) {
+        std::cerr << "❌ Cannot connect to " << address << std::endl;
+        return 1;
+    }
+
+    std::string session_id = "wire-report-" + std::to_string(getpid());
+    std::string frame;
+    std::string reply;
+    std::vector<double> micros;
+
+    auto call = [&](WireOp op, const std::string& text) {
+        frame.clear();
+        if (!TurnWire::encode_turn_request(op, session_id, text, frame)) return false;
+        auto start = std::chrono::steady_clock::now();
+        bool ok = roundTrip(fd, frame, reply);
+        micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        return ok;
+    };
+
+    if (!call(WireOp::CREATE_SESSION, "")) {
+        std::cerr << "❌ Connection closed" << std::endl;
+        close(fd);
+        return 1;
+    }
+    micros.clear();
+    for (int i = 0; i < turns; ++i) {
+        if (!call(WireOp::UPDATE_SESSION, "My name is Maria and I'd like a balayage")) break;
+    }
+
+    WireEntities entities;
+    WireStatusText error;
+    if (TurnWire::decode_entities(reply, entities)) {
+        std::cout << "💬 " << entities.status << " \"" << entities.response << "\" / \"" << entities.question << "\""
+                  << std::endl;
+    } else if (TurnWire::decode_status_text(reply, error)) {
+        std::cout << "⚠️ " << error.status << ": " << error.text << std::endl;
+    }
+    call(WireOp::END_SESSION, "");
+    close(fd);
+
+    micros.pop_back();
+    if (micros.empty()) return 1;
+    std::sort(micros.begin(), micros.end());
+    std::cout << "⏱️ " << micros.size() << " turns: p50 " << std::fixed << std::setprecision(1)
+              << micros[micros.size() / 2] << " µs, p99 " << micros[micros.size() * 99 / 100] << " µs" << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string address;
+    int turns = 1000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--connect" && i + 1 < argc) address = argv[++i];
+        else if (arg == "--turns" && i + 1 < argc) turns = std::max(1, std::atoi(argv[++i]));
+    }
+
+    if (!address.empty()) return drive(address, turns);
+    report();
+    return 0;
+}
+
+/*
+COMPILATION:
+============
+g++ -std=c++17 -O2 -Imodels tools/turn_wire_report.cpp views/APIs/wire-format.cpp -pthread -o turn_wire_report
+
+USAGE:
+======
+./turn_wire_report
+./turn_wire_report --connect unix:/tmp/bot.sock --turns 1000
+*/
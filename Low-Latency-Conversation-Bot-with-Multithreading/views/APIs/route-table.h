@@ -0,0 +1,155 @@
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+enum class HttpMethod : uint8_t { GET, POST, PUT, DELETE, OPTIONS, OTHER };
+constexpr size_t kHttpMethodCount = 6;
+
+inline HttpMethod parse_http_method(std::string_view method) {
+    if (method == "GET") return HttpMethod::GET;
+    if (method == "POST") return HttpMethod::POST;
+    if (method == "PUT") return HttpMethod::PUT;
+    if (method == "DELETE") return HttpMethod::DELETE;
+    if (method == "OPTIONS") return HttpMethod::OPTIONS;
+    return HttpMethod::OTHER;
+}
+
+// Path parameters of a matched route, in pattern order, as views into the request path
+struct RouteParams {
+    static constexpr size_t kMax = 4;
+    std::array<std::string_view, kMax> values{};
+    size_t count = 0;
+
+    std::string_view operator[](size_t index) const { return values[index]; }
+};
+
+// Static route table compiled into a segment trie once at startup. Pattern
+// segments are literals, `{name}` (one non-empty segment) or a trailing
+// `{name+}` (the non-empty rest of the path, slashes included, like the
+// `(.+)` regex routes it replaces). Matching walks one node per segment,
+// literal before parameter, with views into the path: no regex, no
+// allocation, and cost set by path depth rather than by the number of routes.
+template <typename Handler>
+class RouteTable {
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        std::vector<std::pair<std::string, uint32_t>> literals;  // Sorted by segment
+        uint32_t param = kNone;  // `{name}` child
+        uint32_t rest = kNone;   // `{name+}` child
+        std::array<Handler, kHttpMethodCount> handlers{};
+        uint8_t methods = 0;     // Bit per HttpMethod with a handler
+
+        bool handles(HttpMethod method) const { return methods & (1u << static_cast<unsigned>(method)); }
+    };
+
+    std::vector<Node> nodes{1};  // nodes[0] is "/"
+
+    uint32_t child(uint32_t parent, std::string_view segment, bool& last) {
+        if (segment.size() >= 2 && segment.front() == '{' && segment.back() == '}') {
+            bool rest = segment[segment.size() - 2] == '+';
+            uint32_t& slot = rest ? nodes[parent].rest : nodes[parent].param;
+            last = rest;
+            if (slot == kNone) {
+                slot = static_cast<uint32_t>(nodes.size());
+                nodes.emplace_back();
+            }
+            return slot;
+        }
+
+        auto& literals = nodes[parent].literals;
+        auto it = std::lower_bound(literals.begin(), literals.end(), segment,
+                                   [](const auto& entry, std::string_view key) { return entry.first < key; });
+        if (it != literals.end() && it->first == segment) return it->second;
+
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes[parent].literals.insert(it, {std::string(segment), index});
+        nodes.emplace_back();
+        return index;
+    }
+
+    bool walk(uint32_t index, std::string_view rest, HttpMethod method, Handler& handler,
+              RouteParams& params) const {
+        const Node& node = nodes[index];
+        if (rest.empty()) {
+            if (!node.handles(method)) return false;
+            handler = node.handlers[static_cast<size_t>(method)];
+            return true;
+        }
+
+        std::string_view tail = rest.substr(1);  // Past the '/'
+        size_t slash = tail.find('/');
+        std::string_view segment = tail.substr(0, slash);
+        std::string_view after = slash == std::string_view::npos ? std::string_view{} : tail.substr(slash);
+
+        auto it = std::lower_bound(node.literals.begin(), node.literals.end(), segment,
+                                   [](const auto& entry, std::string_view key) { return entry.first < key; });
+        if (it != node.literals.end() && it->first == segment && walk(it->second, after, method, handler, params)) {
+            return true;
+        }
+
+        if (params.count == RouteParams::kMax) return false;
+        if (node.param != kNone && !segment.empty()) {
+            params.values[params.count++] = segment;
+            if (walk(node.param, after, method, handler, params)) return true;
+            params.count--;
+        }
+        if (node.rest != kNone && !tail.empty() && nodes[node.rest].handles(method)) {
+            params.values[params.count++] = tail;
+            handler = nodes[node.rest].handlers[static_cast<size_t>(method)];
+            return true;
+        }
+        return false;
+    }
+
+public:
+    // Throws std::invalid_argument for malformed patterns and duplicate routes
+    void add(HttpMethod method, std::string_view pattern, Handler handler) {
+        if (pattern.empty() || pattern.front() != '/') {
+            throw std::invalid_argument("Route pattern must start with '/': " + std::string(pattern));
+        }
+
+        uint32_t index = 0;
+        size_t depth = 0;
+        bool last = false;
+        std::string_view rest = pattern.size() == 1 ? std::string_view{} : pattern;
+        while (!rest.empty()) {
+            if (last) {
+                throw std::invalid_argument("{name+} must be the last segment: " + std::string(pattern));
+            }
+            std::string_view tail = rest.substr(1);
+            size_t slash = tail.find('/');
+            std::string_view segment = tail.substr(0, slash);
+            if (!segment.empty() && segment.front() == '{' && ++depth > RouteParams::kMax) {
+                throw std::invalid_argument("Too many route parameters: " + std::string(pattern));
+            }
+            index = child(index, segment, last);
+            rest = slash == std::string_view::npos ? std::string_view{} : tail.substr(slash);
+        }
+
+        Node& node = nodes[index];
+        if (node.handles(method)) {
+            throw std::invalid_argument("Duplicate route: " + std::string(pattern));
+        }
+        node.handlers[static_cast<size_t>(method)] = handler;
+        node.methods |= 1u << static_cast<unsigned>(method);
+    }
+
+    // True when a route matches `path`; `params` then holds views into `path`
+    bool match(HttpMethod method, std::string_view path, Handler& handler, RouteParams& params) const {
+        params.count = 0;
+        if (path.empty() || path.front() != '/') return false;
+        return walk(0, path.size() == 1 ? std::string_view{} : path, method, handler, params);
+    }
+};
+
+#endif // ROUTE_TABLE_H
@@ -0,0 +1,371 @@
+#include "session-api.h"
+#include "../../models/ort_runtime.h"
+#include <cstdlib>
+
+ApiResponse ApiResponse::ok(const EntitiesModel& model) {
+    ApiResponse response;
+    response.entities = model;
+    return response;
+}
+
+ApiResponse ApiResponse::ok(json body) {
+    ApiResponse response;
+    response.body = std::move(body);
+    return response;
+}
+
+ApiResponse ApiResponse::error(int status, const std::string& message) {
+    ApiResponse response;
+    response.status = status;
+    response.body = json{{"detail", message}};
+    return response;
+}
+
+std::string ApiResponse::to_json_string() const {
+    if (entities) {
+        return SessionApi::entities_model_to_json(*entities).dump();
+    }
+    return body.dump();
+}
+
+std::string ApiResponse::to_wire() const {
+    std::string out;
+    uint16_t wire_status = static_cast<uint16_t>(status);
+    if (entities) {
+        TurnWire::encode_entities(*entities, wire_status, out);
+    } else if (status >= 400 && body.is_object() && body.contains("detail") && body["detail"].is_string()) {
+        TurnWire::encode_status_text(WireMessageType::ERROR, wire_status, body["detail"].get<std::string>(), out);
+    } else {
+        TurnWire::encode_status_text(WireMessageType::JSON, wire_status, body.dump(), out);
+    }
+    return out;
+}
+
+SessionApi::SessionApi(const std::string& svm_models_dir, const std::string& ner_models_dir)
+    : svm_models_dir_(svm_models_dir), ner_models_dir_(ner_models_dir) {
+    // e.g. LLM_ENDPOINT=http://127.0.0.1:8080/v1/completions
+    if (const char* endpoint = std::getenv("LLM_ENDPOINT")) {
+        try {
+            llm_client_ = std::make_shared<HttpLLMClient>(LLMEndpointConfig::fromUrl(endpoint));
+            llm_health_ = LLMCircuitBreaker::attach(llm_client_);
+        } catch (const std::exception& e) {
+            std::cerr << "LLM endpoint disabled, using templates: " << e.what() << std::endl;
+        }
+    }
+}
+
+std::shared_ptr<SessionController> SessionApi::find_controller(const std::string& session_id) {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = active_sessions_.find(session_id);
+    return it != active_sessions_.end() ? it->second : nullptr;
+}
+
+// Built once; path parameters arrive as views into the request path
+static const RouteTable<SessionRoute>& session_routes() {
+    static const RouteTable<SessionRoute> routes = [] {
+        RouteTable<SessionRoute> table;
+        table.add(HttpMethod::POST, "/create_session", [](SessionApi& api, const RouteRequest& request) {
+            // Session id from header (like Python: session_id: str = Header(...))
+            return api.create_session(std::string(request.session_header));
+        });
+        table.add(HttpMethod::POST, "/update_session/{session_id+}", [](SessionApi& api, const RouteRequest& request) {
+            return api.update_session(std::string(request.params[0]), request.body, request.body_format);
+        });
+        table.add(HttpMethod::POST, "/end_session/{session_id+}", [](SessionApi& api, const RouteRequest& request) {
+            return api.end_session(std::string(request.params[0]));
+        });
+        table.add(HttpMethod::GET, "/get_session/{session_id+}", [](SessionApi& api, const RouteRequest& request) {
+            return api.get_session(std::string(request.params[0]));
+        });
+        table.add(HttpMethod::GET, "/health", [](SessionApi& api, const RouteRequest&) {
+            return api.health_check();
+        });
+        table.add(HttpMethod::GET, "/debug/memory", [](SessionApi& api, const RouteRequest&) {
+            return api.debug_memory();
+        });
+        table.add(HttpMethod::GET, "/debug/llm", [](SessionApi& api, const RouteRequest&) {
+            return api.debug_llm();
+        });
+        return table;
+    }();
+    return routes;
+}
+
+ApiResponse SessionApi::dispatch(RouteRequest& request) {
+    SessionRoute route = nullptr;
+    if (!session_routes().match(request.method, request.path, route, request.params)) {
+        return ApiResponse::error(404, "Not Found");
+    }
+    return route(*this, request);
+}
+
+ApiResponse SessionApi::create_session(const std::string& session_id) {
+    try {
+        // Validation - exact same as Python
+        if (session_id.empty()) {
+            return ApiResponse::error(400, "Session_id is missing");
+        }
+
+        // Check if session_id is valid
+        if (session_id.find_first_not_of(" \t\n\r") == std::string::npos) {
+            return ApiResponse::error(400, "Session_id must not be an empty string");
+        }
+
+        // If the session_id already exists, return an error
+        if (find_controller(session_id)) {
+            return ApiResponse::error(409, "Session with ID " + session_id + " already exists");
+        }
+
+        // Create new controller (like Python: new_controller = SessionController(session_id)).
+        // The first one loads the crews; later ones only attach to them.
+        auto new_controller = std::make_shared<SessionController>();
+
+        // Initialize with model paths
+        if (!new_controller->initialize(svm_models_dir_, ner_models_dir_, llm_client_)) {
+            return ApiResponse::error(500, "Failed to initialize SessionController");
+        }
+
+        // Call create_session (like Python: result = await new_controller.create_session())
+        auto result = new_controller->create_session(session_id);
+
+        // Store in active_sessions (like Python: active_sessions[session_id] = new_controller)
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        if (!active_sessions_.emplace(session_id, std::move(new_controller)).second) {
+            return ApiResponse::error(409, "Session with ID " + session_id + " already exists");
+        }
+
+        return ApiResponse::ok(result);
+
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+ApiResponse SessionApi::update_session(const std::string& session_id, std::string_view body, BodyFormat format) {
+    try {
+        std::cout << "Accessed the update session API endpoint for session: " << session_id << std::endl;
+
+        // Check if session exists (like Python: if session_id not in active_sessions)
+        auto controller = find_controller(session_id);
+        if (!controller) {
+            std::cerr << "Attempt to update non-existent session: " << session_id << std::endl;
+            return ApiResponse::error(404, "Session not found");
+        }
+
+        // Parse dialogue_input from JSON body (like Python: dialogue_input: DialogueInput)
+        if (body.empty()) {
+            return ApiResponse::error(400, "Request body is empty");
+        }
+
+        DialogueInput dialogue_input;
+        if (format == BodyFormat::JSON) {
+            json request_json = json::parse(body.begin(), body.end());
+            dialogue_input = DialogueInput::from_json(request_json);
+        } else if (format == BodyFormat::TURN_WIRE) {
+            std::string_view sentence;
+            if (!TurnWire::decode_dialogue_input(body, sentence)) {
+                return ApiResponse::error(400, "Invalid turn-wire body");
+            }
+            dialogue_input.sentence = std::string(sentence);
+        } else {
+            dialogue_input.sentence = std::string(body);
+        }
+
+        // Call update (like Python: controller = active_sessions[session_id]); the
+        // table is not locked, so other sessions' turns run alongside this one
+        return ApiResponse::ok(controller->update_session(session_id, dialogue_input.sentence));
+
+    } catch (const json::exception& e) {
+        return ApiResponse::error(400, "Invalid JSON: " + std::string(e.what()));
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+ApiResponse SessionApi::end_session(const std::string& session_id) {
+    try {
+        // Check if session exists (like Python validation), and remove it from
+        // active_sessions (like Python: del active_sessions[session_id])
+        std::shared_ptr<SessionController> controller;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            auto it = active_sessions_.find(session_id);
+            if (it == active_sessions_.end()) {
+                std::cerr << "Attempt to end non-existent session: " << session_id << std::endl;
+                return ApiResponse::error(404, "Session not found");
+            }
+            controller = std::move(it->second);
+            active_sessions_.erase(it);
+        }
+
+        // Waits for a turn in progress; turns queued behind it see the session gone
+        return ApiResponse::ok(controller->end_session(session_id));
+
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+ApiResponse SessionApi::get_session(const std::string& session_id) {
+    try {
+        // Check if session exists
+        auto controller = find_controller(session_id);
+        if (!controller) {
+            std::cerr << "Attempt to get non-existent session: " << session_id << std::endl;
+            return ApiResponse::error(404, "Session not found");
+        }
+
+        return ApiResponse::ok(controller->get_session(session_id));
+
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+ApiResponse SessionApi::health_check() {
+    try {
+        size_t sessions = 0;
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            sessions = active_sessions_.size();
+        }
+
+        // Exact same as Python health check
+        return ApiResponse::ok(json{
+            {"status", "Healthy"},
+            {"message", "Multi AI Agent System is operational"},
+            {"active_sessions", sessions}
+        });
+
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+ApiResponse SessionApi::debug_memory() {
+    try {
+        MemoryReport report;
+
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+
+            // Crews and appointments are shared: counted once, then each session
+            SessionController::report_shared_memory(report);
+            for (const auto& [session_id, controller] : active_sessions_) {
+                controller->report_memory(report);
+            }
+
+            size_t table_bytes = active_sessions_.bucket_count() * sizeof(void*);
+            for (const auto& [session_id, controller] : active_sessions_) {
+                table_bytes += sizeof(std::string) + sizeof(std::shared_ptr<SessionController>) + 2 * sizeof(void*) +
+                               heapBytes(session_id) + sizeof(SessionController) + 2 * sizeof(long);
+            }
+            report.add("http.active_sessions", table_bytes, active_sessions_.size());
+        }
+
+        return ApiResponse::ok(memory_report_to_json(report));
+
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+ApiResponse SessionApi::debug_llm() {
+    try {
+        if (!llm_client_) {
+            return ApiResponse::ok(json{{"enabled", false}});
+        }
+
+        LLMClientStats stats = llm_client_->getStats();
+        CircuitBreakerStats breaker = llm_health_->getStats();
+        const LLMEndpointConfig& config = llm_client_->getConfig();
+        return ApiResponse::ok(json{
+            {"enabled", true},
+            {"circuit", {
+                {"state", toString(breaker.state)},
+                {"trips", breaker.trips},
+                {"rejected", breaker.rejected},
+                {"probes", breaker.probes},
+                {"failed_probes", breaker.failed_probes},
+                {"latency_ewma_ms", breaker.latency_ewma_ms}
+            }},
+            {"endpoint", "http://" + config.host + ":" + std::to_string(config.port) + config.path},
+            {"max_connections", config.max_connections},
+            {"requests", stats.requests},
+            {"failures", stats.failures},
+            {"connections_opened", stats.connections_opened},
+            {"connections_reused", stats.connections_reused},
+            {"in_flight", stats.in_flight},
+            {"pooled_idle", stats.pooled_idle},
+            {"avg_connect_ms", stats.avg_connect_ms},
+            {"p50_ms", stats.p50_ms},
+            {"p95_ms", stats.p95_ms},
+            {"max_ms", stats.max_ms}
+        });
+
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
+
+json SessionApi::memory_report_to_json(const MemoryReport& report) const {
+    OrtMemoryReport ort_report = OrtRuntime::instance().getMemoryReport();
+
+    json components = json::array();
+    for (const auto& account : report.getAccounts()) {
+        components.push_back({
+            {"component", account.component},
+            {"bytes", account.bytes},
+            {"objects", account.objects}
+        });
+    }
+
+    json models = json::array();
+    for (const auto& model : ort_report.models) {
+        models.push_back({
+            {"name", model.name},
+            {"file_bytes", model.file_bytes},
+            {"load_rss_bytes", model.load_rss_bytes},
+            {"runs", model.runs}
+        });
+    }
+
+    // Whatever RSS the hooks do not explain: allocator slack, ORT arena
+    // growth during runs, thread stacks, code and anything leaking
+    size_t accounted = report.totalBytes();
+    size_t unattributed = ort_report.rss_bytes > accounted ? ort_report.rss_bytes - accounted : 0;
+
+    return json{
+        {"rss_bytes", ort_report.rss_bytes},
+        {"peak_rss_bytes", ort_report.peak_rss_bytes},
+        {"accounted_bytes", accounted},
+        {"unattributed_bytes", unattributed},
+        {"components", components},
+        {"ort", {
+            {"shared_arena", ort_report.shared_arena},
+            {"arena_shrinks", ort_report.shrinks},
+            {"in_flight_runs", ort_report.in_flight_runs},
+            {"models", models}
+        }}
+    };
+}
+
+json SessionApi::entities_model_to_json(const EntitiesModel& model) {
+    json entities_json = {
+        {"name", model.entities.name},
+        {"phone", model.entities.phone},
+        {"email", model.entities.email},
+        {"service", model.entities.service},
+        {"day", model.entities.day},
+        {"time", model.entities.time},
+        {"stylist", model.entities.stylist},
+        {"notes", model.entities.notes}
+    };
+
+    return json{
+        {"response", model.response},
+        {"question", model.question},
+        {"session_active", model.session_active},
+        {"entities", entities_json}
+    };
+}
@@ -0,0 +1,110 @@
+#ifndef SESSION_API_H
+#define SESSION_API_H
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+
+#include "route-table.h"
+#include "wire-format.h"
+#include "../../controllers/SessionController.h"
+#include "../../models/memory_accounting.h"
+#include "../../models/http_llm_client.h"
+
+using json = nlohmann::json;
+
+// Body of POST /update_session/{session_id}
+struct DialogueInput {
+    std::string sentence;
+
+    static DialogueInput from_json(const json& j) {
+        DialogueInput input;
+        input.sentence = j.at("sentence").get<std::string>();
+        return input;
+    }
+};
+
+// What a route produced, before any transport renders it
+struct ApiResponse {
+    int status = 200;
+    std::optional<EntitiesModel> entities;  // Session routes
+    json body;                              // Errors, health and debug payloads
+
+    static ApiResponse ok(const EntitiesModel& model);
+    static ApiResponse ok(json body);
+    static ApiResponse error(int status, const std::string& message);  // {"detail": message}
+
+    std::string to_json_string() const;
+    std::string to_wire() const;  // ENTITIES, ERROR or JSON turn-wire message
+
+    // Body and Content-Type for the negotiated format
+    std::string encode(bool wire) const { return wire ? to_wire() : to_json_string(); }
+    static const char* content_type(bool wire) { return wire ? TurnWire::kContentType : "application/json"; }
+};
+
+// How an update_session body carries the caller's sentence
+enum class BodyFormat : uint8_t {
+    JSON,       // {"sentence": ...}
+    TURN_WIRE,  // DIALOGUE_INPUT message (Content-Type application/vnd.turn-wire)
+    SENTENCE    // The sentence itself (socket protocol, already framed)
+};
+
+// A request as the router sees it: views into the transport's own buffers
+struct RouteRequest {
+    HttpMethod method = HttpMethod::OTHER;
+    std::string_view path;
+    std::string_view session_header;  // X-Session-ID
+    std::string_view body;
+    BodyFormat body_format = BodyFormat::JSON;
+    RouteParams params;               // Filled in by the route table
+};
+
+class SessionApi;
+using SessionRoute = ApiResponse (*)(SessionApi& api, const RouteRequest& request);
+
+// The session routes (FastAPI port) without a transport: one SessionController
+// per active session, all sharing the same crews and appointment book. HTTPServer (httplib) and UringHTTPServer both serve it.
+class SessionApi {
+private:
+    std::string svm_models_dir_;
+    std::string ner_models_dir_;
+
+    // One client (and connection pool) for every session's composer and closer;
+    // null when LLM_ENDPOINT is unset
+    std::shared_ptr<HttpLLMClient> llm_client_;
+    std::shared_ptr<LLMCircuitBreaker> llm_health_;  // Same breaker the crews attach to
+
+    // Held only to look up or change the table, never across a turn: a
+    // controller that is ended mid-turn stays alive through its shared_ptr
+    std::unordered_map<std::string, std::shared_ptr<SessionController>> active_sessions_;
+    std::mutex sessions_mutex_;
+
+    std::shared_ptr<SessionController> find_controller(const std::string& session_id);
+
+    json memory_report_to_json(const MemoryReport& report) const;
+
+public:
+    SessionApi(const std::string& svm_models_dir, const std::string& ner_models_dir);
+
+    ApiResponse create_session(const std::string& session_id);
+    ApiResponse update_session(const std::string& session_id, std::string_view body,
+                               BodyFormat format = BodyFormat::JSON);
+    ApiResponse end_session(const std::string& session_id);
+    ApiResponse get_session(const std::string& session_id);
+    ApiResponse health_check();
+    ApiResponse debug_memory();
+    ApiResponse debug_llm();
+
+    // Route through the static route table; 404 when nothing matches
+    ApiResponse dispatch(RouteRequest& request);
+
+    static json entities_model_to_json(const EntitiesModel& model);
+};
+
+#endif // SESSION_API_H
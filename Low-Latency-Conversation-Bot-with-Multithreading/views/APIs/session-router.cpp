@@ -1,250 +1,81 @@
+#include "session-router.h"
+#include <algorithm>
+#include <sys/socket.h>
 
-#include <httplib.h>
+HTTPServer::HTTPServer(const std::string& svm_models_dir, const std::string& ner_models_dir)
+    : HTTPServer(std::make_shared<SessionApi>(svm_models_dir, ner_models_dir)) {}
 
-httplib::Server server;
-
-// So we're importing the class server from httlib.h. 
-
-
-void server::setup_routes() {
-    // Enable CORS (equivalent to FastAPI CORS middleware)
-    server_.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
-        res.set_header("Access-Control-Allow-Origin", "*");
-        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, X-Session-ID");
-        return httplib::Server::HandlerResponse::Unhandled;
-    });
-
-     // Handle OPTIONS requests (CORS preflight)
-    server_.Options(".*", [](const httplib::Request&, httplib::Response& res) {
-        return; // Headers already set in pre_routing_handler
-    });
-
-    // Route handlers - direct FastAPI equivalents
-    server_.Post("/create_session", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_create_session(req, res);
-    });
-
-    server_.Post(R"(/update_session/(.+))", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_update_session(req, res);
-    });
-
-    server_.Post(R"(/end_session/(.+))", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_end_session(req, res);
-    });
-
-    server_.Get(R"(/get_session/(.+))", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_get_session(req, res);
-    });
-
-    server_.Get("/health", [this](const httplib::Request& req, httplib::Response& res) {
-        handle_health_check(req, res);
-    });
-}
-
-
-void HTTPServer::handle_create_session(const httplib::Request& req, httplib::Response& res) {
-    try {
-        // Extract session_id from header (like Python: session_id: str = Header(...))
-        std::string session_id;
-        if (req.has_header("X-Session-ID")) {
-            session_id = req.get_header_value("X-Session-ID");
-        }
-
-        // Validation - exact same as Python
-        if (session_id.empty()) {
-            send_error(res, 400, "Session_id is missing");
-            return;
-        }
-
-        // Check if session_id is valid
-        if (session_id.find_first_not_of(" \t\n\r") == std::string::npos) {
-            send_error(res, 400, "Session_id must not be an empty string");
-            return;
-        }
-
-        {
-            std::lock_guard<std::mutex> lock(sessions_mutex_);
-            
-            // If the session_id already exists, return an error
-            if (active_sessions_.find(session_id) != active_sessions_.end()) {
-                send_error(res, 409, "Session with ID " + session_id + " already exists");
-                return;
-            }
-
-            // Create new controller (like Python: new_controller = SessionController(session_id))
-            auto new_controller = std::make_unique<SessionController>();
-            
-            // Initialize with model paths
-            if (!new_controller->initialize(svm_models_dir_, ner_models_dir_)) {
-                send_error(res, 500, "Failed to initialize SessionController");
-                return;
-            }
-
-            // Call create_session (like Python: result = await new_controller.create_session())
-            auto result = new_controller->create_session(session_id);
-
-            // Store in active_sessions (like Python: active_sessions[session_id] = new_controller)
-            active_sessions_[session_id] = std::move(new_controller);
-
-            // Return result (FastAPI auto-converts to JSON, we do it manually)
-            send_json(res, entities_model_to_json(result));
-        }
-
-    } catch (const std::exception& e) {
-        send_error(res, 500, "Internal server error: " + std::string(e.what()));
+HTTPServer::HTTPServer(std::shared_ptr<SessionApi> api) : api_(std::move(api)) {
+    setup_routes();
+    if (BusyPoll::instance().enabled()) {
+        setup_busy_poll();
     }
 }
 
-void HTTPServer::handle_update_session(const httplib::Request& req, httplib::Response& res) {
-    try {
-        // Extract session_id from path parameters
-        std::string session_id = req.matches[1];
-        
-        std::cout << "Accessed the update session API endpoint for session: " << session_id << std::endl;
-
-        {
-            std::lock_guard<std::mutex> lock(sessions_mutex_);
-            
-            // Check if session exists (like Python: if session_id not in active_sessions)
-            auto it = active_sessions_.find(session_id);
-            if (it == active_sessions_.end()) {
-                std::cerr << "Attempt to update non-existent session: " << session_id << std::endl;
-                send_error(res, 404, "Session not found");
-                return;
-            }
+void HTTPServer::setup_busy_poll() {
+    BusyPollConfig config = BusyPoll::instance().getConfig();
 
-            // Parse dialogue_input from JSON body (like Python: dialogue_input: DialogueInput)
-            if (req.body.empty()) {
-                send_error(res, 400, "Request body is empty");
-                return;
-            }
+    // Each worker owns a keep-alive connection while it is open, so size the
+    // pool for connections, not cores; workers past the spinner seats park
+    size_t threads = std::max<size_t>(8, config.cpus.size());
+    server_.new_task_queue = [threads] { return new BusyPollTaskQueue(threads); };
 
-            json request_json = json::parse(req.body);
-            DialogueInput dialogue_input = DialogueInput::from_json(request_json);
-
-            // Get controller and call update (like Python: controller = active_sessions[session_id])
-            auto& controller = it->second;
-            auto result = controller->update_session(session_id, dialogue_input.sentence);
-
-            // Return result
-            send_json(res, entities_model_to_json(result));
-        }
+    // SO_BUSY_POLL on the listener is inherited by accepted sockets; keep
+    // httplib's default SO_REUSEADDR
+    server_.set_socket_options([](httplib::socket_t sock) {
+        int yes = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        BusyPoll::instance().applySocketOptions(sock);
+    });
 
-    } catch (const json::exception& e) {
-        send_error(res, 400, "Invalid JSON: " + std::string(e.what()));
-    } catch (const std::exception& e) {
-        send_error(res, 500, "Internal server error: " + std::string(e.what()));
-    }
+    std::cout << "🏎️ HTTP server in busy-poll mode (" << threads << " workers)" << std::endl;
 }
 
-void HTTPServer::handle_end_session(const httplib::Request& req, httplib::Response& res) {
-    try {
-        // Extract session_id from path parameters
-        std::string session_id = req.matches[1];
-
-        {
-            std::lock_guard<std::mutex> lock(sessions_mutex_);
-            
-            // Check if session exists (like Python validation)
-            auto it = active_sessions_.find(session_id);
-            if (it == active_sessions_.end()) {
-                std::cerr << "Attempt to end non-existent session: " << session_id << std::endl;
-                send_error(res, 404, "Session not found");
-                return;
-            }
-
-            // Get controller and call end_session
-            auto& controller = it->second;
-            auto result = controller->end_session(session_id);
-
-            // Remove from active_sessions (like Python: del active_sessions[session_id])
-            active_sessions_.erase(it);
-
-            // Return result
-            send_json(res, entities_model_to_json(result));
-        }
+void HTTPServer::setup_routes() {
+    // Routing happens before httplib's own (regex) route matching, which
+    // never runs: the pre-routing handler answers every request
+    server_.set_pre_routing_handler([this](const httplib::Request& req, httplib::Response& res) {
+        // Enable CORS (equivalent to FastAPI CORS middleware)
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, X-Session-ID");
 
-    } catch (const std::exception& e) {
-        send_error(res, 500, "Internal server error: " + std::string(e.what()));
-    }
+        handle_request(req, res);
+        return httplib::Server::HandlerResponse::Handled;
+    });
 }
 
-void HTTPServer::handle_get_session(const httplib::Request& req, httplib::Response& res) {
-    try {
-        // Extract session_id from path parameters
-        std::string session_id = req.matches[1];
-
-        {
-            std::lock_guard<std::mutex> lock(sessions_mutex_);
-            
-            // Check if session exists
-            auto it = active_sessions_.find(session_id);
-            if (it == active_sessions_.end()) {
-                std::cerr << "Attempt to get non-existent session: " << session_id << std::endl;
-                send_error(res, 404, "Session not found");
-                return;
-            }
-
-            // Get controller and call get_session
-            auto& controller = it->second;
-            auto result = controller->get_session(session_id);
-
-            // Return result
-            send_json(res, entities_model_to_json(result));
-        }
+void HTTPServer::handle_request(const httplib::Request& req, httplib::Response& res) {
+    RouteRequest request;
+    request.method = parse_http_method(req.method);
 
-    } catch (const std::exception& e) {
-        send_error(res, 500, "Internal server error: " + std::string(e.what()));
+    // CORS preflight: headers only
+    if (request.method == HttpMethod::OPTIONS) {
+        res.status = 200;
+        return;
     }
-}
-
-void HTTPServer::handle_health_check(const httplib::Request& req, httplib::Response& res) {
-    try {
-        // Exact same as Python health check
-        json health_response = {
-            {"status", "Healthy"},
-            {"message", "Multi AI Agent System is operational"},
-            {"active_sessions", active_sessions_.size()}
-        };
 
-        send_json(res, health_response);
-
-    } catch (const std::exception& e) {
-        send_error(res, 500, "Internal server error: " + std::string(e.what()));
+    auto session_header = req.headers.find("X-Session-ID");
+    if (session_header != req.headers.end()) {
+        request.session_header = session_header->second;
     }
-}
+    request.path = req.path;
+    request.body = req.body;
 
-json HTTPServer::entities_model_to_json(const EntitiesModel& model) const {
-    json entities_json = {
-        {"name", model.entities.name},
-        {"phone", model.entities.phone},
-        {"email", model.entities.email},
-        {"service", model.entities.service},
-        {"day", model.entities.day},
-        {"time", model.entities.time},
-        {"stylist", model.entities.stylist},
-        {"notes", model.entities.notes}
-    };
-
-    return json{
-        {"response", model.response},
-        {"question", model.question},
-        {"session_active", model.session_active},
-        {"entities", entities_json}
-    };
-}
+    // Content negotiation: turn-wire bodies and replies for gateways that ask
+    auto content_type = req.headers.find("Content-Type");
+    if (content_type != req.headers.end() && TurnWire::accepts(content_type->second)) {
+        request.body_format = BodyFormat::TURN_WIRE;
+    }
+    auto accept = req.headers.find("Accept");
+    bool wire = accept != req.headers.end() && TurnWire::accepts(accept->second);
 
-void HTTPServer::send_error(httplib::Response& res, int status_code, const std::string& message) const {
-    json error_response = {
-        {"detail", message}
-    };
-    res.status = status_code;
-    res.set_content(error_response.dump(), "application/json");
+    send_response(res, api_->dispatch(request), wire);
 }
 
-void HTTPServer::send_json(httplib::Response& res, const json& data) const {
-    res.set_content(data.dump(), "application/json");
+void HTTPServer::send_response(httplib::Response& res, const ApiResponse& response, bool wire) const {
+    res.status = response.status;
+    res.set_content(response.encode(wire), ApiResponse::content_type(wire));
 }
 
 bool HTTPServer::start(const std::string& host, int port) {
@@ -255,16 +86,19 @@ bool HTTPServer::start(const std::string& host, int port) {
     std::cout << "  POST /end_session/{session_id}" << std::endl;
     std::cout << "  GET  /get_session/{session_id}" << std::endl;
     std::cout << "  GET  /health" << std::endl;
-
+    std::cout << "  GET  /debug/memory" << std::endl;
+    std::cout << "  GET  /debug/llm" << std::endl;
+
+    // This thread runs the accept loop. With a spinner seat it polls with a
+    // zero timeout before every accept and spins (through
+    // BusyPollTaskQueue::on_idle) instead of sleeping in accept().
+    SpinnerSeat seat("http accept");
+    if (seat.spinning()) {
+        server_.set_idle_interval(0, 1);
+    }
     return server_.listen(host.c_str(), port);
 }
 
 void HTTPServer::stop() {
     server_.stop();
 }
-
-
-
-
-
-
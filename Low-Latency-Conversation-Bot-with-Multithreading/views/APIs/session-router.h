@@ -0,0 +1,71 @@
+#ifndef SESSION_ROUTER_H
+#define SESSION_ROUTER_H
+
+#include <string>
+#include <memory>
+#include <iostream>
+
+#include <httplib.h>
+
+#include "session-api.h"
+#include "../../models/busy_poll.h"
+
+// httplib connection pool for busy-poll mode: workers holding a spinner seat
+// are pinned and spin on the queue, the others park on it
+class BusyPollTaskQueue : public httplib::TaskQueue {
+private:
+    SpinTaskQueue queue;
+    std::vector<std::thread> workers;
+
+public:
+    explicit BusyPollTaskQueue(size_t num_threads) {
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this]() {
+                SpinnerSeat seat("http");
+                std::function<void()> task;
+                while (queue.pop(task, seat.spinning())) {
+                    task();
+                }
+            });
+        }
+    }
+
+    bool enqueue(std::function<void()> fn) override {
+        queue.push(std::move(fn));
+        return true;
+    }
+
+    void shutdown() override {
+        queue.stop();
+        for (auto& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    void on_idle() override { BusyPoll::cpuRelax(); }
+};
+
+// HTTP front end (httplib, thread per connection) over SessionApi
+class HTTPServer {
+private:
+    httplib::Server server_;
+    std::shared_ptr<SessionApi> api_;
+
+    void setup_routes();
+    void setup_busy_poll();
+
+    // Every request goes through SessionApi's route table, never httplib's regex routes
+    void handle_request(const httplib::Request& req, httplib::Response& res);
+
+    // Helpers
+    void send_response(httplib::Response& res, const ApiResponse& response, bool wire) const;
+
+public:
+    HTTPServer(const std::string& svm_models_dir, const std::string& ner_models_dir);
+    explicit HTTPServer(std::shared_ptr<SessionApi> api);  // Share sessions with another front end
+
+    bool start(const std::string& host, int port);
+    void stop();
+};
+
+#endif // SESSION_ROUTER_H
@@ -0,0 +1,1109 @@
+#include "uring-server.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <linux/io_uring.h>
+
+UringServerConfig UringServerConfig::fromEnvironment() {
+    UringServerConfig config;
+
+    if (const char* loops = std::getenv("URING_LOOPS")) {
+        config.event_loops = std::max(1, std::atoi(loops));
+    }
+    if (const char* handlers = std::getenv("URING_HANDLERS")) {
+        config.handler_threads = std::max(1, std::atoi(handlers));
+    }
+    if (const char* buffers = std::getenv("URING_BUFFERS")) {
+        config.buffer_count = static_cast<unsigned>(std::max(8, std::atoi(buffers)));
+    }
+    if (const char* size = std::getenv("URING_BUFFER_SIZE")) {
+        config.buffer_size = static_cast<unsigned>(std::max(512, std::atoi(size)));
+    }
+    const char* force_epoll = std::getenv("URING_FORCE_EPOLL");
+    config.force_epoll = force_epoll && *force_epoll && std::string(force_epoll) != "0";
+    return config;
+}
+
+void UringServerStats::print() const {
+    std::cout << "\n⚡ Event-loop HTTP (" << backend << "): " << accepted << " connections accepted, "
+              << open_connections << " open, " << requests << " requests, " << bad_requests << " rejected, "
+              << buffer_exhaustions << " receive buffer exhaustions" << std::endl;
+}
+
+namespace {
+
+// io_uring through its raw syscalls, so liburing is not a build dependency
+class Ring {
+private:
+    int fd = -1;
+    void* sq_ptr = nullptr;
+    void* cq_ptr = nullptr;
+    size_t sq_bytes = 0;
+    size_t cq_bytes = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_bytes = 0;
+
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned sqe_tail = 0;  // SQEs handed out; published to the kernel by enter()
+
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+public:
+    ~Ring() { close(); }
+
+    // False (errno set) when the kernel has no usable io_uring
+    bool init(unsigned entries) {
+        io_uring_params params{};
+        params.flags = IORING_SETUP_COOP_TASKRUN;  // Completions are reaped in enter() anyway
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0 && errno == EINVAL) {
+            params = io_uring_params{};
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        }
+        if (fd < 0) return false;
+
+        sq_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) sq_bytes = cq_bytes = std::max(sq_bytes, cq_bytes);
+
+        sq_ptr = mmap(nullptr, sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) { sq_ptr = nullptr; close(); return false; }
+        if (single_mmap) {
+            cq_ptr = sq_ptr;
+        } else {
+            cq_ptr = mmap(nullptr, cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) { cq_ptr = nullptr; close(); return false; }
+        }
+        sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqe_ptr = mmap(nullptr, sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqe_ptr == MAP_FAILED) { close(); return false; }
+        sqes = static_cast<io_uring_sqe*>(sqe_ptr);
+
+        char* sq = static_cast<char*>(sq_ptr);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+        unsigned* sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries; ++i) sq_array[i] = i;  // SQE slots in ring order
+        sqe_tail = *sq_tail;
+
+        char* cq = static_cast<char*>(cq_ptr);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void close() {
+        if (sqes) munmap(sqes, sqes_bytes);
+        if (cq_ptr && cq_ptr != sq_ptr) munmap(cq_ptr, cq_bytes);
+        if (sq_ptr) munmap(sq_ptr, sq_bytes);
+        if (fd >= 0) ::close(fd);
+        sqes = nullptr;
+        sq_ptr = cq_ptr = nullptr;
+        fd = -1;
+    }
+
+    // A zeroed SQE; flushes the queue to the kernel when it is full
+    io_uring_sqe* get_sqe() {
+        while (sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+            enter(0);
+        }
+        io_uring_sqe* sqe = &sqes[sqe_tail & sq_mask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe_tail++;
+        return sqe;
+    }
+
+    // Submit queued SQEs and wait for `wait_for` completions; -errno on failure
+    int enter(unsigned wait_for) {
+        __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+        unsigned to_submit = sqe_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        int rc = static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, wait_for, IORING_ENTER_GETEVENTS,
+                                          nullptr, 0));
+        return rc < 0 ? -errno : rc;
+    }
+
+    template <typename Handler>
+    unsigned drain(Handler&& handler) {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        for (; head != tail; ++head, ++count) {
+            handler(cqes[head & cq_mask]);
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    bool register_buffer_ring(io_uring_buf_ring* buffer_ring, unsigned entries, uint16_t group) {
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(buffer_ring);
+        reg.ring_entries = entries;
+        reg.bgid = group;
+        return syscall(__NR_io_uring_register, fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+    }
+};
+
+// Multishot recv with provided buffers is Linux 6.0
+bool kernel_has_multishot_recv() {
+    utsname name{};
+    if (uname(&name) != 0) return false;
+    int major = 0, minor = 0;
+    if (std::sscanf(name.release, "%d.%d", &major, &minor) != 2) return false;
+    return major >= 6;
+}
+
+// What a loop is waiting on, packed into io_uring user_data / epoll data
+enum Op : uint64_t { OP_ACCEPT = 1, OP_RECV, OP_SEND, OP_WAKE, OP_CANCEL };
+
+inline uint64_t pack(Op op, uint32_t slot = 0, uint32_t generation = 0) {
+    return (static_cast<uint64_t>(op) << 56) | (static_cast<uint64_t>(generation & 0xffffff) << 32) | slot;
+}
+inline Op op_of(uint64_t data) { return static_cast<Op>(data >> 56); }
+inline uint32_t slot_of(uint64_t data) { return static_cast<uint32_t>(data); }
+inline uint32_t generation_of(uint64_t data) { return static_cast<uint32_t>(data >> 32) & 0xffffff; }
+
+// ---- HTTP/1.1 request parsing and response rendering ----
+
+struct ParsedRequest {
+    HttpMethod method = HttpMethod::OTHER;
+    std::string path;
+    std::string session_id;  // X-Session-ID
+    std::string body;
+    bool keep_alive = true;
+    bool wire_body = false;      // Content-Type: application/vnd.turn-wire
+    bool wire_response = false;  // Accept: application/vnd.turn-wire
+};
+
+enum class ParseResult { INCOMPLETE, COMPLETE, BAD_REQUEST, HEADERS_TOO_LARGE, BODY_TOO_LARGE, UNSUPPORTED };
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+std::string_view trim(std::string_view value) {
+    size_t first = value.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return {};
+    size_t last = value.find_last_not_of(" \t");
+    return value.substr(first, last - first + 1);
+}
+
+std::string url_decode(std::string_view encoded) {
+    std::string decoded;
+    decoded.reserve(encoded.size());
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size()) {
+            int value = 0;
+            auto [end, ec] = std::from_chars(encoded.data() + i + 1, encoded.data() + i + 3, value, 16);
+            if (ec == std::errc() && end == encoded.data() + i + 3) {
+                decoded.push_back(static_cast<char>(value));
+                i += 2;
+                continue;
+            }
+        }
+        decoded.push_back(encoded[i]);
+    }
+    return decoded;
+}
+
+ParseResult parse_request(std::string_view data, const UringServerConfig& config, ParsedRequest& request,
+                          size_t& consumed) {
+    size_t header_end = data.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) {
+        return data.size() > config.max_header_bytes ? ParseResult::HEADERS_TOO_LARGE : ParseResult::INCOMPLETE;
+    }
+    if (header_end > config.max_header_bytes) return ParseResult::HEADERS_TOO_LARGE;
+
+    std::string_view head = data.substr(0, header_end);
+    size_t line_end = std::min(head.find("\r\n"), head.size());
+    std::string_view line = head.substr(0, line_end);
+
+    // METHOD SP target SP HTTP/1.x
+    size_t method_end = line.find(' ');
+    size_t target_end = method_end == std::string_view::npos ? method_end : line.find(' ', method_end + 1);
+    if (target_end == std::string_view::npos) return ParseResult::BAD_REQUEST;
+    std::string_view version = line.substr(target_end + 1);
+    if (version != "HTTP/1.1" && version != "HTTP/1.0") return ParseResult::BAD_REQUEST;
+
+    std::string_view target = line.substr(method_end + 1, target_end - method_end - 1);
+    request.method = parse_http_method(line.substr(0, method_end));
+    request.path = url_decode(target.substr(0, target.find('?')));
+    request.keep_alive = version == "HTTP/1.1";
+
+    size_t content_length = 0;
+    bool has_content_length = false;
+    size_t pos = line_end;
+    while (pos < head.size()) {
+        pos += 2;  // CRLF
+        size_t next = std::min(head.find("\r\n", pos), head.size());
+        std::string_view header = head.substr(pos, next - pos);
+        pos = next;
+
+        size_t colon = header.find(':');
+        if (colon == std::string_view::npos) return ParseResult::BAD_REQUEST;
+        std::string_view name = trim(header.substr(0, colon));
+        std::string_view value = trim(header.substr(colon + 1));
+
+        if (iequals(name, "Content-Length")) {
+            size_t length = 0;
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (ec != std::errc() || end != value.data() + value.size()) return ParseResult::BAD_REQUEST;
+            // Repeats must agree, or the body boundary depends on which one a hop reads
+            if (has_content_length && length != content_length) return ParseResult::BAD_REQUEST;
+            content_length = length;
+            has_content_length = true;
+        } else if (iequals(name, "Transfer-Encoding")) {
+            return ParseResult::UNSUPPORTED;  // Clients here always send Content-Length
+        } else if (iequals(name, "X-Session-ID")) {
+            request.session_id = std::string(value);
+        } else if (iequals(name, "Content-Type")) {
+            request.wire_body = TurnWire::accepts(value);
+        } else if (iequals(name, "Accept")) {
+            request.wire_response = TurnWire::accepts(value);
+        } else if (iequals(name, "Connection")) {
+            if (iequals(value, "close")) request.keep_alive = false;
+            else if (iequals(value, "keep-alive")) request.keep_alive = true;
+        }
+    }
+
+    if (content_length > config.max_body_bytes) return ParseResult::BODY_TOO_LARGE;
+    size_t total = header_end + 4 + content_length;
+    if (data.size() < total) return ParseResult::INCOMPLETE;
+
+    request.body = std::string(data.substr(header_end + 4, content_length));
+    consumed = total;
+    return ParseResult::COMPLETE;
+}
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        default: return "Unknown";
+    }
+}
+
+// Same CORS headers as HTTPServer's pre-routing handler
+std::string render_response(int status, std::string_view body, bool keep_alive,
+                            const char* content_type = "application/json") {
+    std::string response;
+    response.reserve(256 + body.size());
+    response += "HTTP/1.1 ";
+    response += std::to_string(status);
+    response += ' ';
+    response += reason_phrase(status);
+    response += "\r\nContent-Type: ";
+    response += content_type;
+    response += "\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nAccess-Control-Allow-Origin: *"
+                "\r\nAccess-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS"
+                "\r\nAccess-Control-Allow-Headers: Content-Type, X-Session-ID";
+    response += keep_alive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+}  // namespace
+
+struct UringHTTPServer::EventLoop {
+    struct Connection {
+        int fd = -1;
+        uint32_t generation = 0;
+        std::string in;           // Received, not yet parsed; no heap while idle
+        std::string out;          // Response being sent
+        size_t out_sent = 0;
+        bool busy = false;        // A request is at a handler or its response is being sent
+        bool keep_alive = true;
+        bool closing = false;
+        bool overflowed = false;  // Sent more than one request's worth while busy; answered 413
+        bool recv_armed = false;  // io_uring: multishot recv outstanding
+        bool send_armed = false;  // io_uring: send outstanding
+        bool want_write = false;  // epoll: waiting for EPOLLOUT to finish a response
+    };
+
+    struct Completion {
+        uint32_t slot;
+        uint32_t generation;
+        std::string response;
+        bool keep_alive;
+    };
+
+    UringHTTPServer& server;
+    const UringServerConfig& config;
+    bool use_uring = false;
+    bool busy_poll = false;
+    int listen_fd = -1;
+    int wake_fd = -1;
+
+    // io_uring backend: one provided-buffer ring shared by every connection of the loop
+    Ring ring;
+    io_uring_buf_ring* buffer_ring = nullptr;
+    size_t buffer_ring_bytes = 0;
+    char* buffers = nullptr;
+    size_t buffers_bytes = 0;
+    unsigned buffer_count = 0;
+    uint16_t buffer_ring_tail = 0;
+    uint64_t wake_value = 0;
+    static constexpr uint16_t kBufferGroup = 0;
+
+    // epoll backend
+    int epoll_fd = -1;
+    std::vector<char> scratch;
+
+    std::vector<Connection> connections;
+    std::vector<uint32_t> free_slots;
+
+    std::mutex completions_mutex;
+    std::vector<Completion> completions;
+
+    std::atomic<size_t> accepted{0};
+    std::atomic<size_t> open_connections{0};
+    std::atomic<size_t> requests{0};
+    std::atomic<size_t> bad_requests{0};
+    std::atomic<size_t> buffer_exhaustions{0};
+
+    explicit EventLoop(UringHTTPServer& owner) : server(owner), config(owner.config_) {
+        wake_fd = eventfd(0, EFD_CLOEXEC);
+        if (wake_fd < 0) {
+            throw std::runtime_error("eventfd failed: " + std::string(std::strerror(errno)));
+        }
+    }
+
+    ~EventLoop() {
+        for (auto& connection : connections) {
+            if (connection.fd >= 0) ::close(connection.fd);
+        }
+        ring.close();  // Before the buffers the kernel may still write to
+        if (buffers) munmap(buffers, buffers_bytes);
+        if (buffer_ring) munmap(buffer_ring, buffer_ring_bytes);
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        if (listen_fd >= 0) ::close(listen_fd);
+        ::close(wake_fd);
+    }
+
+    bool init_uring() {
+        if (!ring.init(config.ring_entries)) return false;
+
+        buffer_count = 1;
+        while (buffer_count < std::min(config.buffer_count, 32768u)) buffer_count <<= 1;
+        buffer_ring_bytes = buffer_count * sizeof(io_uring_buf);
+        buffers_bytes = static_cast<size_t>(buffer_count) * config.buffer_size;
+
+        void* ring_memory = mmap(nullptr, buffer_ring_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void* buffer_memory = mmap(nullptr, buffers_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring_memory == MAP_FAILED || buffer_memory == MAP_FAILED) {
+            if (ring_memory != MAP_FAILED) munmap(ring_memory, buffer_ring_bytes);
+            if (buffer_memory != MAP_FAILED) munmap(buffer_memory, buffers_bytes);
+            ring.close();
+            return false;
+        }
+        buffer_ring = static_cast<io_uring_buf_ring*>(ring_memory);
+        buffers = static_cast<char*>(buffer_memory);
+
+        if (!ring.register_buffer_ring(buffer_ring, buffer_count, kBufferGroup)) {
+            ring.close();
+            return false;
+        }
+        for (unsigned bid = 0; bid < buffer_count; ++bid) {
+            recycle_buffer(static_cast<uint16_t>(bid));
+        }
+        use_uring = true;
+        return true;
+    }
+
+    bool init_epoll() {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd < 0) return false;
+        scratch.resize(64 * 1024);  // One read buffer per loop, not per connection
+        return true;
+    }
+
+    bool open_listener(const std::string& host, int port) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* result = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result) != 0) {
+            std::cerr << "❌ Cannot resolve " << host << std::endl;
+            return false;
+        }
+
+        for (addrinfo* address = result; address; address = address->ai_next) {
+            int type = address->ai_socktype | SOCK_CLOEXEC | (use_uring ? 0 : SOCK_NONBLOCK);
+            int fd = socket(address->ai_family, type, address->ai_protocol);
+            if (fd < 0) continue;
+
+            // Every loop binds the same port; the kernel spreads connections over the listeners
+            int yes = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
+            BusyPoll::instance().applySocketOptions(fd);
+
+            if (bind(fd, address->ai_addr, address->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0) {
+                listen_fd = fd;
+                break;
+            }
+            ::close(fd);
+        }
+        freeaddrinfo(result);
+
+        if (listen_fd < 0) {
+            std::cerr << "❌ Cannot listen on " << host << ":" << port << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Any thread: hand a rendered response back to the loop
+    void complete(uint32_t slot, uint32_t generation, std::string response, bool keep_alive) {
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex);
+            completions.push_back({slot, generation, std::move(response), keep_alive});
+        }
+        wake();
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t written = ::write(wake_fd, &one, sizeof(one));
+        (void)written;  // Only fails when the counter would overflow
+    }
+
+    // On the loop's own thread: only a loop holding a spinner seat polls without sleeping
+    void run() {
+        SpinnerSeat seat("http loop");
+        busy_poll = seat.spinning();
+        if (use_uring) {
+            run_uring();
+        } else {
+            run_epoll();
+        }
+    }
+
+    // ---- Connection table (loop thread only) ----
+
+    uint32_t add_connection(int fd) {
+        uint32_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(connections.size());
+            connections.emplace_back();
+        }
+        Connection& connection = connections[slot];
+        connection.fd = fd;
+        connection.keep_alive = true;
+
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        accepted++;
+        open_connections++;
+        return slot;
+    }
+
+    void close_connection(uint32_t slot) {
+        Connection& connection = connections[slot];
+        if (connection.fd < 0 || connection.closing) return;
+        connection.closing = true;
+
+        if (use_uring) {
+            if (connection.recv_armed) {
+                io_uring_sqe* sqe = ring.get_sqe();
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->addr = pack(OP_RECV, slot, connection.generation);
+                sqe->user_data = pack(OP_CANCEL);
+            }
+            release_if_idle(slot);
+        } else {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+            release(slot);
+        }
+    }
+
+    // io_uring: the fd and slot stay until the kernel has no operation on them
+    void release_if_idle(uint32_t slot) {
+        Connection& connection = connections[slot];
+        if (connection.closing && !connection.recv_armed && !connection.send_armed) {
+            release(slot);
+        }
+    }
+
+    // A response still at a handler is dropped by the generation check
+    void release(uint32_t slot) {
+        Connection& connection = connections[slot];
+        ::close(connection.fd);
+        connection.fd = -1;
+        connection.generation++;
+        std::string().swap(connection.in);
+        std::string().swap(connection.out);
+        connection.out_sent = 0;
+        connection.busy = false;
+        connection.closing = false;
+        connection.overflowed = false;
+        connection.want_write = false;
+        free_slots.push_back(slot);
+        open_connections--;
+    }
+
+    // ---- Requests and responses (both backends) ----
+
+    void on_received(uint32_t slot, const char* data, size_t length) {
+        Connection& connection = connections[slot];
+        if (connection.closing || connection.overflowed) return;
+
+        // Pipelined bytes pile up while a request is busy; never buffer more
+        // than one largest request. The current response still goes out first.
+        if (connection.in.size() + length > config.max_header_bytes + config.max_body_bytes) {
+            connection.overflowed = true;
+            std::string().swap(connection.in);
+        } else {
+            connection.in.append(data, length);
+        }
+        process(slot);
+    }
+
+    // Parse the next request once the previous response is out (pipelined requests wait)
+    void process(uint32_t slot) {
+        Connection& connection = connections[slot];
+        if (connection.busy || connection.closing) return;
+        if (connection.overflowed) {
+            reject(slot, 413);
+            return;
+        }
+        if (connection.in.empty()) return;
+
+        ParsedRequest request;
+        size_t consumed = 0;
+        ParseResult result = parse_request(connection.in, config, request, consumed);
+        if (result == ParseResult::INCOMPLETE) return;
+
+        if (result != ParseResult::COMPLETE) {
+            reject(slot, result == ParseResult::HEADERS_TOO_LARGE ? 431
+                       : result == ParseResult::BODY_TOO_LARGE ? 413
+                       : result == ParseResult::UNSUPPORTED ? 501 : 400);
+            return;
+        }
+        connection.busy = true;
+
+        connection.in.erase(0, consumed);
+        if (connection.in.empty()) std::string().swap(connection.in);
+        requests++;
+
+        // CORS preflight: headers only, no handler hop
+        if (request.method == HttpMethod::OPTIONS) {
+            begin_send(slot, render_response(200, "", request.keep_alive), request.keep_alive);
+            return;
+        }
+
+        uint32_t generation = connection.generation;
+        server.post_job([this, slot, generation, request = std::move(request)]() {
+            ApiResponse response;
+            try {
+                RouteRequest route;
+                route.method = request.method;
+                route.path = request.path;
+                route.session_header = request.session_id;
+                route.body = request.body;
+                route.body_format = request.wire_body ? BodyFormat::TURN_WIRE : BodyFormat::JSON;
+                response = server.api_->dispatch(route);
+            } catch (const std::exception& e) {
+                response = ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+            }
+            bool wire = request.wire_response;
+            complete(slot, generation,
+                     render_response(response.status, response.encode(wire), request.keep_alive,
+                                     ApiResponse::content_type(wire)),
+                     request.keep_alive);
+        });
+    }
+
+    // Error response, then close: the rest of the stream can't be trusted
+    void reject(uint32_t slot, int status) {
+        Connection& connection = connections[slot];
+        bad_requests++;
+        connection.busy = true;
+        std::string().swap(connection.in);
+        std::string detail = json{{"detail", reason_phrase(status)}}.dump();
+        begin_send(slot, render_response(status, detail, false), false);
+    }
+
+    void drain_completions() {
+        std::vector<Completion> ready;
+        {
+            std::lock_guard<std::mutex> lock(completions_mutex);
+            ready.swap(completions);
+        }
+        for (auto& completion : ready) {
+            if (completion.slot >= connections.size()) continue;
+            Connection& connection = connections[completion.slot];
+            if (connection.generation != completion.generation || connection.fd < 0 || connection.closing) {
+                continue;  // Closed while the turn ran
+            }
+            begin_send(completion.slot, std::move(completion.response), completion.keep_alive);
+        }
+    }
+
+    void begin_send(uint32_t slot, std::string response, bool keep_alive) {
+        Connection& connection = connections[slot];
+        connection.out = std::move(response);
+        connection.out_sent = 0;
+        connection.keep_alive = keep_alive;
+        continue_send(slot);
+    }
+
+    void continue_send(uint32_t slot) {
+        Connection& connection = connections[slot];
+
+        if (use_uring) {
+            io_uring_sqe* sqe = ring.get_sqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = connection.fd;
+            sqe->addr = reinterpret_cast<uint64_t>(connection.out.data() + connection.out_sent);
+            sqe->len = static_cast<uint32_t>(connection.out.size() - connection.out_sent);
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = pack(OP_SEND, slot, connection.generation);
+            connection.send_armed = true;
+            return;
+        }
+
+        while (connection.out_sent < connection.out.size()) {
+            ssize_t sent = ::send(connection.fd, connection.out.data() + connection.out_sent,
+                                  connection.out.size() - connection.out_sent, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    // Socket buffer full: finish on EPOLLOUT
+                    if (connection.want_write) return;
+                    connection.want_write = true;
+                    epoll_event event{};
+                    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+                    event.data.u64 = pack(OP_RECV, slot, connection.generation);
+                    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+                    return;
+                }
+                close_connection(slot);
+                return;
+            }
+            connection.out_sent += static_cast<size_t>(sent);
+        }
+        finish_response(slot);
+    }
+
+    void finish_response(uint32_t slot) {
+        Connection& connection = connections[slot];
+        std::string().swap(connection.out);
+        connection.out_sent = 0;
+        connection.busy = false;
+
+        if (!connection.keep_alive) {
+            close_connection(slot);
+            return;
+        }
+        if (connection.want_write) {
+            connection.want_write = false;
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.u64 = pack(OP_RECV, slot, connection.generation);
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+        }
+        process(slot);
+    }
+
+    // ---- io_uring backend ----
+
+    void recycle_buffer(uint16_t bid) {
+        // Not buffer_ring->bufs: in C++ the flex-array member lands 8 bytes in
+        io_uring_buf* buffer = reinterpret_cast<io_uring_buf*>(buffer_ring) + (buffer_ring_tail & (buffer_count - 1));
+        buffer->addr = reinterpret_cast<uint64_t>(buffers + static_cast<size_t>(bid) * config.buffer_size);
+        buffer->len = config.buffer_size;
+        buffer->bid = bid;
+        buffer_ring_tail++;
+        __atomic_store_n(&buffer_ring->tail, buffer_ring_tail, __ATOMIC_RELEASE);
+    }
+
+    void arm_accept() {
+        io_uring_sqe* sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listen_fd;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = pack(OP_ACCEPT);
+    }
+
+    void arm_recv(uint32_t slot) {
+        Connection& connection = connections[slot];
+        io_uring_sqe* sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = connection.fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        sqe->user_data = pack(OP_RECV, slot, connection.generation);
+        connection.recv_armed = true;
+    }
+
+    void arm_wake() {
+        io_uring_sqe* sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = wake_fd;
+        sqe->addr = reinterpret_cast<uint64_t>(&wake_value);
+        sqe->len = sizeof(wake_value);
+        sqe->user_data = pack(OP_WAKE);
+    }
+
+    void handle_cqe(const io_uring_cqe& cqe) {
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+        uint32_t slot = slot_of(cqe.user_data);
+
+        switch (op_of(cqe.user_data)) {
+            case OP_ACCEPT:
+                if (cqe.res >= 0) {
+                    arm_recv(add_connection(cqe.res));
+                } else if (cqe.res != -ECANCELED) {
+                    std::cerr << "⚠️ accept failed: " << std::strerror(-cqe.res) << std::endl;
+                }
+                if (!more && server.running_) arm_accept();
+                break;
+
+            case OP_RECV: {
+                Connection& connection = connections[slot];
+                bool current = generation_of(cqe.user_data) == (connection.generation & 0xffffff);
+                if (cqe.flags & IORING_CQE_F_BUFFER) {
+                    uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                    if (current && cqe.res > 0) {
+                        on_received(slot, buffers + static_cast<size_t>(bid) * config.buffer_size,
+                                    static_cast<size_t>(cqe.res));
+                    }
+                    recycle_buffer(bid);
+                }
+                if (more || !current) break;
+
+                // Multishot recv ended: out of buffers (re-arm), peer closed, error or cancelled
+                connection.recv_armed = false;
+                if (connection.closing) {
+                    release_if_idle(slot);
+                } else if (cqe.res > 0 || cqe.res == -ENOBUFS) {
+                    if (cqe.res == -ENOBUFS) buffer_exhaustions++;
+                    arm_recv(slot);
+                } else {
+                    close_connection(slot);
+                }
+                break;
+            }
+
+            case OP_SEND: {
+                Connection& connection = connections[slot];
+                connection.send_armed = false;
+                if (connection.closing) {
+                    release_if_idle(slot);
+                } else if (cqe.res < 0) {
+                    close_connection(slot);
+                } else {
+                    connection.out_sent += static_cast<size_t>(cqe.res);
+                    if (connection.out_sent < connection.out.size()) {
+                        continue_send(slot);
+                    } else {
+                        finish_response(slot);
+                    }
+                }
+                break;
+            }
+
+            case OP_WAKE:
+                drain_completions();
+                if (server.running_) arm_wake();
+                break;
+
+            case OP_CANCEL:
+                break;  // The cancelled recv reports on its own CQE
+        }
+    }
+
+    void run_uring() {
+        arm_accept();
+        arm_wake();
+
+        while (server.running_) {
+            // Busy-poll: reap without sleeping in the kernel
+            int rc = ring.enter(busy_poll ? 0 : 1);
+            if (rc < 0 && rc != -EINTR && rc != -EBUSY && rc != -EAGAIN) {
+                std::cerr << "❌ io_uring_enter failed: " << std::strerror(-rc) << std::endl;
+                break;
+            }
+            unsigned reaped = ring.drain([this](const io_uring_cqe& cqe) { handle_cqe(cqe); });
+            if (busy_poll && reaped == 0) BusyPoll::cpuRelax();
+        }
+    }
+
+    // ---- epoll backend ----
+
+    void accept_ready() {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::cerr << "⚠️ accept failed: " << std::strerror(errno) << std::endl;
+                }
+                return;
+            }
+            uint32_t slot = add_connection(fd);
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP;
+            event.data.u64 = pack(OP_RECV, slot, connections[slot].generation);
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        }
+    }
+
+    void read_ready(uint32_t slot) {
+        while (connections[slot].fd >= 0 && !connections[slot].closing) {
+            ssize_t received = ::recv(connections[slot].fd, scratch.data(), scratch.size(), 0);
+            if (received > 0) {
+                on_received(slot, scratch.data(), static_cast<size_t>(received));
+                continue;
+            }
+            if (received < 0 && errno == EINTR) continue;
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            close_connection(slot);  // Peer closed or error
+            return;
+        }
+    }
+
+    void run_epoll() {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = pack(OP_ACCEPT);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+        event.data.u64 = pack(OP_WAKE);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+        epoll_event events[256];
+        while (server.running_) {
+            int ready = epoll_wait(epoll_fd, events, 256, busy_poll ? 0 : -1);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "❌ epoll_wait failed: " << std::strerror(errno) << std::endl;
+                break;
+            }
+            if (ready == 0 && busy_poll) BusyPoll::cpuRelax();
+
+            for (int i = 0; i < ready; ++i) {
+                uint64_t data = events[i].data.u64;
+                switch (op_of(data)) {
+                    case OP_ACCEPT:
+                        accept_ready();
+                        break;
+                    case OP_WAKE: {
+                        uint64_t count = 0;
+                        ssize_t drained = ::read(wake_fd, &count, sizeof(count));
+                        (void)drained;
+                        drain_completions();
+                        break;
+                    }
+                    case OP_RECV: {
+                        uint32_t slot = slot_of(data);
+                        if (slot >= connections.size() || connections[slot].fd < 0 ||
+                            (connections[slot].generation & 0xffffff) != generation_of(data)) {
+                            break;
+                        }
+                        if (events[i].events & EPOLLOUT) continue_send(slot);
+                        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) read_ready(slot);
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+        }
+    }
+};
+
+UringHTTPServer::UringHTTPServer(std::shared_ptr<SessionApi> api, const UringServerConfig& config)
+    : api_(std::move(api)), config_(config) {
+    if (!api_) {
+        throw std::runtime_error("UringHTTPServer needs a SessionApi");
+    }
+}
+
+UringHTTPServer::~UringHTTPServer() {
+    stop();
+    for (auto& thread : loop_threads_) {
+        if (thread.joinable()) thread.join();
+    }
+    stop_handlers();
+}
+
+void UringHTTPServer::start_handlers() {
+    busy_poll_ = BusyPoll::instance().enabled();
+    stopping_ = false;
+    spin_jobs_.resume();
+
+    for (int i = 0; i < config_.handler_threads; ++i) {
+        handlers_.emplace_back([this]() {
+            std::function<void()> job;
+            if (busy_poll_) {
+                SpinnerSeat seat("http handler");
+                while (spin_jobs_.pop(job, seat.spinning())) {
+                    job();
+                }
+                return;
+            }
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(jobs_mutex_);
+                    jobs_cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+                    if (stopping_ && jobs_.empty()) return;
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                }
+                job();
+            }
+        });
+    }
+}
+
+void UringHTTPServer::stop_handlers() {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        stopping_ = true;
+    }
+    jobs_cv_.notify_all();
+    spin_jobs_.stop();
+    for (auto& handler : handlers_) {
+        if (handler.joinable()) handler.join();
+    }
+    handlers_.clear();
+}
+
+void UringHTTPServer::post_job(std::function<void()> job) {
+    if (busy_poll_) {
+        spin_jobs_.push(std::move(job));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobs_cv_.notify_one();
+}
+
+bool UringHTTPServer::start(const std::string& host, int port) {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
+        std::cerr << "❌ Event-loop HTTP server already running" << std::endl;
+        return false;
+    }
+
+    loops_.clear();
+    loop_threads_.clear();
+
+    // Every loop gets its own ring (or epoll set) and SO_REUSEPORT listener
+    auto build_loops = [&](bool uring) {
+        loops_.clear();
+        for (int i = 0; i < config_.event_loops; ++i) {
+            auto loop = std::make_unique<EventLoop>(*this);
+            if (uring ? !loop->init_uring() : !loop->init_epoll()) return false;
+            if (!loop->open_listener(host, port)) return false;
+            loops_.push_back(std::move(loop));
+        }
+        return true;
+    };
+
+    // io_uring unless forced off or unusable; every loop uses the same backend
+    bool use_uring = !config_.force_epoll && kernel_has_multishot_recv();
+    try {
+        if (use_uring && !build_loops(true)) {
+            std::cerr << "⚠️ io_uring unavailable (" << std::strerror(errno) << "), falling back to epoll"
+                      << std::endl;
+            use_uring = false;
+        }
+        if (!use_uring && !build_loops(false)) {
+            loops_.clear();
+            running_ = false;
+            return false;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Event-loop HTTP server failed to start: " << e.what() << std::endl;
+        loops_.clear();
+        running_ = false;
+        return false;
+    }
+    backend_ = use_uring ? "io_uring" : "epoll";
+
+    std::cout << "⚡ Starting event-loop HTTP server on " << host << ":" << port << " (" << backend_ << ", "
+              << loops_.size() << " loops, " << config_.handler_threads << " handlers)" << std::endl;
+
+    start_handlers();
+    for (size_t i = 1; i < loops_.size(); ++i) {
+        loop_threads_.emplace_back([this, i]() {
+            loops_[i]->run();
+        });
+    }
+
+    // This thread runs the first loop
+    loops_[0]->run();
+
+    for (auto& thread : loop_threads_) {
+        if (thread.joinable()) thread.join();
+    }
+    stop_handlers();
+    return true;
+}
+
+void UringHTTPServer::stop() {
+    if (!running_.exchange(false)) return;
+    for (auto& loop : loops_) {
+        loop->wake();
+    }
+}
+
+UringServerStats UringHTTPServer::get_stats() const {
+    UringServerStats stats;
+    stats.backend = backend_;
+    for (const auto& loop : loops_) {
+        stats.accepted += loop->accepted.load();
+        stats.open_connections += loop->open_connections.load();
+        stats.requests += loop->requests.load();
+        stats.bad_requests += loop->bad_requests.load();
+        stats.buffer_exhaustions += loop->buffer_exhaustions.load();
+    }
+    return stats;
+}
@@ -0,0 +1,88 @@
+#ifndef URING_SERVER_H
+#define URING_SERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "session-api.h"
+#include "../../models/busy_poll.h"
+
+// Event-loop HTTP/1.1 front end for SessionApi, an alternative to httplib's
+// thread per connection. A few loop threads each own an io_uring with a
+// multishot accept on their own SO_REUSEPORT listener, multishot receives
+// into a shared provided-buffer ring and sends; parsed requests go to a
+// small handler pool that runs the turn pipeline and hands the rendered
+// response back to the loop. An idle keep-alive connection is a slot in a
+// table and a kernel socket: no thread, no stack and no receive buffer.
+// Falls back to epoll when io_uring (multishot recv needs Linux 6.0) is not
+// available.
+struct UringServerConfig {
+    int event_loops = 2;
+    int handler_threads = 8;            // Turns in flight at once
+    unsigned ring_entries = 1024;       // SQ size per loop
+    unsigned buffer_count = 512;        // Provided receive buffers per loop (power of two)
+    unsigned buffer_size = 4096;
+    size_t max_header_bytes = 16 * 1024;
+    size_t max_body_bytes = 1024 * 1024;
+    bool force_epoll = false;
+
+    // URING_LOOPS, URING_HANDLERS, URING_BUFFERS, URING_BUFFER_SIZE, URING_FORCE_EPOLL=1
+    static UringServerConfig fromEnvironment();
+};
+
+struct UringServerStats {
+    std::string backend;  // "io_uring" or "epoll"
+    size_t accepted = 0;
+    size_t open_connections = 0;
+    size_t requests = 0;
+    size_t bad_requests = 0;
+    size_t buffer_exhaustions = 0;  // Multishot recv stopped for lack of provided buffers
+
+    void print() const;
+};
+
+class UringHTTPServer {
+private:
+    struct EventLoop;  // One ring (or epoll set), listener and connection table
+
+    std::shared_ptr<SessionApi> api_;
+    UringServerConfig config_;
+    std::string backend_;
+
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+    std::vector<std::thread> loop_threads_;
+    std::atomic<bool> running_{false};
+
+    // Handler pool: the turn pipeline blocks, so it never runs on a loop thread
+    std::vector<std::thread> handlers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    bool stopping_ = false;
+    bool busy_poll_ = false;
+    SpinTaskQueue spin_jobs_;
+
+    void start_handlers();
+    void stop_handlers();
+    void post_job(std::function<void()> job);
+
+public:
+    UringHTTPServer(std::shared_ptr<SessionApi> api,
+                    const UringServerConfig& config = UringServerConfig::fromEnvironment());
+    ~UringHTTPServer();
+
+    // Blocks until stop(), like HTTPServer::start
+    bool start(const std::string& host, int port);
+    void stop();
+
+    UringServerStats get_stats() const;
+};
+
+#endif // URING_SERVER_H
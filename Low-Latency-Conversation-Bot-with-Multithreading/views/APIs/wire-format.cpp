@@ -0,0 +1,168 @@
+#include "wire-format.h"
+
+static constexpr size_t kEntityStrings = 10;
+
+static void put_u16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xff));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+static void put_u32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+static uint16_t get_u16(const char* data) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+static uint32_t get_u32(const char* data) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static void put_header(std::string& out, WireMessageType type, size_t payload_bytes) {
+    out.reserve(out.size() + TurnWire::kHeaderBytes + payload_bytes);
+    out.push_back(static_cast<char>(TurnWire::kMagic));
+    out.push_back(static_cast<char>(TurnWire::kVersion));
+    out.push_back(static_cast<char>(type));
+    out.push_back(0);  // flags
+    put_u32(out, static_cast<uint32_t>(payload_bytes));
+}
+
+// Payload of `message` when it is a whole message of `type`
+static bool payload_of(std::string_view message, WireMessageType type, std::string_view& payload) {
+    WireHeader header;
+    if (!TurnWire::decode_header(message, header) || header.type != type) return false;
+    if (message.size() != TurnWire::kHeaderBytes + header.length) return false;
+    payload = message.substr(TurnWire::kHeaderBytes);
+    return true;
+}
+
+EntitiesModel WireEntities::to_model() const {
+    EntitiesModel model;
+    model.response = std::string(response);
+    model.question = std::string(question);
+    model.session_active = session_active;
+    model.entities.name = std::string(name);
+    model.entities.phone = std::string(phone);
+    model.entities.email = std::string(email);
+    model.entities.service = std::string(service);
+    model.entities.day = std::string(day);
+    model.entities.time = std::string(time);
+    model.entities.stylist = std::string(stylist);
+    model.entities.notes = std::string(notes);
+    return model;
+}
+
+void TurnWire::encode_dialogue_input(std::string_view sentence, std::string& out) {
+    put_header(out, WireMessageType::DIALOGUE_INPUT, sentence.size());
+    out.append(sentence);
+}
+
+bool TurnWire::encode_turn_request(WireOp op, std::string_view session_id, std::string_view text, std::string& out) {
+    if (session_id.size() > UINT16_MAX || 4 + session_id.size() + text.size() > kMaxPayloadBytes) return false;
+    put_header(out, WireMessageType::TURN_REQUEST, 4 + session_id.size() + text.size());
+    out.push_back(static_cast<char>(op));
+    out.push_back(0);
+    put_u16(out, static_cast<uint16_t>(session_id.size()));
+    out.append(session_id);
+    out.append(text);
+    return true;
+}
+
+void TurnWire::encode_entities(const EntitiesModel& model, uint16_t status, std::string& out) {
+    const std::array<const std::string*, kEntityStrings> strings = {
+        &model.response, &model.question,
+        &model.entities.name, &model.entities.phone, &model.entities.email, &model.entities.service,
+        &model.entities.day, &model.entities.time, &model.entities.stylist, &model.entities.notes
+    };
+
+    size_t string_bytes = 0;
+    for (const auto* value : strings) string_bytes += value->size();
+    put_header(out, WireMessageType::ENTITIES, 4 + 4 * kEntityStrings + string_bytes);
+
+    put_u16(out, status);
+    out.push_back(model.session_active ? 1 : 0);
+    out.push_back(0);
+    uint32_t end = 0;
+    for (const auto* value : strings) {
+        end += static_cast<uint32_t>(value->size());
+        put_u32(out, end);
+    }
+    for (const auto* value : strings) out.append(*value);
+}
+
+void TurnWire::encode_status_text(WireMessageType type, uint16_t status, std::string_view text, std::string& out) {
+    put_header(out, type, 4 + text.size());
+    put_u16(out, status);
+    put_u16(out, 0);
+    out.append(text);
+}
+
+bool TurnWire::decode_header(std::string_view data, WireHeader& header) {
+    if (data.size() < kHeaderBytes) return false;
+    if (static_cast<uint8_t>(data[0]) != kMagic || static_cast<uint8_t>(data[1]) != kVersion) return false;
+    header.type = static_cast<WireMessageType>(data[2]);
+    header.flags = static_cast<uint8_t>(data[3]);
+    header.length = get_u32(data.data() + 4);
+    return header.length <= kMaxPayloadBytes;
+}
+
+bool TurnWire::decode_dialogue_input(std::string_view message, std::string_view& sentence) {
+    return payload_of(message, WireMessageType::DIALOGUE_INPUT, sentence);
+}
+
+bool TurnWire::decode_turn_request(std::string_view message, WireTurnRequest& request) {
+    std::string_view payload;
+    if (!payload_of(message, WireMessageType::TURN_REQUEST, payload) || payload.size() < 4) return false;
+
+    uint8_t op = static_cast<uint8_t>(payload[0]);
+    if (op < static_cast<uint8_t>(WireOp::CREATE_SESSION) || op > static_cast<uint8_t>(WireOp::HEALTH)) return false;
+    size_t id_length = get_u16(payload.data() + 2);
+    if (payload.size() < 4 + id_length) return false;
+
+    request.op = static_cast<WireOp>(op);
+    request.session_id = payload.substr(4, id_length);
+    request.text = payload.substr(4 + id_length);
+    return true;
+}
+
+bool TurnWire::decode_entities(std::string_view message, WireEntities& entities) {
+    std::string_view payload;
+    const size_t fixed = 4 + 4 * kEntityStrings;
+    if (!payload_of(message, WireMessageType::ENTITIES, payload) || payload.size() < fixed) return false;
+
+    entities.status = get_u16(payload.data());
+    entities.session_active = payload[2] != 0;
+
+    std::array<std::string_view*, kEntityStrings> fields = {
+        &entities.response, &entities.question,
+        &entities.name, &entities.phone, &entities.email, &entities.service,
+        &entities.day, &entities.time, &entities.stylist, &entities.notes
+    };
+    std::string_view strings = payload.substr(fixed);
+    uint32_t begin = 0;
+    for (size_t i = 0; i < kEntityStrings; ++i) {
+        uint32_t end = get_u32(payload.data() + 4 + 4 * i);
+        if (end < begin || end > strings.size()) return false;
+        *fields[i] = strings.substr(begin, end - begin);
+        begin = end;
+    }
+    return begin == strings.size();
+}
+
+bool TurnWire::decode_status_text(std::string_view message, WireStatusText& status_text) {
+    WireHeader header;
+    if (!decode_header(message, header)) return false;
+    if (header.type != WireMessageType::ERROR && header.type != WireMessageType::JSON) return false;
+
+    std::string_view payload;
+    if (!payload_of(message, header.type, payload) || payload.size() < 4) return false;
+    status_text.status = get_u16(payload.data());
+    status_text.text = payload.substr(4);
+    return true;
+}
@@ -0,0 +1,108 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <cstdint>
+
+#include "../../controllers/SessionController.h"
+
+// Binary alternative to the JSON bodies for gateway-to-bot traffic. Every
+// message is an 8-byte header followed by `length` payload bytes, so the
+// same bytes serve as an HTTP body (Content-Type / Accept
+// application/vnd.turn-wire) and as a frame on the raw socket protocol
+// (WireServer). Integers are little-endian. Strings are raw UTF-8 without
+// terminators: a message's strings are packed back to back after a table
+// of end offsets, and decoding returns string_views into the message.
+//
+//   header:          u8 magic 0xB7 | u8 version 1 | u8 type | u8 flags | u32 length
+//   DIALOGUE_INPUT:  sentence
+//   TURN_REQUEST:    u8 op | u8 reserved | u16 session_id length | session_id | text
+//   ENTITIES:        u16 status | u8 session_active | u8 reserved | u32 end[10] | strings
+//                    (response, question, name, phone, email, service, day, time, stylist, notes)
+//   ERROR, JSON:     u16 status | u16 reserved | text (detail, or a JSON document)
+enum class WireMessageType : uint8_t {
+    DIALOGUE_INPUT = 1,  // Body of update_session
+    TURN_REQUEST = 2,    // Socket protocol request
+    ENTITIES = 3,        // EntitiesModel reply
+    ERROR = 4,
+    JSON = 5             // Health and debug replies, kept as JSON text
+};
+
+// Socket protocol operations (HTTP uses the routes instead)
+enum class WireOp : uint8_t {
+    CREATE_SESSION = 1,
+    UPDATE_SESSION = 2,  // text: the caller's sentence
+    END_SESSION = 3,
+    GET_SESSION = 4,
+    HEALTH = 5
+};
+
+struct WireHeader {
+    WireMessageType type = WireMessageType::ERROR;
+    uint8_t flags = 0;
+    uint32_t length = 0;  // Payload bytes after the header
+};
+
+struct WireTurnRequest {
+    WireOp op = WireOp::HEALTH;
+    std::string_view session_id;
+    std::string_view text;
+};
+
+// EntitiesModel without copies: views into the decoded message
+struct WireEntities {
+    uint16_t status = 200;
+    bool session_active = false;
+    std::string_view response;
+    std::string_view question;
+    std::string_view name;
+    std::string_view phone;
+    std::string_view email;
+    std::string_view service;
+    std::string_view day;
+    std::string_view time;
+    std::string_view stylist;
+    std::string_view notes;
+
+    EntitiesModel to_model() const;
+};
+
+struct WireStatusText {
+    uint16_t status = 200;
+    std::string_view text;
+};
+
+struct TurnWire {
+    static constexpr uint8_t kMagic = 0xB7;
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 8;
+    static constexpr uint32_t kMaxPayloadBytes = 16 * 1024 * 1024;
+    static constexpr const char* kContentType = "application/vnd.turn-wire";
+
+    // Encoders append one whole message to `out` with a single reservation
+    static void encode_dialogue_input(std::string_view sentence, std::string& out);
+    // False (and nothing appended) when session_id is over 65535 bytes or the
+    // payload over kMaxPayloadBytes
+    static bool encode_turn_request(WireOp op, std::string_view session_id, std::string_view text, std::string& out);
+    static void encode_entities(const EntitiesModel& model, uint16_t status, std::string& out);
+    static void encode_status_text(WireMessageType type, uint16_t status, std::string_view text, std::string& out);
+
+    // False on a bad magic or version or an oversized length; needs kHeaderBytes
+    static bool decode_header(std::string_view data, WireHeader& header);
+
+    // Decoders take a whole message (header included) and validate every
+    // length against it; the views live as long as `message`
+    static bool decode_dialogue_input(std::string_view message, std::string_view& sentence);
+    static bool decode_turn_request(std::string_view message, WireTurnRequest& request);
+    static bool decode_entities(std::string_view message, WireEntities& entities);
+    static bool decode_status_text(std::string_view message, WireStatusText& status_text);
+
+    // True when a Content-Type or Accept header names the binary format
+    static bool accepts(std::string_view header_value) {
+        return header_value.find(kContentType) != std::string_view::npos;
+    }
+};
+
+#endif // WIRE_FORMAT_H
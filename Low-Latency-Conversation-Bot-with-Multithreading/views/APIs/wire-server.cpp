@@ -0,0 +1,233 @@
+#include "wire-server.h"
+#include "../../models/busy_poll.h"
+#include <iostream>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+WireServer::WireServer(std::shared_ptr<SessionApi> api) : api_(std::move(api)) {
+    if (!api_) {
+        throw std::runtime_error("WireServer needs a SessionApi");
+    }
+}
+
+WireServer::~WireServer() {
+    stop();
+    std::unique_lock<std::mutex> lock(serving_mutex_);
+    serving_cv_.wait(lock, [this] { return !serving_; });
+}
+
+// Closes the listener and releases the destructor
+void WireServer::finish_serving() {
+    std::lock_guard<std::mutex> lock(serving_mutex_);
+    if (listen_fd_ >= 0) close(listen_fd_);
+    listen_fd_ = -1;
+    serving_ = false;
+    serving_cv_.notify_all();
+}
+
+// Joins finished connection threads, or with `all` unblocks and joins every one
+void WireServer::reap_connections(bool all) {
+    if (all) {
+        for (auto& connection : connections_) {
+            if (!connection.done) shutdown(connection.fd, SHUT_RDWR);
+        }
+    }
+    for (auto it = connections_.begin(); it != connections_.end();) {
+        if (!all && !it->done) {
+            ++it;
+            continue;
+        }
+        it->thread.join();
+        close(it->fd);
+        it = connections_.erase(it);
+    }
+}
+
+bool WireServer::open_listener(const std::string& address, int& listen_fd) {
+    if (address.rfind("unix:", 0) == 0) {
+        unix_path_ = address.substr(5);
+        sockaddr_un local{};
+        if (unix_path_.empty() || unix_path_.size() >= sizeof(local.sun_path)) {
+            std::cerr << "❌ Bad Unix socket path: " << unix_path_ << std::endl;
+            return false;
+        }
+        local.sun_family = AF_UNIX;
+        std::memcpy(local.sun_path, unix_path_.c_str(), unix_path_.size() + 1);
+
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        unlink(unix_path_.c_str());  // A stale socket from a previous run
+        if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0 ||
+            listen(listen_fd, SOMAXCONN) != 0) {
+            std::cerr << "❌ Cannot listen on " << address << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        std::cerr << "❌ Wire address must be host:port or unix:/path, got " << address << std::endl;
+        return false;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0) {
+        std::cerr << "❌ Cannot resolve " << address << std::endl;
+        return false;
+    }
+    for (addrinfo* candidate = result; candidate; candidate = candidate->ai_next) {
+        int fd = socket(candidate->ai_family, candidate->ai_socktype | SOCK_CLOEXEC, candidate->ai_protocol);
+        if (fd < 0) continue;
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        BusyPoll::instance().applySocketOptions(fd);
+        if (bind(fd, candidate->ai_addr, candidate->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0) {
+            listen_fd = fd;
+            break;
+        }
+        close(fd);
+    }
+    freeaddrinfo(result);
+
+    if (listen_fd < 0) {
+        std::cerr << "❌ Cannot listen on " << address << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool WireServer::start(const std::string& address) {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
+        std::cerr << "❌ Wire server already running" << std::endl;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(serving_mutex_);
+        serving_ = true;
+    }
+    int listen_fd = -1;
+    if (!open_listener(address, listen_fd)) {
+        if (listen_fd >= 0) close(listen_fd);
+        running_ = false;
+        finish_serving();
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(serving_mutex_);
+        listen_fd_ = listen_fd;  // stop() shuts it down from here on
+    }
+
+    std::cout << "🔌 Turn-wire server on " << address << std::endl;
+
+    while (running_) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (running_) std::cerr << "⚠️ Wire accept failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        reap_connections(false);
+        Connection& connection = connections_.emplace_back(fd);
+        connection.thread = std::thread([this, &connection]() {
+            serve_connection(connection.fd);
+            connection.done = true;
+        });
+    }
+
+    // Unblock the connection threads and join them before returning
+    reap_connections(true);
+
+    if (!unix_path_.empty()) unlink(unix_path_.c_str());
+    finish_serving();
+    return true;
+}
+
+void WireServer::stop() {
+    if (!running_.exchange(false)) return;
+    std::lock_guard<std::mutex> lock(serving_mutex_);
+    if (listen_fd_ >= 0) shutdown(listen_fd_, SHUT_RDWR);  // Wakes accept()
+}
+
+void WireServer::serve_connection(int fd) {
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));  // Fails harmlessly on Unix sockets
+
+    std::string in;
+    std::string out;
+    char chunk[64 * 1024];
+
+    while (running_) {
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return;
+        in.append(chunk, static_cast<size_t>(received));
+
+        // Answer every complete frame, then write all replies at once
+        size_t offset = 0;
+        while (in.size() - offset >= TurnWire::kHeaderBytes) {
+            std::string_view pending(in.data() + offset, in.size() - offset);
+            WireHeader header;
+            if (!TurnWire::decode_header(pending, header)) {
+                bad_frames_++;
+                TurnWire::encode_status_text(WireMessageType::ERROR, 400, "Bad turn-wire header", out);
+                send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+                return;  // The stream cannot be resynchronized
+            }
+            size_t frame_bytes = TurnWire::kHeaderBytes + header.length;
+            if (pending.size() < frame_bytes) break;
+
+            WireTurnRequest request;
+            if (TurnWire::decode_turn_request(pending.substr(0, frame_bytes), request)) {
+                ApiResponse response = handle_request(request);
+                out += response.to_wire();
+                frames_++;
+            } else {
+                bad_frames_++;
+                TurnWire::encode_status_text(WireMessageType::ERROR, 400, "Expected a TURN_REQUEST frame", out);
+            }
+            offset += frame_bytes;
+        }
+        in.erase(0, offset);
+
+        size_t sent = 0;
+        while (sent < out.size()) {
+            ssize_t written = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return;
+            sent += static_cast<size_t>(written);
+        }
+        out.clear();
+    }
+}
+
+ApiResponse WireServer::handle_request(const WireTurnRequest& request) {
+    try {
+        std::string session_id(request.session_id);
+        switch (request.op) {
+            case WireOp::CREATE_SESSION: return api_->create_session(session_id);
+            case WireOp::UPDATE_SESSION: return api_->update_session(session_id, request.text, BodyFormat::SENTENCE);
+            case WireOp::END_SESSION: return api_->end_session(session_id);
+            case WireOp::GET_SESSION: return api_->get_session(session_id);
+            case WireOp::HEALTH: return api_->health_check();
+        }
+        return ApiResponse::error(400, "Unknown operation");
+    } catch (const std::exception& e) {
+        return ApiResponse::error(500, "Internal server error: " + std::string(e.what()));
+    }
+}
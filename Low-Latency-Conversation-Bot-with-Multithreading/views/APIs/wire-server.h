@@ -0,0 +1,66 @@
+#ifndef WIRE_SERVER_H
+#define WIRE_SERVER_H
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <list>
+
+#include "session-api.h"
+
+// Raw socket front end for the turn-wire protocol (views/APIs/wire-format.h)
+// on TCP or a Unix socket. A gateway keeps a few persistent connections and
+// writes TURN_REQUEST frames; each reply frame (ENTITIES, ERROR or JSON)
+// comes back in request order. Pipelined frames are answered with one
+// write. No HTTP parsing and no JSON on the turn path. There is one thread
+// per connection, because gateways hold a handful of connections.
+class WireServer {
+private:
+    std::shared_ptr<SessionApi> api_;
+    std::string unix_path_;  // Unlinked on stop
+    std::atomic<bool> running_{false};
+
+    // One thread per connection, owned by the accept loop: it joins the
+    // finished ones as it goes and drains the rest before start() returns.
+    // The fd is closed after the join, so it is never reused while listed.
+    struct Connection {
+        int fd;
+        std::thread thread;
+        std::atomic<bool> done{false};
+        explicit Connection(int connection_fd) : fd(connection_fd) {}
+    };
+    std::list<Connection> connections_;  // Accept loop only
+
+    // start() is running (the destructor waits for it to return) and the
+    // listener stop() shuts down to wake accept()
+    std::mutex serving_mutex_;
+    std::condition_variable serving_cv_;
+    bool serving_ = false;
+    int listen_fd_ = -1;
+
+    std::atomic<size_t> frames_{0};
+    std::atomic<size_t> bad_frames_{0};
+
+    bool open_listener(const std::string& address, int& listen_fd);
+    void reap_connections(bool all);
+    void finish_serving();
+    void serve_connection(int fd);
+    ApiResponse handle_request(const WireTurnRequest& request);
+
+public:
+    explicit WireServer(std::shared_ptr<SessionApi> api);
+    ~WireServer();  // Stops, and waits until start() has drained every connection
+
+    // "host:port" or "unix:/path/to.sock"; blocks until stop() and returns
+    // once every connection thread has been joined
+    bool start(const std::string& address);
+    void stop();
+
+    size_t frames_served() const { return frames_.load(); }
+    size_t bad_frames() const { return bad_frames_.load(); }
+};
+
+#endif // WIRE_SERVER_H